@@ -92,90 +92,110 @@ btRSBroadphase::~btRSBroadphase() {
 	}
 }
 
+// Range of cells covered by a static AABB
+struct StaticCellRange {
+	int iMin, jMin, kMin;
+	int iMax, jMax, kMax;
+
+	StaticCellRange(const btRSBroadphase* _this, const btVector3& aabbMin, btVector3 aabbMax) {
+		// Fix dumb massive value aabb bug
+		for (int i = 0; i < 3; i++)
+			aabbMax[i] = btMin(aabbMax[i], _this->maxPos[i]);
+
+		_this->GetCellIndices(aabbMin, iMin, jMin, kMin);
+		_this->GetCellIndices(aabbMax, iMax, jMax, kMax);
+	}
+
+	bool operator==(const StaticCellRange& other) const {
+		return
+			iMin == other.iMin && jMin == other.jMin && kMin == other.kMin &&
+			iMax == other.iMax && jMax == other.jMax && kMax == other.kMax;
+	}
+};
+
 template <bool ADD>
 void _UpdateCellsStatic(btRSBroadphase* _this, btRSBroadphaseProxy* proxy) {
 
-	// Fix dumb massive value aabb bug
-	btVector3 aabbMax = proxy->m_aabbMax;
-	for (int i = 0; i < 3; i++)
-		aabbMax[i] = btMin(aabbMax[i], _this->maxPos[i]);
+	StaticCellRange range = StaticCellRange(_this, proxy->m_aabbMin, proxy->m_aabbMax);
+	int iMin = range.iMin, jMin = range.jMin, kMin = range.kMin;
+	int iMax = range.iMax, jMax = range.jMax, kMax = range.kMax;
 
-	int iMin, jMin, kMin;
-	int iMax, jMax, kMax;
-	_this->GetCellIndices(proxy->m_aabbMin, iMin, jMin, kMin);
-	_this->GetCellIndices(aabbMax, iMax, jMax, kMax);
+	// Every cell touched by the AABB also adds the proxy to its neighbors, so the affected range is one cell bigger
+	int riMin = btMax(iMin - 1, 0), rjMin = btMax(jMin - 1, 0), rkMin = btMax(kMin - 1, 0);
+	int riMax = btMin(iMax + 1, _this->cellsX - 1), rjMax = btMin(jMax + 1, _this->cellsY - 1), rkMax = btMin(kMax + 1, _this->cellsZ - 1);
+
+	if (!ADD) {
+		for (int i = riMin; i <= riMax; i++)
+			for (int j = rjMin; j <= rjMax; j++)
+				for (int k = rkMin; k <= rkMax; k++)
+					_this->GetCell(i, j, k).RemoveStatic(proxy);
+		return;
+	}
 
 	btCollisionObject* colObj = (btCollisionObject*)proxy->m_clientObject;
 
 	// We should check if each cell actually collides with the object
 	bool isTriMesh = colObj && colObj->m_collisionShape->getShapeType() == TRIANGLE_MESH_SHAPE_PROXYTYPE;
 
-	// For checking if an AABB has any containing triangles
-	struct BoolHitTriangleCallback : public btTriangleCallback {
+	int rangeX = riMax - riMin + 1, rangeY = rjMax - rjMin + 1, rangeZ = rkMax - rkMin + 1;
+	auto fnRangeIdx = [&](int i, int j, int k) {
+		return ((i - riMin) * rangeY + (j - rjMin)) * rangeZ + (k - rkMin);
+	};
 
-		bool hit = false;
+	// Mark which cells of the range get the proxy first, so each cell is only visited once when adding
+	std::vector<uint8_t> shouldAdd = std::vector<uint8_t>(rangeX * rangeY * rangeZ, !isTriMesh);
 
-		BoolHitTriangleCallback() {}
-		virtual void processTriangle(btVector3* triangle, int partId, int triangleIndex) {
-			hit = true;
-		}
-	};
-	BoolHitTriangleCallback callbackInst = {};
-
-	int numSkipped = 0;
-	for (int i = iMin; i <= iMax; i++) {
-		for (int j = jMin; j <= jMax; j++) {
-			for (int k = kMin; k <= kMax; k++) {
-				std::vector<btRSBroadphase::Cell*> cells = {};
-				for (int i1 = -1; i1 <= 1; i1++) {
-					for (int j1 = -1; j1 <= 1; j1++) {
-						for (int k1 = -1; k1 <= 1; k1++) {
-							int ci = i + i1;
-							int cj = j + j1;
-							int ck = k + k1;
-							if (ci < 0 || cj < 0 || ck < 0)
-								continue;
-							if (ci >= _this->cellsX || cj >= _this->cellsY || ck >= _this->cellsZ)
-								continue;
-							cells.push_back(&_this->GetCell(ci, cj, ck));
-						}
-					}
-				}
-				
-				if (isTriMesh) {
-					auto triMeshShape = (btTriangleMeshShape*)colObj->m_collisionShape;
+	if (isTriMesh) {
+		// For checking if an AABB has any containing triangles
+		struct BoolHitTriangleCallback : public btTriangleCallback {
+
+			bool hit = false;
+
+			BoolHitTriangleCallback() {}
+			virtual void processTriangle(btVector3* triangle, int partId, int triangleIndex) {
+				hit = true;
+			}
+		};
+		BoolHitTriangleCallback callbackInst = {};
+
+		auto triMeshShape = (btTriangleMeshShape*)colObj->m_collisionShape;
+		for (int i = iMin; i <= iMax; i++) {
+			for (int j = jMin; j <= jMax; j++) {
+				for (int k = kMin; k <= kMax; k++) {
 					btVector3 cellMin = _this->GetCellMinPos(i, j, k);
 					btVector3 cellMax = cellMin + btVector3(_this->cellSize, _this->cellSize, _this->cellSize);
 
 					callbackInst.hit = false;
 					triMeshShape->processAllTriangles(&callbackInst, cellMin, cellMax);
 
-					if (!callbackInst.hit) {
-						numSkipped++;
+					if (!callbackInst.hit)
+						continue; // No tris in this AABB, ignore
 
-						if (ADD) {
-							continue; // No tris in this AABB, ignore
-						} else {
-							// Remove it anyway
-						}
-					}
+					for (int ni = btMax(i - 1, riMin); ni <= btMin(i + 1, riMax); ni++)
+						for (int nj = btMax(j - 1, rjMin); nj <= btMin(j + 1, rjMax); nj++)
+							for (int nk = btMax(k - 1, rkMin); nk <= btMin(k + 1, rkMax); nk++)
+								shouldAdd[fnRangeIdx(ni, nj, nk)] = true;
 				}
+			}
+		}
+	}
 
-				for (auto cell : cells) {
-					if (ADD) {
-						bool alreadyExists = false;
-						for (auto staticHandle : cell->staticHandles) {
-							if (staticHandle == proxy) {
-								alreadyExists = true;
-								break;
-							}
-						}
-						if (!alreadyExists)
-							cell->staticHandles.push_back(proxy);
-					} else {
-						cell->RemoveStatic(proxy);
+	for (int i = riMin; i <= riMax; i++) {
+		for (int j = rjMin; j <= rjMax; j++) {
+			for (int k = rkMin; k <= rkMax; k++) {
+				if (!shouldAdd[fnRangeIdx(i, j, k)])
+					continue;
+
+				auto& cell = _this->GetCell(i, j, k);
+				bool alreadyExists = false;
+				for (auto staticHandle : cell.staticHandles) {
+					if (staticHandle == proxy) {
+						alreadyExists = true;
+						break;
 					}
 				}
+				if (!alreadyExists)
+					cell.staticHandles.push_back(proxy);
 			}
 		}
 	}
@@ -223,7 +243,8 @@ btBroadphaseProxy* btRSBroadphase::createProxy(const btVector3& aabbMin, const b
 	);
 
 	if (isStatic) {
-		_UpdateCellsStatic<true>(this, proxy);
+		if (!skipStaticCells)
+			_UpdateCellsStatic<true>(this, proxy);
 
 	} else {
 		if (aabbMin.distance2(aabbMax) > cellSizeSq)
@@ -236,6 +257,27 @@ btBroadphaseProxy* btRSBroadphase::createProxy(const btVector3& aabbMin, const b
 	return proxy;
 }
 
+void btRSBroadphase::copyStaticCellsFrom(const btRSBroadphase* other) {
+	if (other->minPos != minPos || other->cellSize != cellSize || other->totalCells != totalCells)
+		THROW_ERR("Cannot copy static cells from a broadphase with a different grid");
+
+	for (int i = 0; i < totalCells; i++) {
+		const auto& otherHandles = other->cells[i].staticHandles;
+		auto& handles = cells[i].staticHandles;
+
+		// Proxies are mapped by handle slot, since the lists hold pointers into each broadphase's own handle pool
+		handles.resize(otherHandles.size());
+		for (size_t j = 0; j < otherHandles.size(); j++) {
+			int handleIdx = (int)(otherHandles[j] - other->m_pHandles);
+			btRSBroadphaseProxy* proxy = &m_pHandles[handleIdx];
+			if (handleIdx > m_LastHandleIndex || !proxy->isStatic || !proxy->m_clientObject)
+				THROW_ERR("Cannot copy static cells, static proxies don't match the other broadphase");
+
+			handles[j] = proxy;
+		}
+	}
+}
+
 class RemovingOverlapCallback : public btOverlapCallback
 {
 protected:
@@ -289,12 +331,20 @@ void btRSBroadphase::setAabb(btBroadphaseProxy* proxy, const btVector3& aabbMin,
 	
 	if (sbp->m_aabbMin != aabbMin || sbp->m_aabbMax != aabbMax) {
 		if (sbp->isStatic) {
-			_UpdateCellsStatic<false>(this, sbp);
-
-			sbp->m_aabbMin = aabbMin;
-			sbp->m_aabbMax = aabbMax;
-
-			_UpdateCellsStatic<true>(this, sbp);
+			// Cell membership only depends on which cells the AABB covers,
+			//	so small changes (like the contact threshold added on the first update) don't need a rebuild
+			bool sameCells = StaticCellRange(this, sbp->m_aabbMin, sbp->m_aabbMax) == StaticCellRange(this, aabbMin, aabbMax);
+			if (sameCells) {
+				sbp->m_aabbMin = aabbMin;
+				sbp->m_aabbMax = aabbMax;
+			} else {
+				_UpdateCellsStatic<false>(this, sbp);
+
+				sbp->m_aabbMin = aabbMin;
+				sbp->m_aabbMax = aabbMax;
+
+				_UpdateCellsStatic<true>(this, sbp);
+			}
 		} else {
 
 			int oldIndex = sbp->cellIdx;
@@ -53,14 +53,11 @@ public:
 
 	std::vector<std::pair<btRSBroadphaseProxy*, btRSBroadphaseProxy*>> activePairs;
 
+	// NOTE: Handle lists are not reserved up-front, most cells never hold anything,
+	//	and reserving them made arena creation dominated by thousands of tiny allocations
 	struct Cell {
-		constexpr static int RESERVED_SIZE = 4;
 		std::vector<btRSBroadphaseProxy*> dynHandles;
 		std::vector<btRSBroadphaseProxy*> staticHandles;
-		Cell() {
-			dynHandles.reserve(RESERVED_SIZE);
-			staticHandles.reserve(RESERVED_SIZE);
-		}
 
 		void RemoveDyn(btRSBroadphaseProxy* proxy) {
 			for (int i = 0; i < dynHandles.size(); i++) {
@@ -82,6 +79,13 @@ public:
 	};
 	std::vector<Cell> cells;
 
+	// If true, static proxies aren't added to any cells when created, they should be copied with copyStaticCellsFrom() instead
+	bool skipStaticCells = false;
+
+	// Copy the static handle lists of every cell from another broadphase
+	// The other broadphase must have the same grid, and the same static proxies in the same handle slots
+	void copyStaticCellsFrom(const btRSBroadphase* other);
+
 	Cell& GetCell(int i, int j, int k) {
 		int idx = i * cellsY * cellsZ + j * cellsZ + k;
 		return cells[idx];
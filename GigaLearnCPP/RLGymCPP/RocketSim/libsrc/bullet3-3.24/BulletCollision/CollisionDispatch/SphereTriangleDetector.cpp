@@ -138,9 +138,11 @@ bool SphereTriangleDetector::facecontains(const btVector3& p, const btVector3* v
 
 bool SphereTriangleDetector::collide(const btVector3& sphereCenter, btVector3& point, btVector3& resultNormal, btScalar& depth, btScalar& timeOfImpact, btScalar contactBreakingThreshold)
 {
-	const btVector3* vertices = &m_triangle->getVertexPtr(0);
+	return collideSphereTriangle(sphereCenter, m_sphere->getRadius(), &m_triangle->getVertexPtr(0), point, resultNormal, depth, contactBreakingThreshold);
+}
 
-	btScalar radius = m_sphere->getRadius();
+bool SphereTriangleDetector::collideSphereTriangle(const btVector3& sphereCenter, btScalar radius, const btVector3* vertices, btVector3& point, btVector3& resultNormal, btScalar& depth, btScalar contactBreakingThreshold)
+{
 	btScalar radiusWithThreshold = radius + contactBreakingThreshold;
 
 	btVector3 normal = (vertices[1] - vertices[0]).cross(vertices[2] - vertices[0]);
@@ -32,12 +32,19 @@ struct SphereTriangleDetector : public btDiscreteCollisionDetectorInterface
 
 	bool collide(const btVector3& sphereCenter, btVector3& point, btVector3& resultNormal, btScalar& depth, btScalar& timeOfImpact, btScalar contactBreakingThreshold);
 
+	// Same as collide(), but with the sphere radius and triangle vertices given directly, so no shapes are needed
+	static bool collideSphereTriangle(const btVector3& sphereCenter, btScalar radius, const btVector3* vertices, btVector3& point, btVector3& resultNormal, btScalar& depth, btScalar contactBreakingThreshold);
+
 private:
-	bool pointInTriangle(const btVector3 vertices[], const btVector3& normal, btVector3* p);
-	bool facecontains(const btVector3& p, const btVector3* vertices, btVector3& normal);
+	static bool pointInTriangle(const btVector3 vertices[], const btVector3& normal, btVector3* p);
+	static bool facecontains(const btVector3& p, const btVector3* vertices, btVector3& normal);
 
 	btSphereShape* m_sphere;
 	btTriangleShape* m_triangle;
 	btScalar m_contactBreakingThreshold;
 };
+
+// Closest point to p on the triangle (a, b, c)
+btVector3 closestPointTriangle(btVector3 const& p, btVector3 const& a, btVector3 const& b, btVector3 const& c);
+
 #endif  //BT_SPHERE_TRIANGLE_DETECTOR_H
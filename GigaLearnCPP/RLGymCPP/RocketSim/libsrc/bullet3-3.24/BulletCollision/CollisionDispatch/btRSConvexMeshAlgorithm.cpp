@@ -0,0 +1,483 @@
+#include "btRSConvexMeshAlgorithm.h"
+
+#include "SphereTriangleDetector.h"
+#include "btCollisionObjectWrapper.h"
+#include "btManifoldResult.h"
+#include "../CollisionShapes/btConcaveShape.h"
+#include "../CollisionShapes/btSphereShape.h"
+#include "../CollisionShapes/btBoxShape.h"
+#include "../CollisionShapes/btTriangleShape.h"
+#include "../CollisionShapes/btTriangleCallback.h"
+#include "../../LinearMath/btAabbUtil2.h"
+#include "../../LinearMath/btMinMax.h"
+
+// Closest points between the segments (p1, q1) and (p2, q2)
+// From Real-Time Collision Detection (Ericson), 5.1.9
+static void closestPtSegmentSegment(
+	const btVector3& p1, const btVector3& q1, const btVector3& p2, const btVector3& q2,
+	btVector3& c1, btVector3& c2) {
+
+	btVector3 d1 = q1 - p1;
+	btVector3 d2 = q2 - p2;
+	btVector3 r = p1 - p2;
+	btScalar a = d1.dot(d1);
+	btScalar e = d2.dot(d2);
+	btScalar f = d2.dot(r);
+
+	btScalar s, t;
+	if (a <= SIMD_EPSILON && e <= SIMD_EPSILON) {
+		s = t = 0;
+	} else if (a <= SIMD_EPSILON) {
+		s = 0;
+		t = btClamped(f / e, btScalar(0), btScalar(1));
+	} else {
+		btScalar c = d1.dot(r);
+		if (e <= SIMD_EPSILON) {
+			t = 0;
+			s = btClamped(-c / a, btScalar(0), btScalar(1));
+		} else {
+			btScalar b = d1.dot(d2);
+			btScalar denom = a * e - b * b;
+			s = (denom != 0) ? btClamped((b * f - c * e) / denom, btScalar(0), btScalar(1)) : 0;
+			t = (b * s + f) / e;
+			if (t < 0) {
+				t = 0;
+				s = btClamped(-c / a, btScalar(0), btScalar(1));
+			} else if (t > 1) {
+				t = 1;
+				s = btClamped((b - c) / a, btScalar(0), btScalar(1));
+			}
+		}
+	}
+
+	c1 = p1 + d1 * s;
+	c2 = p2 + d2 * t;
+}
+
+// Point on the box where a coordinate is picked by the direction it faces
+// Axes that are (nearly) perpendicular to the direction use the hint's coordinate instead, so flat contacts land near the hint
+static btVector3 boxFeaturePoint(const btVector3& halfExtents, const btVector3& dir, const btVector3& hint) {
+	constexpr btScalar FLAT_EPSILON = 1e-4f;
+	btVector3 result;
+	for (int i = 0; i < 3; i++) {
+		if (btFabs(dir[i]) < FLAT_EPSILON) {
+			result[i] = btClamped(hint[i], -halfExtents[i], halfExtents[i]);
+		} else {
+			result[i] = dir[i] > 0 ? halfExtents[i] : -halfExtents[i];
+		}
+	}
+	return result;
+}
+
+// Collides a box centered at the origin (aligned to the axes) with a triangle, both without margins
+// On contact, outputs:
+//	normal: Unit normal from the triangle to the box
+//	pointOnTri: Point on the triangle
+//	dist: Distance between the shapes, negative if they are penetrating
+// Cores further than maxDist from each other are ignored
+static bool collideBoxTriangle(
+	const btVector3& halfExtents, const btVector3* tri, btScalar maxDist,
+	btVector3& normal, btVector3& pointOnTri, btScalar& dist) {
+
+	btVector3 edges[3] = { tri[1] - tri[0], tri[2] - tri[1], tri[0] - tri[2] };
+	btVector3 triNormal = edges[0].cross(tri[2] - tri[0]);
+	if (triNormal.length2() < SIMD_EPSILON * SIMD_EPSILON)
+		return false; // Degenerate triangle
+
+	enum { AXIS_TRI_NORMAL, AXIS_BOX_FACE, AXIS_EDGE_EDGE };
+
+	// Separating axis test, tracking the axis of least penetration
+	// An axis is a triangle normal, a box face normal, or a cross product of a box axis and a triangle edge
+	bool separated = false;
+	btScalar bestPen = BT_LARGE_FLOAT;
+	btVector3 bestAxis = btVector3(0, 0, 0);
+	int bestType = -1, bestBoxAxis = -1, bestTriEdge = -1;
+
+	auto fnTestAxis = [&](const btVector3& axis, int type, int boxAxis, int triEdge) -> bool {
+		btScalar lenSq = axis.length2();
+		if (lenSq < SIMD_EPSILON)
+			return true; // Parallel edges, covered by the other axes
+
+		btScalar boxRadius =
+			halfExtents.x() * btFabs(axis.x()) +
+			halfExtents.y() * btFabs(axis.y()) +
+			halfExtents.z() * btFabs(axis.z());
+
+		btScalar
+			p0 = axis.dot(tri[0]),
+			p1 = axis.dot(tri[1]),
+			p2 = axis.dot(tri[2]);
+		btScalar triMin = btMin(p0, btMin(p1, p2));
+		btScalar triMax = btMax(p0, btMax(p1, p2));
+
+		btScalar invLen = 1 / btSqrt(lenSq);
+		btScalar penPos = (triMax + boxRadius) * invLen; // Amount the box needs to move along +axis to separate
+		btScalar penNeg = (boxRadius - triMin) * invLen; // Amount the box needs to move along -axis to separate
+		btScalar pen = btMin(penPos, penNeg);
+
+		if (pen < 0) {
+			separated = true;
+			return -pen <= maxDist;
+		}
+
+		if (pen < bestPen) {
+			bestPen = pen;
+			bestAxis = (penPos < penNeg) ? (axis * invLen) : (axis * -invLen);
+			bestType = type;
+			bestBoxAxis = boxAxis;
+			bestTriEdge = triEdge;
+		}
+		return true;
+	};
+
+	// Cheapest and most likely to separate first
+	if (!fnTestAxis(triNormal, AXIS_TRI_NORMAL, -1, -1))
+		return false;
+
+	for (int i = 0; i < 3; i++) {
+		btVector3 axis = btVector3(0, 0, 0);
+		axis[i] = 1;
+		if (!fnTestAxis(axis, AXIS_BOX_FACE, i, -1))
+			return false;
+	}
+
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			const btVector3& e = edges[j];
+			btVector3 axis;
+			if (i == 0) {
+				axis = btVector3(0, -e.z(), e.y());
+			} else if (i == 1) {
+				axis = btVector3(e.z(), 0, -e.x());
+			} else {
+				axis = btVector3(-e.y(), e.x(), 0);
+			}
+
+			if (!fnTestAxis(axis, AXIS_EDGE_EDGE, i, j))
+				return false;
+		}
+	}
+
+	btVector3 triCenter = (tri[0] + tri[1] + tri[2]) / 3;
+
+	if (separated) {
+		// Find the closest features: box vertex vs triangle, triangle vertex vs box, or box edge vs triangle edge
+		btScalar bestDistSq = BT_LARGE_FLOAT;
+		btVector3 bestOnBox = btVector3(0, 0, 0), bestOnTri = btVector3(0, 0, 0);
+
+		for (int i = 0; i < 8; i++) {
+			btVector3 vert = btVector3(
+				(i & 1) ? halfExtents.x() : -halfExtents.x(),
+				(i & 2) ? halfExtents.y() : -halfExtents.y(),
+				(i & 4) ? halfExtents.z() : -halfExtents.z()
+			);
+
+			btVector3 onTri = closestPointTriangle(vert, tri[0], tri[1], tri[2]);
+			btScalar distSq = vert.distance2(onTri);
+			if (distSq < bestDistSq) {
+				bestDistSq = distSq;
+				bestOnBox = vert;
+				bestOnTri = onTri;
+			}
+		}
+
+		for (int i = 0; i < 3; i++) {
+			btVector3 onBox = btVector3(
+				btClamped(tri[i].x(), -halfExtents.x(), halfExtents.x()),
+				btClamped(tri[i].y(), -halfExtents.y(), halfExtents.y()),
+				btClamped(tri[i].z(), -halfExtents.z(), halfExtents.z())
+			);
+
+			btScalar distSq = onBox.distance2(tri[i]);
+			if (distSq < bestDistSq) {
+				bestDistSq = distSq;
+				bestOnBox = onBox;
+				bestOnTri = tri[i];
+			}
+		}
+
+		for (int axis = 0; axis < 3; axis++) {
+			int axisB = (axis + 1) % 3, axisC = (axis + 2) % 3;
+			for (int i = 0; i < 4; i++) {
+				btVector3 from, to;
+				from[axis] = -halfExtents[axis];
+				to[axis] = halfExtents[axis];
+				from[axisB] = to[axisB] = (i & 1) ? halfExtents[axisB] : -halfExtents[axisB];
+				from[axisC] = to[axisC] = (i & 2) ? halfExtents[axisC] : -halfExtents[axisC];
+
+				for (int j = 0; j < 3; j++) {
+					btVector3 onBox, onTri;
+					closestPtSegmentSegment(from, to, tri[j], tri[(j + 1) % 3], onBox, onTri);
+					btScalar distSq = onBox.distance2(onTri);
+					if (distSq < bestDistSq) {
+						bestDistSq = distSq;
+						bestOnBox = onBox;
+						bestOnTri = onTri;
+					}
+				}
+			}
+		}
+
+		dist = btSqrt(bestDistSq);
+		if (dist > maxDist)
+			return false;
+
+		if (dist > SIMD_EPSILON) {
+			normal = (bestOnBox - bestOnTri) / dist;
+			pointOnTri = bestOnTri;
+			return true;
+		}
+
+		// Just touching, there is no direction between the closest points
+		// The axis of least overlap is as good as any
+		if (bestType == -1)
+			return false;
+		dist = 0;
+		bestPen = 0;
+	} else {
+		dist = -bestPen;
+	}
+
+	normal = bestAxis;
+	if (bestType == AXIS_TRI_NORMAL) {
+		// Deepest point of the box
+		btVector3 onBox = boxFeaturePoint(halfExtents, -normal, triCenter);
+		pointOnTri = onBox + normal * bestPen;
+	} else if (bestType == AXIS_BOX_FACE) {
+		// Deepest vertex of the triangle, or the middle of the deepest edge if it is flat against the box
+		btScalar depths[3];
+		btScalar maxDepth = -BT_LARGE_FLOAT;
+		for (int i = 0; i < 3; i++) {
+			depths[i] = tri[i].dot(normal);
+			maxDepth = btMax(maxDepth, depths[i]);
+		}
+
+		btVector3 sum = btVector3(0, 0, 0);
+		int count = 0;
+		for (int i = 0; i < 3; i++) {
+			if (depths[i] >= maxDepth - 1e-4f) {
+				sum += tri[i];
+				count++;
+			}
+		}
+		pointOnTri = sum / count;
+	} else {
+		// Closest points of the box edge and the triangle edge
+		btVector3 edgeMid = boxFeaturePoint(halfExtents, -normal, triCenter);
+		btVector3 from = edgeMid, to = edgeMid;
+		from[bestBoxAxis] = -halfExtents[bestBoxAxis];
+		to[bestBoxAxis] = halfExtents[bestBoxAxis];
+
+		btVector3 onBox;
+		closestPtSegmentSegment(from, to, tri[bestTriEdge], tri[(bestTriEdge + 1) % 3], onBox, pointOnTri);
+	}
+
+	return true;
+}
+
+struct btRSMeshTriangleCallback : public btTriangleCallback {
+	const btCollisionObjectWrapper* m_meshWrap;
+	btManifoldResult* m_resultOut;
+	btScalar m_triMargin;
+	btScalar m_contactThreshold;
+	btVector3 m_aabbMin, m_aabbMax; // Convex AABB in mesh space
+
+	btRSMeshTriangleCallback(const btCollisionObjectWrapper* meshWrap, btManifoldResult* resultOut, btScalar triMargin, btScalar contactThreshold)
+		: m_meshWrap(meshWrap), m_resultOut(resultOut), m_triMargin(triMargin), m_contactThreshold(contactThreshold) {
+	}
+
+	// Adds a contact against one triangle of the mesh, in world space
+	// The mesh is temporarily wrapped as a triangle shape, just like btConvexTriangleCallback does,
+	//	so contact callbacks (e.g. btAdjustInternalEdgeContacts()) still see which triangle was hit
+	void addTriangleContact(const btVector3* triangle, int partId, int triangleIndex, const btVector3& normalOnTri, const btVector3& pointOnTri, btScalar depth) {
+		btTriangleShape tm(triangle[0], triangle[1], triangle[2]);
+		tm.setMargin(m_triMargin);
+
+		btCollisionObjectWrapper triObWrap(m_meshWrap, &tm, m_meshWrap->getCollisionObject(), m_meshWrap->getWorldTransform(), partId, triangleIndex);
+
+		const btCollisionObjectWrapper* tmpWrap;
+		bool meshIsBody0 = m_resultOut->getBody0Internal() == m_meshWrap->getCollisionObject();
+		if (meshIsBody0) {
+			tmpWrap = m_resultOut->getBody0Wrap();
+			m_resultOut->setBody0Wrap(&triObWrap);
+			m_resultOut->setShapeIdentifiersA(partId, triangleIndex);
+		} else {
+			tmpWrap = m_resultOut->getBody1Wrap();
+			m_resultOut->setBody1Wrap(&triObWrap);
+			m_resultOut->setShapeIdentifiersB(partId, triangleIndex);
+		}
+
+		m_resultOut->addContactPoint(normalOnTri, pointOnTri, depth);
+
+		if (meshIsBody0) {
+			m_resultOut->setBody0Wrap(tmpWrap);
+		} else {
+			m_resultOut->setBody1Wrap(tmpWrap);
+		}
+	}
+};
+
+struct btRSSphereTriangleCallback : public btRSMeshTriangleCallback {
+	const btCollisionObjectWrapper* m_sphereWrap;
+	btVector3 m_sphereCenter; // In mesh space
+	btScalar m_radius;
+
+	using btRSMeshTriangleCallback::btRSMeshTriangleCallback;
+
+	// Same early-out as btConvexTriangleCallback, for triangles the sphere is fully on one side of
+	// Kept identical (down to the float math) so exactly the same triangles produce contacts
+	// It can only discard contacts, so it is only checked once the cheaper sphere test finds one
+	bool isSeparatedFromTriangle(const btVector3* triangle) {
+		const btTransform& meshTransform = m_meshWrap->getWorldTransform();
+		const btTransform& sphereTransform = m_sphereWrap->getWorldTransform();
+		const btConvexShape* sphere = static_cast<const btConvexShape*>(m_sphereWrap->getCollisionShape());
+
+		const btVector3 v0 = meshTransform * triangle[0];
+		const btVector3 v1 = meshTransform * triangle[1];
+		const btVector3 v2 = meshTransform * triangle[2];
+
+		btVector3 triNormalWorld = (v1 - v0).cross(v2 - v0);
+		triNormalWorld.normalize();
+
+		for (int side = 0; side < 2; side++) {
+			btVector3 localPt = sphere->localGetSupportingVertex(sphereTransform.getBasis().inverse() * triNormalWorld);
+			btVector3 worldPt = sphereTransform * localPt;
+			btScalar dist = triNormalWorld.dot(v0) - triNormalWorld.dot(worldPt);
+			if (dist > m_contactThreshold)
+				return true;
+
+			triNormalWorld *= -1;
+		}
+
+		return false;
+	}
+
+	virtual void processTriangle(btVector3* triangle, int partId, int triangleIndex) {
+		if (!TestTriangleAgainstAabb2(triangle, m_aabbMin, m_aabbMax))
+			return;
+
+		btVector3 point, normal;
+		btScalar depth;
+		if (SphereTriangleDetector::collideSphereTriangle(m_sphereCenter, m_radius, triangle, point, normal, depth, m_contactThreshold)) {
+			if (isSeparatedFromTriangle(triangle))
+				return;
+
+			const btTransform& meshTransform = m_meshWrap->getWorldTransform();
+			addTriangleContact(triangle, partId, triangleIndex, meshTransform.getBasis() * normal, meshTransform * point, depth);
+		}
+	}
+};
+
+struct btRSBoxTriangleCallback : public btRSMeshTriangleCallback {
+	btTransform m_boxTransform;
+	btTransform m_meshToBox;
+	btVector3 m_halfExtents; // Without margin
+	btScalar m_boxMargin;
+
+	using btRSMeshTriangleCallback::btRSMeshTriangleCallback;
+
+	virtual void processTriangle(btVector3* triangle, int partId, int triangleIndex) {
+		if (!TestTriangleAgainstAabb2(triangle, m_aabbMin, m_aabbMax))
+			return;
+
+		btVector3 localTri[3] = {
+			m_meshToBox * triangle[0],
+			m_meshToBox * triangle[1],
+			m_meshToBox * triangle[2]
+		};
+
+		btScalar rounding = m_boxMargin + m_triMargin;
+
+		btVector3 normal, pointOnTri;
+		btScalar coreDist;
+		if (!collideBoxTriangle(m_halfExtents, localTri, rounding + m_contactThreshold, normal, pointOnTri, coreDist))
+			return;
+
+		btScalar depth = coreDist - rounding;
+		if (depth > m_contactThreshold)
+			return;
+
+		pointOnTri += normal * m_triMargin;
+
+		btVector3 worldNormal = m_boxTransform.getBasis() * normal;
+		btVector3 worldPoint = m_boxTransform * pointOnTri;
+
+		// Like btGjkPairDetector's m_fixContactNormalDirection, make sure the normal faces from the center of the triangle's AABB to the box
+		const btTransform& meshTransform = m_meshWrap->getWorldTransform();
+		btVector3 worldTri[3] = { meshTransform * triangle[0], meshTransform * triangle[1], meshTransform * triangle[2] };
+		btVector3 triAabbMin = worldTri[0], triAabbMax = worldTri[0];
+		for (int i = 1; i < 3; i++) {
+			triAabbMin.setMin(worldTri[i]);
+			triAabbMax.setMax(worldTri[i]);
+		}
+		btVector3 triAabbCenter = (triAabbMin + triAabbMax) * 0.5f;
+		if ((m_boxTransform.getOrigin() - triAabbCenter).dot(worldNormal) < 0)
+			worldNormal = -worldNormal;
+
+		addTriangleContact(triangle, partId, triangleIndex, worldNormal, worldPoint, depth);
+	}
+};
+
+btRSConvexMeshAlgorithm::btRSConvexMeshAlgorithm(const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, bool isSwapped)
+	: btActivatingCollisionAlgorithm(ci, body0Wrap, body1Wrap),
+	m_isSwapped(isSwapped) {
+
+	const btCollisionObjectWrapper* convexWrap = isSwapped ? body1Wrap : body0Wrap;
+	const btCollisionObjectWrapper* meshWrap = isSwapped ? body0Wrap : body1Wrap;
+	m_manifoldPtr = m_dispatcher->getNewManifold(convexWrap->getCollisionObject(), meshWrap->getCollisionObject());
+}
+
+btRSConvexMeshAlgorithm::~btRSConvexMeshAlgorithm() {
+	m_dispatcher->clearManifold(m_manifoldPtr);
+	m_dispatcher->releaseManifold(m_manifoldPtr);
+}
+
+void btRSConvexMeshAlgorithm::processCollision(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, const btDispatcherInfo& /*dispatchInfo*/, btManifoldResult* resultOut) {
+	const btCollisionObjectWrapper* convexWrap = m_isSwapped ? body1Wrap : body0Wrap;
+	const btCollisionObjectWrapper* meshWrap = m_isSwapped ? body0Wrap : body1Wrap;
+
+	const btCollisionShape* convexShape = convexWrap->getCollisionShape();
+	const btConcaveShape* meshShape = static_cast<const btConcaveShape*>(meshWrap->getCollisionShape());
+	btAssert(isSupportedConvex(convexShape->getShapeType()));
+	btAssert(meshShape->isConcave());
+
+	resultOut->setPersistentManifold(m_manifoldPtr);
+	m_manifoldPtr->setBodies(convexWrap->getCollisionObject(), meshWrap->getCollisionObject());
+
+	btScalar triMargin = meshShape->getMargin();
+	btScalar contactThreshold = m_manifoldPtr->getContactBreakingThreshold() + resultOut->m_closestPointDistanceThreshold;
+
+	const btTransform& convexTransform = convexWrap->getWorldTransform();
+	const btTransform& meshTransform = meshWrap->getWorldTransform();
+	btTransform convexInMesh = meshTransform.inverseTimes(convexTransform);
+
+	// Same triangle query region as btConvexTriangleCallback
+	btVector3 aabbMin, aabbMax;
+	convexShape->getAabb(convexInMesh, aabbMin, aabbMax);
+	btScalar extraMargin = triMargin + resultOut->m_closestPointDistanceThreshold;
+	btVector3 extra = btVector3(extraMargin, extraMargin, extraMargin);
+	aabbMin -= extra;
+	aabbMax += extra;
+
+	if (convexShape->getShapeType() == SPHERE_SHAPE_PROXYTYPE) {
+		btRSSphereTriangleCallback callback(meshWrap, resultOut, triMargin, contactThreshold);
+		callback.m_aabbMin = aabbMin;
+		callback.m_aabbMax = aabbMax;
+		callback.m_sphereWrap = convexWrap;
+		callback.m_sphereCenter = convexInMesh.getOrigin();
+		callback.m_radius = static_cast<const btSphereShape*>(convexShape)->getRadius();
+		meshShape->processAllTriangles(&callback, aabbMin, aabbMax);
+	} else {
+		const btBoxShape* boxShape = static_cast<const btBoxShape*>(convexShape);
+		btRSBoxTriangleCallback callback(meshWrap, resultOut, triMargin, contactThreshold);
+		callback.m_aabbMin = aabbMin;
+		callback.m_aabbMax = aabbMax;
+		callback.m_boxTransform = convexTransform;
+		callback.m_meshToBox = convexTransform.inverseTimes(meshTransform);
+		callback.m_halfExtents = boxShape->getHalfExtentsWithoutMargin();
+		callback.m_boxMargin = boxShape->getMargin();
+		meshShape->processAllTriangles(&callback, aabbMin, aabbMax);
+	}
+
+	resultOut->refreshContactPoints();
+}
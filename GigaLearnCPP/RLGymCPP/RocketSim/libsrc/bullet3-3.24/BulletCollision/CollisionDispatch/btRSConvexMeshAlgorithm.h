@@ -0,0 +1,50 @@
+#pragma once
+
+#include "btActivatingCollisionAlgorithm.h"
+#include "../CollisionDispatch/btCollisionDispatcher.h"
+#include "../NarrowPhaseCollision/btPersistentManifold.h"
+#include "../BroadphaseCollision/btBroadphaseProxy.h"
+#include "btCollisionCreateFunc.h"
+
+// Custom collision algorithm for RocketSim
+// Collides a sphere (the ball) or a box (a car hitbox) with a concave triangle mesh (the arena)
+// Replaces btConvexConcaveCollisionAlgorithm for those shapes, which creates a generic sub-algorithm (GJK/EPA for boxes) per triangle
+// Spheres use the same closed-form test as btSphereTriangleCollisionAlgorithm, so results are identical
+// Boxes use a closed-form separating axis/closest feature test, which matches GJK/EPA within tolerance
+ATTRIBUTE_ALIGNED16(class)
+btRSConvexMeshAlgorithm : public btActivatingCollisionAlgorithm
+{
+	btPersistentManifold* m_manifoldPtr;
+	bool m_isSwapped;
+
+public:
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	btRSConvexMeshAlgorithm(const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, bool isSwapped);
+
+	virtual ~btRSConvexMeshAlgorithm();
+
+	virtual void processCollision(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut);
+
+	virtual btScalar calculateTimeOfImpact(btCollisionObject* /*body0*/, btCollisionObject* /*body1*/, const btDispatcherInfo& /*dispatchInfo*/, btManifoldResult* /*resultOut*/) {
+		return btScalar(1.);
+	}
+
+	virtual void getAllContactManifolds(btManifoldArray& manifoldArray) {
+		if (m_manifoldPtr)
+			manifoldArray.push_back(m_manifoldPtr);
+	}
+
+	// Returns true if this algorithm can handle this convex shape type
+	static bool isSupportedConvex(int shapeType) {
+		return shapeType == SPHERE_SHAPE_PROXYTYPE || shapeType == BOX_SHAPE_PROXYTYPE;
+	}
+
+	struct CreateFunc : public btCollisionAlgorithmCreateFunc
+	{
+		virtual btCollisionAlgorithm* CreateCollisionAlgorithm(btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap) {
+			void* mem = ci.m_dispatcher1->allocateCollisionAlgorithm(sizeof(btRSConvexMeshAlgorithm));
+			return new (mem) btRSConvexMeshAlgorithm(ci, body0Wrap, body1Wrap, m_swapped);
+		}
+	};
+};
@@ -10,6 +10,7 @@
 #include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionDispatch/btInternalEdgeUtility.h"
 #include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btBoxShape.h"
 #include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionShapes/btSphereShape.h"
+#include "../../../libsrc/bullet3-3.24/LinearMath/btPoolAllocator.h"
 
 RS_NS_START
 
@@ -47,12 +48,19 @@ RSAPI void Arena::SetMutatorConfig(const MutatorConfig& mutatorConfig) {
 }
 
 Car* Arena::AddCar(Team team, const CarConfig& config) {
+	return _AddCarWithID(team, config, 0);
+}
+
+Car* Arena::_AddCarWithID(Team team, const CarConfig& config, uint32_t id) {
 	Car* car = Car::_AllocateCar();
 	
 	car->config = config;
 	car->team = team;
 	
-	_AddCarFromPtr(car);
+	if (!_AddCarFromPtr(car, id)) {
+		delete car;
+		RS_ERR_CLOSE("Arena::AddCar(): Car ID " << id << " is already in use");
+	}
 
 	car->_BulletSetup(gameMode, &_bulletWorld, _mutatorConfig);
 	car->Respawn(gameMode, -1, _mutatorConfig.carSpawnBoostAmount);
@@ -60,15 +68,20 @@ Car* Arena::AddCar(Team team, const CarConfig& config) {
 	return car;
 }
 
-bool Arena::_AddCarFromPtr(Car* car) {
+bool Arena::_AddCarFromPtr(Car* car, uint32_t id) {
 
-	car->id = ++_lastCarID;
+	if (id == 0)
+		id = _lastCarID + 1;
 
-	if (_carIDMap.find(car->id) == _carIDMap.end()) {
-		assert(!_cars.count(car));
+	if (_carIDMap.find(id) == _carIDMap.end()) {
+		assert(std::find(_cars.begin(), _cars.end(), car) == _cars.end());
 		
+		// Generated IDs always come after every ID used so far
+		car->id = id;
+		_lastCarID = RS_MAX(_lastCarID, id);
+
 		_carIDMap[car->id] = car;
-		_cars.insert(car);
+		_cars.push_back(car);
 		return true;
 
 	} else {
@@ -82,7 +95,7 @@ bool Arena::RemoveCar(uint32_t id) {
 	if (itr != _carIDMap.end()) {
 		Car* car = itr->second;
 		_carIDMap.erase(itr);
-		_cars.erase(car);
+		_cars.erase(std::find(_cars.begin(), _cars.end(), car));
 		_bulletWorld.removeCollisionObject(&car->_rigidBody);
 		if (ownsCars)
 			delete car;
@@ -426,7 +439,7 @@ void Arena::_BtCallback_OnCarWorldCollision(Car* car, btCollisionObject* world,
 	manifoldPoint.m_combinedRestitution = _mutatorConfig.carWorldRestitution;
 }
 
-Arena::Arena(GameMode gameMode, const ArenaConfig& config, float tickRate) : _mutatorConfig(gameMode), _config(config), _suspColGrid(gameMode) {
+Arena::Arena(GameMode gameMode, const ArenaConfig& config, float tickRate, const Arena* staticSource) : _mutatorConfig(gameMode), _config(config), _suspColGrid(gameMode) {
 
 	// Tickrate must be from 15 to 120tps
 	assert(tickRate >= 15 && tickRate <= 120);
@@ -452,6 +465,22 @@ Arena::Arena(GameMode gameMode, const ArenaConfig& config, float tickRate) : _mu
 		_bulletWorldParams.collisionConfig.setup(collisionConfigConstructionInfo);
 
 		_bulletWorldParams.collisionDispatcher.setup(&_bulletWorldParams.collisionConfig);
+
+		{ // Register custom narrowphase algorithms
+			auto& dispatcher = _bulletWorldParams.collisionDispatcher;
+			_bulletWorldParams.swappedConvexMeshCreateFunc.m_swapped = true;
+
+			std::vector<int> customShapeTypes = {};
+			if (_config.useCustomBallNarrowphase)
+				customShapeTypes.push_back(SPHERE_SHAPE_PROXYTYPE);
+			if (_config.useCustomCarNarrowphase)
+				customShapeTypes.push_back(BOX_SHAPE_PROXYTYPE);
+
+			for (int shapeType : customShapeTypes) {
+				dispatcher.registerCollisionCreateFunc(shapeType, TRIANGLE_MESH_SHAPE_PROXYTYPE, &_bulletWorldParams.convexMeshCreateFunc);
+				dispatcher.registerCollisionCreateFunc(TRIANGLE_MESH_SHAPE_PROXYTYPE, shapeType, &_bulletWorldParams.swappedConvexMeshCreateFunc);
+			}
+		}
 		_bulletWorldParams.constraintSolver = btSequentialImpulseConstraintSolver();
 
 		_bulletWorldParams.overlappingPairCache = new btHashedOverlappingPairCache();
@@ -491,7 +520,21 @@ Arena::Arena(GameMode gameMode, const ArenaConfig& config, float tickRate) : _mu
 	bool loadArenaStuff = gameMode != GameMode::THE_VOID;
 
 	if (loadArenaStuff) {
-		_SetupArenaCollisionShapes();
+		// Static proxies are created in the same order (and handle slots) as in staticSource, so its cells can be copied
+		// Only the custom broadphase has cells to copy
+		btRSBroadphase* staticCellSource = NULL;
+		if (staticSource && _config.useCustomBroadphase)
+			staticCellSource = (btRSBroadphase*)staticSource->_bulletWorldParams.broadphase;
+
+		if (staticCellSource) {
+			auto broadphase = (btRSBroadphase*)_bulletWorldParams.broadphase;
+			broadphase->skipStaticCells = true;
+			_SetupArenaCollisionShapes();
+			broadphase->skipStaticCells = false;
+			broadphase->copyStaticCellsFrom(staticCellSource);
+		} else {
+			_SetupArenaCollisionShapes();
+		}
 
 #ifndef RS_NO_SUSPCOLGRID
 		_suspColGrid = RocketSim::GetDefaultSuspColGrid(gameMode, memWeightMode == ArenaMemWeightMode::LIGHT);
@@ -569,6 +612,10 @@ Arena* Arena::Create(GameMode gameMode, const ArenaConfig& arenaConfig, float ti
 	return new Arena(gameMode, arenaConfig, tickRate);
 }
 
+Arena* Arena::CreateLike(const Arena* other) {
+	return new Arena(other->gameMode, other->_config, other->GetTickRate(), other);
+}
+
 void Arena::Serialize(DataStreamOut& out) const {
 	out.WriteMultiple(gameMode, tickTime, tickCount, _lastCarID);
 
@@ -628,15 +675,10 @@ Arena* Arena::DeserializeNew(DataStreamIn& in) {
 				RS_ERR_CLOSE(ERROR_PREFIX << "Failed to load, got repeated car ID of " << id);
 #endif
 
-			Car* newCar = newArena->DeserializeNewCar(in, team);
-
-			// Force ID
-			newArena->_carIDMap.erase(newCar->id);
-			newArena->_carIDMap[id] = newCar;
-			newCar->id = id;
+			newArena->DeserializeNewCar(in, team, id);
 		}
 
-		newArena->_lastCarID = lastCarID;
+		newArena->_lastCarID = RS_MAX(newArena->_lastCarID, lastCarID);
 	}
 
 	// Deserialize boost pads
@@ -682,10 +724,9 @@ Arena* Arena::Clone(bool copyCallbacks) {
 	newArena->ball->_velocityImpulseCache = this->ball->_velocityImpulseCache;
 
 	for (Car* car : this->_cars) {
-		Car* newCar = newArena->AddCar(car->team, car->config);
+		Car* newCar = newArena->_AddCarWithID(car->team, car->config, car->id);
 		
 		newCar->SetState(car->GetState());
-		newCar->id = car->id;
 		newCar->controls = car->controls;
 		newCar->_velocityImpulseCache = car->_velocityImpulseCache;
 	}
@@ -695,17 +736,106 @@ Arena* Arena::Clone(bool copyCallbacks) {
 		newArena->_boostPads[i]->SetState(this->_boostPads[i]->GetState());
 
 	newArena->tickCount = this->tickCount;
-	newArena->_lastCarID = this->_lastCarID;
+	newArena->_lastCarID = RS_MAX(newArena->_lastCarID, this->_lastCarID);
 
 	return newArena;
 }
 
-Car* Arena::DeserializeNewCar(DataStreamIn& in, Team team) {
+void Arena::CopyStateFrom(Arena* other, bool copyCallbacks) {
+	if (other->gameMode != this->gameMode || other->tickTime != this->tickTime)
+		RS_ERR_CLOSE("Arena::CopyStateFrom(): Arenas must have the same game mode and tick rate");
+
+	if (copyCallbacks) {
+		this->_goalScoreCallback = other->_goalScoreCallback;
+		this->_carBumpCallback = other->_carBumpCallback;
+	} else {
+		this->_goalScoreCallback = {};
+		this->_carBumpCallback = {};
+	}
+
+	bool sameCars = (this->_cars.size() == other->_cars.size());
+	for (size_t i = 0; i < this->_cars.size() && sameCars; i++) {
+		Car* car = this->_cars[i];
+		Car* otherCar = other->_cars[i];
+		sameCars =
+			car->id == otherCar->id && car->team == otherCar->team &&
+			memcmp(&car->config, &otherCar->config, sizeof(CarConfig)) == 0;
+	}
+
+	if (!sameCars) {
+		while (!_cars.empty())
+			RemoveCar(_cars.back());
+		
+		for (Car* otherCar : other->_cars)
+			_AddCarWithID(otherCar->team, otherCar->config, otherCar->id);
+	}
+
+	{
+		// Re-add the dynamic bodies at their spawn transforms and in their original order,
+		//	so that broadphase proxies and contacts start out exactly like in a fresh arena
+		// Otherwise, results would depend on what this arena simulated before
+		// Removing in reverse order gives each body its old proxy back
+		std::vector<btRigidBody*> bodies = { &ball->_rigidBody };
+		std::vector<btTransform> spawnTransforms = { btTransform(btMatrix3x3::getIdentity(), btVector3(0, 0, _mutatorConfig.ballRadius * UU_TO_BT)) };
+		for (Car* car : _cars) {
+			bodies.push_back(&car->_rigidBody);
+			spawnTransforms.push_back(btTransform::getIdentity());
+		}
+
+		std::vector<std::pair<int, int>> filters(bodies.size());
+		for (int i = (int)bodies.size() - 1; i >= 0; i--) {
+			btBroadphaseProxy* proxy = bodies[i]->getBroadphaseHandle();
+			filters[i] = { proxy->m_collisionFilterGroup, proxy->m_collisionFilterMask };
+			_bulletWorld.removeRigidBody(bodies[i]);
+		}
+
+		for (size_t i = 0; i < bodies.size(); i++) {
+			bodies[i]->setWorldTransform(spawnTransforms[i]);
+			bodies[i]->setInterpolationWorldTransform(spawnTransforms[i]);
+			bodies[i]->setInterpolationLinearVelocity(btVector3(0, 0, 0));
+			bodies[i]->setInterpolationAngularVelocity(btVector3(0, 0, 0));
+			_bulletWorld.addRigidBody(bodies[i], filters[i].first, filters[i].second);
+		}
+	}
+
+	this->ball->SetState(other->ball->GetState());
+	this->ball->_velocityImpulseCache = other->ball->_velocityImpulseCache;
+
+	for (size_t i = 0; i < _cars.size(); i++) {
+		Car* car = _cars[i];
+		Car* otherCar = other->_cars[i];
+
+		car->SetState(otherCar->GetState());
+		car->controls = otherCar->controls;
+		car->_velocityImpulseCache = otherCar->_velocityImpulseCache;
+
+		// Wheels keep state between ticks (suspension, steering, friction), copy it so nothing is left over from this car's past
+		car->_bulletVehicle.m_wheelInfo = otherCar->_bulletVehicle.m_wheelInfo;
+		for (int j = 0; j < car->_bulletVehicle.m_wheelInfo.size(); j++)
+			car->_bulletVehicle.m_wheelInfo[j].m_raycastInfo.m_groundObject = NULL; // Points into the other arena, re-done by the next raycast
+	}
+
+	assert(this->_boostPads.size() == other->_boostPads.size());
+	for (size_t i = 0; i < this->_boostPads.size(); i++)
+		this->_boostPads[i]->SetState(other->_boostPads[i]->GetState());
+
+	this->tickCount = other->tickCount;
+	this->_lastCarID = RS_MAX(this->_lastCarID, other->_lastCarID);
+
+	// The solver's time step is only set when stepping, and the wheel pushback uses it before the next step does
+	// Without this, the first tick depends on whether this arena was stepped before (and at what rate)
+	this->_bulletWorld.getSolverInfo().m_timeStep = other->_bulletWorld.getSolverInfo().m_timeStep;
+}
+
+Car* Arena::DeserializeNewCar(DataStreamIn& in, Team team, uint32_t id) {
 	Car* car = Car::_AllocateCar();
 	car->_Deserialize(in);
 	car->team = team;
 
-	_AddCarFromPtr(car);
+	if (!_AddCarFromPtr(car, id)) {
+		delete car;
+		RS_ERR_CLOSE("Arena::DeserializeNewCar(): Car ID " << id << " is already in use");
+	}
 
 	car->_BulletSetup(gameMode, &_bulletWorld, _mutatorConfig);
 	car->SetState(car->_internalState);
@@ -974,6 +1104,68 @@ RSAPI bool Arena::IsBallScored() const {
 	}
 }
 
+size_t Arena::GetMemoryUsage() const {
+	size_t total = sizeof(Arena);
+
+	{ // Bullet pools, sized by memory weight mode
+		auto& collisionConfig = const_cast<btDefaultCollisionConfiguration&>(_bulletWorldParams.collisionConfig);
+		btPoolAllocator* pools[] = { collisionConfig.getPersistentManifoldPool(), collisionConfig.getCollisionAlgorithmPool() };
+		for (btPoolAllocator* pool : pools)
+			total += (size_t)pool->getElementSize() * pool->getMaxCount();
+
+		// Manifolds that didn't fit in the pool are allocated individually
+		int numOverflowManifolds = _bulletWorldParams.collisionDispatcher.getNumManifolds() - pools[0]->getUsedCount();
+		if (numOverflowManifolds > 0)
+			total += numOverflowManifolds * sizeof(btPersistentManifold);
+		total += _bulletWorldParams.collisionDispatcher.getNumManifolds() * sizeof(btPersistentManifold*);
+	}
+
+	{ // Broadphase
+		if (_config.useCustomBroadphase) {
+			auto broadphase = (const btRSBroadphase*)_bulletWorldParams.broadphase;
+			total += sizeof(btRSBroadphase);
+			total += broadphase->m_maxHandles * sizeof(btRSBroadphaseProxy);
+			total += broadphase->activePairs.capacity() * sizeof(broadphase->activePairs[0]);
+			total += broadphase->cells.capacity() * sizeof(btRSBroadphase::Cell);
+			for (auto& cell : broadphase->cells)
+				total += (cell.dynHandles.capacity() + cell.staticHandles.capacity()) * sizeof(btRSBroadphaseProxy*);
+		} else {
+			// Tree nodes aren't exposed, approximate with one leaf and one branch per collision object
+			total += sizeof(btDbvtBroadphase) + _bulletWorld.getNumCollisionObjects() * 2 * sizeof(btDbvtNode);
+		}
+
+		// Hashed pair cache keeps a hash table and next-list the size of the pair array
+		auto& pairArray = _bulletWorldParams.overlappingPairCache->getOverlappingPairArray();
+		total += sizeof(btHashedOverlappingPairCache) + pairArray.capacity() * (sizeof(btBroadphasePair) + sizeof(int) * 2);
+	}
+
+	// Static world collision
+	total += _worldCollisionRBAmount * sizeof(btRigidBody);
+	total += (_worldCollisionRBAmount - (gameMode == GameMode::HOOPS ? 6 : 4)) * sizeof(btBvhTriangleMeshShape);
+	total += (gameMode == GameMode::HOOPS ? 6 : 4) * sizeof(btStaticPlaneShape);
+	total += _bulletWorld.getCollisionObjectArray().capacity() * sizeof(btCollisionObject*);
+
+	total += _suspColGrid.cellData.capacity() * sizeof(SuspensionCollisionGrid::Cell);
+	total += _suspColGrid.dynamicCellRanges.capacity() * sizeof(SuspensionCollisionGrid::CellRange);
+
+	for (Car* car : _cars) {
+		auto& vehicle = car->_bulletVehicle;
+		total += sizeof(Car);
+		total += vehicle.m_wheelInfo.capacity() * sizeof(btWheelInfoRL);
+		total += (vehicle.m_forwardWS.capacity() + vehicle.m_axle.capacity()) * sizeof(btVector3);
+		total += (vehicle.m_forwardImpulse.capacity() + vehicle.m_sideImpulse.capacity()) * sizeof(float);
+	}
+	total += _cars.capacity() * sizeof(Car*);
+	total += _carIDMap.size() * (sizeof(std::pair<uint32_t, Car*>) + sizeof(void*) * 2);
+
+	if (ball)
+		total += sizeof(Ball);
+
+	total += _boostPads.size() * sizeof(BoostPad) + _boostPads.capacity() * sizeof(BoostPad*);
+
+	return total;
+}
+
 Arena::~Arena() {
 
 	// Remove all from bullet world constraints
@@ -18,6 +18,7 @@
 #include "../../../libsrc/bullet3-3.24/BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h"
 #include "../../../libsrc/bullet3-3.24/BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h"
 #include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h"
+#include "../../../libsrc/bullet3-3.24/BulletCollision/CollisionDispatch/btRSConvexMeshAlgorithm.h"
 
 RS_NS_START
 
@@ -32,7 +33,9 @@ public:
 	GameMode gameMode;
 
 	uint32_t _lastCarID = 0;
-	std::unordered_set<Car*> _cars;
+	// In the order they were added, so the car order is the same every run
+	// NOTE: This used to be an unordered_set, use GetCar() or _carIDMap to look up cars
+	std::vector<Car*> _cars;
 	bool ownsCars = true; // If true, deleting this arena instance deletes all cars
 
 	std::unordered_map<uint32_t, Car*> _carIDMap;
@@ -63,13 +66,17 @@ public:
 	// Total ticks this arena instance has been simulated for, never resets
 	uint64_t tickCount = 0;
 
-	const std::unordered_set<Car*>& GetCars() { return _cars; }
+	const std::vector<Car*>& GetCars() { return _cars; }
 	const std::vector<BoostPad*>& GetBoostPads() { return _boostPads; }
 
-	// Returns true if added, false if car was already added
-	bool _AddCarFromPtr(Car* car);
+	// Returns true if added, false if the car ID is already in use
+	// If id is 0, the car gets the next unused ID
+	bool _AddCarFromPtr(Car* car, uint32_t id = 0);
 	RSAPI Car* AddCar(Team team, const CarConfig& config = CAR_CONFIG_OCTANE);
 
+	// Same as AddCar(), but with a specific ID (for copying cars from another arena)
+	Car* _AddCarWithID(Team team, const CarConfig& config, uint32_t id);
+
 	// Returns false if the car ID was not found in the cars list
 	RSAPI bool RemoveCar(uint32_t id);
 
@@ -88,6 +95,7 @@ public:
 		btOverlappingPairCache* overlappingPairCache;
 		btBroadphaseInterface* broadphase;
 		btSequentialImpulseConstraintSolver constraintSolver;
+		btRSConvexMeshAlgorithm::CreateFunc convexMeshCreateFunc, swappedConvexMeshCreateFunc;
 	} _bulletWorldParams;
 
 	btRigidBody* _worldCollisionRBs = NULL;
@@ -109,6 +117,11 @@ public:
 
 	// NOTE: Arena should be destroyed after use
 	RSAPI static Arena* Create(GameMode gameMode, const ArenaConfig& arenaConfig = {}, float tickRate = 120);
+
+	// Create an empty arena with the same game mode, arena config, and tick rate as another arena
+	// The static broadphase cells are copied from the other arena instead of being rebuilt from the collision meshes
+	// NOTE: No dynamic state is copied, use CopyStateFrom() for that (or see ArenaClonePool)
+	RSAPI static Arena* CreateLike(const Arena* other);
 	
 	// Serialize entire arena state including cars, ball, and boostpads
 	RSAPI void Serialize(DataStreamOut& out) const;
@@ -125,8 +138,14 @@ public:
 	// Get a deep copy of the arena
 	RSAPI Arena* Clone(bool copyCallbacks);
 
-	// NOTE: Car ID will not be restored
-	RSAPI Car* DeserializeNewCar(DataStreamIn& in, Team team);
+	// Copy all dynamic state (ball, cars, boost pads, tick count) from another arena, leaving the static world as-is
+	// The other arena must have the same game mode, arena config, and tick rate
+	// Cars are only re-created if they differ from the other arena's (by ID, team, or config), 
+	//	so this is much cheaper than Clone() when reusing an arena (see ArenaClonePool)
+	RSAPI void CopyStateFrom(Arena* other, bool copyCallbacks);
+
+	// NOTE: Car ID will not be restored, the car gets the given ID (or the next unused one if 0)
+	RSAPI Car* DeserializeNewCar(DataStreamIn& in, Team team, uint32_t id = 0);
 
 	// Simulate everything in the arena for a given number of ticks
 	RSAPI void Step(int ticksToSimulate = 1);
@@ -190,10 +209,16 @@ public:
 		return _config.memWeightMode;
 	}
 
+	// Approximate heap memory owned by this arena, in bytes
+	// Includes the pools and grids sized by the ArenaMemWeightMode, plus anything allocated while simulating (pairs, manifolds, cars, etc.)
+	// Collision meshes shared between arenas are not included
+	RSAPI size_t GetMemoryUsage() const;
+
 private:
 	
-	// Constructor for use by Arena::Create()
-	Arena(GameMode gameMode, const ArenaConfig& config, float tickRate = 120);
+	// Constructor for use by Arena::Create() and Arena::CreateLike()
+	// If staticSource is set, its static broadphase cells are copied instead of built
+	Arena(GameMode gameMode, const ArenaConfig& config, float tickRate = 120, const Arena* staticSource = NULL);
 
 	// Making this private because horrible memory overflows can happen if you changed it
 	ArenaConfig _config;
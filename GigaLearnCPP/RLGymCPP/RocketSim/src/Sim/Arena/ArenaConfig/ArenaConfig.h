@@ -37,6 +37,15 @@ struct ArenaConfig {
 	// Turn this off if you want to use a giant map
 	bool useCustomBroadphase = true;
 
+	// Use a custom narrowphase for ball collisions with the arena meshes
+	// Skips Bullet's per-triangle algorithm setup, results are identical
+	bool useCustomBallNarrowphase = false;
+
+	// Use a custom narrowphase for car hitbox collisions with the arena meshes
+	// Replaces Bullet's per-triangle GJK/EPA with a closed-form box vs. triangle test, which is much faster
+	// NOTE: Contacts only match Bullet's within a small tolerance, so car-arena collisions will not exactly match RL
+	bool useCustomCarNarrowphase = false;
+
 	// Maximum number of objects
 	int maxObjects = 512;
 
@@ -50,6 +59,6 @@ struct ArenaConfig {
 };
 
 #define ARENA_CONFIG_SERIALIZATION_FIELDS \
-minPos, maxPos, maxAABBLen, noBallRot, useCustomBroadphase
+minPos, maxPos, maxAABBLen, noBallRot, useCustomBroadphase, useCustomBallNarrowphase, useCustomCarNarrowphase
 
 RS_NS_END
\ No newline at end of file
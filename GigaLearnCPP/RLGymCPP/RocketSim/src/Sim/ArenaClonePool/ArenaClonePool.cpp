@@ -0,0 +1,38 @@
+#include "ArenaClonePool.h"
+
+RS_NS_START
+
+void ArenaClonePool::Reserve(Arena* source, size_t amount) {
+	while (_allArenas.size() < amount) {
+		Arena* arena = Arena::CreateLike(source);
+		_allArenas.push_back(arena);
+		_freeArenas.push_back(arena);
+	}
+}
+
+Arena* ArenaClonePool::Acquire(Arena* source, bool copyCallbacks) {
+	Arena* arena;
+	if (!_freeArenas.empty()) {
+		arena = _freeArenas.back();
+		_freeArenas.pop_back();
+	} else {
+		arena = Arena::CreateLike(source);
+		_allArenas.push_back(arena);
+	}
+
+	arena->CopyStateFrom(source, copyCallbacks);
+	return arena;
+}
+
+void ArenaClonePool::Release(Arena* arena) {
+	assert(std::find(_allArenas.begin(), _allArenas.end(), arena) != _allArenas.end());
+	assert(std::find(_freeArenas.begin(), _freeArenas.end(), arena) == _freeArenas.end());
+	_freeArenas.push_back(arena);
+}
+
+ArenaClonePool::~ArenaClonePool() {
+	for (Arena* arena : _allArenas)
+		delete arena;
+}
+
+RS_NS_END
@@ -0,0 +1,38 @@
+#pragma once
+#include "../Arena/Arena.h"
+
+RS_NS_START
+
+// A pool of reusable arenas for making many short-lived clones of an arena (e.g. lookahead rollouts)
+// Each pooled arena is only created once, after that cloning just copies the dynamic state (see Arena::CopyStateFrom())
+// Pooled arenas are made with Arena::CreateLike(), so they take their static broadphase cells from the source arena
+// All source arenas must have the same game mode, arena config, and tick rate
+// NOTE: Not thread-safe, use one pool per thread
+struct ArenaClonePool {
+	std::vector<Arena*> _allArenas;
+	std::vector<Arena*> _freeArenas;
+
+	ArenaClonePool() = default;
+
+	// Creates a number of arenas ahead of time, so that the first Acquire() calls are also cheap
+	RSAPI void Reserve(Arena* source, size_t amount);
+
+	// Get an arena with the same state as source
+	// The arena should be given back with Release() when you are done with it
+	RSAPI Arena* Acquire(Arena* source, bool copyCallbacks = false);
+
+	// Return an arena from Acquire() to the pool
+	RSAPI void Release(Arena* arena);
+
+	size_t GetNumCreated() const { return _allArenas.size(); }
+	size_t GetNumFree() const { return _freeArenas.size(); }
+
+	// No copying
+	ArenaClonePool(const ArenaClonePool& other) = delete;
+	ArenaClonePool& operator=(const ArenaClonePool& other) = delete;
+
+	// Deletes all arenas, including ones that haven't been released
+	RSAPI ~ArenaClonePool();
+};
+
+RS_NS_END
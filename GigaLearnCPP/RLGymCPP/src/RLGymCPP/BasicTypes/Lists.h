@@ -166,4 +166,51 @@ namespace RLGC {
 			return size[1];
 		}
 	};
-}
\ No newline at end of file
+}
+
+///////////////
+
+namespace RLGC {
+	// Vector-like list with fixed capacity and inline storage
+	// Unlike std::vector, it is trivially copyable as long as T is
+	template <typename T, size_t CAPACITY>
+	struct FixedList {
+		T _data[CAPACITY];
+		size_t _size = 0;
+
+		size_t size() const { return _size; }
+		bool empty() const { return _size == 0; }
+		constexpr static size_t capacity() { return CAPACITY; }
+
+		T* data() { return _data; }
+		const T* data() const { return _data; }
+
+		T* begin() { return _data; }
+		T* end() { return _data + _size; }
+		const T* begin() const { return _data; }
+		const T* end() const { return _data + _size; }
+
+		T& operator[](size_t index) { return _data[index]; }
+		const T& operator[](size_t index) const { return _data[index]; }
+
+		T& back() { return _data[_size - 1]; }
+		const T& back() const { return _data[_size - 1]; }
+
+		void push_back(const T& val) {
+			RG_ASSERT(_size < CAPACITY);
+			_data[_size++] = val;
+		}
+
+		// New elements are value-initialized, like std::vector::resize()
+		void resize(size_t newSize) {
+			RG_ASSERT(newSize <= CAPACITY);
+			for (size_t i = _size; i < newSize; i++)
+				_data[i] = T();
+			_size = newSize;
+		}
+
+		void clear() {
+			_size = 0;
+		}
+	};
+}
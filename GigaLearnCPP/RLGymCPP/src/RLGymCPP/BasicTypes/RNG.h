@@ -0,0 +1,135 @@
+#pragma once
+#include "../Framework.h"
+
+namespace RLGC {
+
+	// Counter-based random number generator (SplitMix64 over a counter)
+	// Every draw is a pure function of (key, counter), so a stream is fully determined by its seed and index,
+	//	no matter which thread happens to be using it
+	// Cheap to copy, so one can be kept per arena with no sharing between threads
+	struct RNG {
+		constexpr static uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+
+		uint64_t key = 0;
+		uint64_t counter = 0; // Amount of values drawn so far
+
+		RNG() = default;
+
+		// Each stream index gives an independent sequence for the same seed
+		explicit RNG(uint64_t seed, uint64_t stream = 0) {
+			key = Mix(seed ^ Mix(stream + GOLDEN_GAMMA));
+		}
+
+		// SplitMix64 finalizer
+		static uint64_t Mix(uint64_t x) {
+			x ^= x >> 30;
+			x *= 0xBF58476D1CE4E5B9ull;
+			x ^= x >> 27;
+			x *= 0x94D049BB133111EBull;
+			x ^= x >> 31;
+			return x;
+		}
+
+		// The value at any position of a stream, without needing to draw the ones before it
+		static uint64_t At(uint64_t key, uint64_t counter) {
+			return Mix(key + counter * GOLDEN_GAMMA);
+		}
+
+		// Top 24 bits to a float in [0, 1)
+		static float ToFloat(uint64_t bits) {
+			return (bits >> 40) * (1.f / (1 << 24));
+		}
+
+		// New independent generator derived from this one's key
+		RNG Fork(uint64_t stream) const {
+			RNG result = {};
+			result.key = Mix(key ^ Mix(stream + GOLDEN_GAMMA));
+			return result;
+		}
+
+		uint64_t NextU64() {
+			return At(key, ++counter);
+		}
+
+		uint32_t NextU32() {
+			return (uint32_t)(NextU64() >> 32);
+		}
+
+		// Uniform in [0, 1)
+		float NextFloat() {
+			return ToFloat(NextU64());
+		}
+
+		// Uniform in [min, max)
+		float RandFloat(float min = 0, float max = 1) {
+			return min + NextFloat() * (max - min);
+		}
+
+		// Uniform in [min, max), same range convention as RocketSim::Math::RandInt()
+		// Uses Lemire's multiply-shift with rejection, so there is no modulo bias
+		int RandInt(int min, int max) {
+			RG_ASSERT(max > min);
+			uint32_t range = (uint32_t)((int64_t)max - min);
+			uint64_t m = (uint64_t)NextU32() * range;
+			if ((uint32_t)m < range) {
+				uint32_t threshold = (0u - range) % range;
+				while ((uint32_t)m < threshold)
+					m = (uint64_t)NextU32() * range;
+			}
+			return min + (int)(m >> 32);
+		}
+
+		Vec RandVec(Vec min, Vec max) {
+			float x = RandFloat(min.x, max.x);
+			float y = RandFloat(min.y, max.y);
+			float z = RandFloat(min.z, max.z);
+			return Vec(x, y, z);
+		}
+
+		///////////////////////////////
+		// Bulk draws
+		// Element i uses counter position (counter + 1 + i) so there is no dependency between iterations,
+		//	and the results are identical to calling the single-value function n times
+
+		void FillFloat(float* out, size_t n, float min = 0, float max = 1) {
+			const uint64_t base = counter + 1;
+			const float scale = max - min;
+			for (size_t i = 0; i < n; i++)
+				out[i] = min + ToFloat(At(key, base + i)) * scale;
+			counter += n;
+		}
+
+		void FillU64(uint64_t* out, size_t n) {
+			const uint64_t base = counter + 1;
+			for (size_t i = 0; i < n; i++)
+				out[i] = At(key, base + i);
+			counter += n;
+		}
+
+		// Uniform ints in [min, max)
+		// Rejected draws (probability below range/2^32) are redrawn in a second pass after the batch,
+		//	so results can differ from calling RandInt() n times
+		void FillInt(int* out, size_t n, int min, int max) {
+			RG_ASSERT(max > min);
+			const uint32_t range = (uint32_t)((int64_t)max - min);
+			const uint32_t threshold = (0u - range) % range;
+			const uint64_t base = counter + 1;
+
+			bool anyRejected = false;
+			for (size_t i = 0; i < n; i++) {
+				uint64_t m = (At(key, base + i) >> 32) * range;
+				anyRejected |= ((uint32_t)m < threshold);
+				out[i] = min + (int)(m >> 32);
+			}
+			counter += n;
+
+			if (anyRejected) {
+				for (size_t i = 0; i < n; i++) {
+					uint64_t m = (At(key, base + i) >> 32) * range;
+					if ((uint32_t)m < threshold)
+						out[i] = RandInt(min, max);
+				}
+			}
+		}
+	};
+}
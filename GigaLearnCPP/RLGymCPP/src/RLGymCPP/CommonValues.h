@@ -41,6 +41,9 @@ namespace RLGC {
 			ORANGE_TEAM = 1,
 			NUM_ACTIONS = 8;
 
+		// Maximum amount of players in a single game (GameState uses fixed storage)
+		constexpr int MAX_PLAYERS = 8;
+
 		constexpr int BOOST_LOCATIONS_AMOUNT = 34;
 		constexpr Vec BOOST_LOCATIONS[BOOST_LOCATIONS_AMOUNT] = {
 				{0.f, -4240.0, 70.0},
@@ -0,0 +1,193 @@
+#include "BatchedEventTracker.h"
+
+using namespace RLGC;
+
+// Same as GetShooterPasser() in GameEventTracker.cpp, but returns car indices (-1 if none)
+static bool GetShooterPasserIdx(Arena* arena, Team team, int& shooterOut, bool findPasser, int& passerOut, uint64_t maxShooterTicks, uint64_t maxPasserTicks) {
+	shooterOut = passerOut = -1;
+	const auto& cars = arena->_cars;
+
+	uint64_t shooterHitTick = 0;
+	for (int i = 0; i < cars.size(); i++) {
+		Car* car = cars[i];
+		if (car->team != team)
+			continue;
+
+		const auto& hitInfo = car->_internalState.ballHitInfo;
+		if (!hitInfo.isValid)
+			continue;
+
+		if (hitInfo.tickCountWhenHit + maxShooterTicks >= arena->tickCount) {
+			if (shooterOut == -1 || hitInfo.tickCountWhenHit > shooterHitTick) {
+				shooterOut = i;
+				shooterHitTick = hitInfo.tickCountWhenHit;
+			}
+		}
+	}
+
+	if (shooterOut != -1 && findPasser) {
+		uint64_t passerHitTick = 0;
+		for (int i = 0; i < cars.size(); i++) {
+			Car* car = cars[i];
+			if (car->team != team || i == shooterOut)
+				continue;
+
+			const auto& hitInfo = car->_internalState.ballHitInfo;
+			if (!hitInfo.isValid)
+				continue;
+
+			if (hitInfo.tickCountWhenHit + maxPasserTicks >= shooterHitTick) {
+				if (passerOut == -1 || hitInfo.tickCountWhenHit > passerHitTick) {
+					passerOut = i;
+					passerHitTick = hitInfo.tickCountWhenHit;
+				}
+			}
+		}
+	}
+
+	return shooterOut != -1;
+}
+
+void RLGC::BatchedEventTracker::Init(const std::vector<Arena*>& arenas, const std::vector<int>& arenaPlayerStartIdx, int numPlayers) {
+	int numArenas = arenas.size();
+
+	arenaEnabled.resize(numArenas);
+	for (int i = 0; i < numArenas; i++)
+		arenaEnabled[i] = arenas[i]->gameMode != GameMode::HEATSEEKER;
+
+	shotCooldowns.assign(numArenas, 0);
+	ballShot.assign(numArenas, false);
+	ballScoredLast.assign(numArenas, false);
+	ballShotGoalTeams.assign(numArenas, Team::BLUE);
+	lastBallUpdateCounts.assign(numArenas, 0);
+
+	this->arenaPlayerStartIdx = arenaPlayerStartIdx;
+	playerEventFlags.assign(numPlayers, 0);
+}
+
+void RLGC::BatchedEventTracker::UpdateArena(int arenaIdx, Arena* arena) {
+	if (!arenaEnabled[arenaIdx])
+		return;
+
+	uint8_t* flags = &playerEventFlags[arenaPlayerStartIdx[arenaIdx]];
+	std::fill(flags, flags + arena->_cars.size(), 0);
+
+	bool scored = arena->IsBallScored();
+
+	float tickrate = arena->GetTickRate();
+	uint64_t ballUpdateCount = arena->ball->_internalState.updateCounter;
+	uint64_t& lastBallUpdateCount = lastBallUpdateCounts[arenaIdx];
+
+	if (ballUpdateCount > lastBallUpdateCount || !autoStateSetDetection) {
+		// Game is continuing
+
+		uint64_t deltaTicks = ballUpdateCount - lastBallUpdateCount;
+
+		// Time since last update
+		float deltaTime = deltaTicks * arena->tickTime;
+
+		float& shotCooldown = shotCooldowns[arenaIdx];
+		Team& ballShotGoalTeam = ballShotGoalTeams[arenaIdx];
+
+		if (scored && !ballScoredLast[arenaIdx]) {
+			// Goal event
+			int shooter, passer;
+			if (GetShooterPasserIdx(
+				arena,
+				RS_TEAM_FROM_Y(-arena->ball->_rigidBody.getWorldTransform().m_origin.y()),
+				shooter, true, passer,
+				config.goalMaxTouchTime * tickrate,
+				config.passMaxTouchTime * tickrate
+			)) {
+				flags[shooter] |= EVENT_GOAL;
+				if (passer != -1)
+					flags[passer] |= EVENT_ASSIST;
+			}
+		} else if (!ballShot[arenaIdx]) {
+			// Ball is not currently shot
+
+			if (shotCooldown > 0) {
+				// Can't make a shot yet
+				shotCooldown = RS_MAX(shotCooldown - deltaTime, 0);
+			} else {
+				float speedSq = (arena->ball->_rigidBody.m_linearVelocity * BT_TO_UU).length2();
+				Team goalTeam;
+				if (speedSq >= config.shotMinSpeed * config.shotMinSpeed &&
+					arena->IsBallProbablyGoingIn(config.shotMinScoreTime, config.predScoreExtraMargin, &goalTeam)) {
+
+					Team shooterTeam = RS_OPPOSITE_TEAM(goalTeam);
+					uint64_t shotMinTouchDelayTicks = config.shotTouchMinDelay * tickrate;
+
+					int shooter, passer;
+					if (GetShooterPasserIdx(
+						arena,
+						shooterTeam,
+						shooter, true, passer,
+						deltaTicks + shotMinTouchDelayTicks,
+						config.passMaxTouchTime * tickrate
+					)) {
+						uint64_t ticksSinceHit = arena->tickCount - arena->_cars[shooter]->_internalState.ballHitInfo.tickCountWhenHit;
+						if (ticksSinceHit >= shotMinTouchDelayTicks) {
+							// This is officially now a shot!
+							ballShot[arenaIdx] = true;
+							ballShotGoalTeam = goalTeam;
+							shotCooldown = config.shotEventCooldown;
+
+							flags[shooter] |= EVENT_SHOT;
+							if (passer != -1)
+								flags[passer] |= EVENT_SHOT_PASS;
+						}
+					}
+				}
+			}
+		} else {
+			// Ball is currently shot
+
+			bool willScore = arena->IsBallProbablyGoingIn(config.shotMinScoreTime, config.predScoreExtraMargin);
+			if (!willScore) {
+				// Ball is no longer going in, if a car from the team it was going at just hit it, that was a save
+				int saver, unused;
+				if (GetShooterPasserIdx(arena, ballShotGoalTeam, saver, false, unused, deltaTicks, 0))
+					flags[saver] |= EVENT_SAVE;
+
+				ballShot[arenaIdx] = false;
+			}
+		}
+	} else if (ballUpdateCount == lastBallUpdateCount) {
+		// Skip this update
+		return;
+	} else {
+		// Ball update count decreased
+		ResetArena(arenaIdx);
+	}
+
+	ballScoredLast[arenaIdx] = scored;
+	lastBallUpdateCount = ballUpdateCount;
+}
+
+void RLGC::BatchedEventTracker::ApplyToState(int arenaIdx, GameState& gs) const {
+	if (!arenaEnabled[arenaIdx])
+		return;
+
+	const uint8_t* flags = &playerEventFlags[arenaPlayerStartIdx[arenaIdx]];
+	for (int i = 0; i < gs.players.size(); i++) {
+		uint8_t playerFlags = flags[i];
+		if (!playerFlags)
+			continue;
+
+		auto& eventState = gs.players[i].eventState;
+		eventState.shot |= (playerFlags & EVENT_SHOT) != 0;
+		eventState.shotPass |= (playerFlags & EVENT_SHOT_PASS) != 0;
+		eventState.goal |= (playerFlags & EVENT_GOAL) != 0;
+		eventState.assist |= (playerFlags & EVENT_ASSIST) != 0;
+		eventState.save |= (playerFlags & EVENT_SAVE) != 0;
+	}
+}
+
+void RLGC::BatchedEventTracker::ResetArena(int arenaIdx) {
+	ballScoredLast[arenaIdx] = false;
+	ballShot[arenaIdx] = false;
+	shotCooldowns[arenaIdx] = 0;
+
+	// ballShotGoalTeams doesn't need to be reset
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "../Gamestates/GameState.h"
+
+namespace RLGC {
+	// Tracks shots, goals, assists, and saves for every arena of an EnvSet, with the same detection as RocketSim's GameEventTracker
+	// Instead of one tracker per arena reporting events through callbacks, the persistent info of all arenas is kept in flat arrays,
+	//	and each update writes the events as flags into a preallocated per-player array (rows packed like EnvState's players)
+	// Arenas are independent, so different arenas can be updated from different threads at the same time
+	struct BatchedEventTracker {
+		enum : uint8_t {
+			EVENT_SHOT = 1 << 0,
+			EVENT_SHOT_PASS = 1 << 1,
+			EVENT_GOAL = 1 << 2,
+			EVENT_ASSIST = 1 << 3,
+			EVENT_SAVE = 1 << 4,
+		};
+
+		GameEventTrackerConfig config = {};
+
+		// Same as GameEventTracker::autoStateSetDetection
+		bool autoStateSetDetection = true;
+
+		// Per-arena persistent info, see GameEventTracker
+		std::vector<uint8_t> arenaEnabled; // Heatseeker arenas aren't tracked
+		std::vector<float> shotCooldowns;
+		std::vector<uint8_t> ballShot, ballScoredLast;
+		std::vector<Team> ballShotGoalTeams;
+		std::vector<uint64_t> lastBallUpdateCounts;
+
+		// Per-player event flags from the last update of their arena
+		std::vector<int> arenaPlayerStartIdx;
+		std::vector<uint8_t> playerEventFlags;
+
+		void Init(const std::vector<Arena*>& arenas, const std::vector<int>& arenaPlayerStartIdx, int numPlayers);
+
+		// Call after stepping the arena, at the same interval GameEventTracker::Update() would be
+		void UpdateArena(int arenaIdx, Arena* arena);
+
+		// ORs the arena's flags from its last update into its players' event states
+		// Players must be in the arena's car order (as GameState::UpdateFromArena() makes them)
+		void ApplyToState(int arenaIdx, GameState& gs) const;
+
+		// Same as GameEventTracker::ResetPersistentInfo()
+		void ResetArena(int arenaIdx);
+	};
+}
@@ -48,76 +48,139 @@ RLGC::EnvSet::EnvSet(const EnvSetConfig& config) : config(config) {
 	RG_ASSERT(config.tickSkip > 0);
 	RG_ASSERT(config.actionDelay >= 0 && config.actionDelay <= config.tickSkip);
 
-	std::mutex appendMutex = {};
-	auto fnCreateArenas = [&](int idx) {
+	auto constructStartTime = std::chrono::steady_clock::now();
+	auto fnSecondsSince = [](std::chrono::steady_clock::time_point startTime) {
+		return std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+	};
+
+	// Every arena is written to its own slot, so the arena order always matches the index it was created with
+	const int numArenas = config.numArenas;
+	arenas.resize(numArenas);
+	eventTrackers.resize(numArenas);
+	eventCallbackInfos.resize(numArenas);
+	userInfos.resize(numArenas);
+	rewards.resize(numArenas);
+	terminalConditions.resize(numArenas);
+	obsBuilders.resize(numArenas);
+	actionParsers.resize(numArenas);
+	stateSetters.resize(numArenas);
+	arenaConstructTimes.resize(numArenas);
+
+	auto fnCreateArena = [&](int idx) {
+		auto startTime = std::chrono::steady_clock::now();
+
 		auto createResult = config.envCreateFn(idx);
 		auto arena = createResult.arena;
+		arenas[idx] = arena;
+
+		auto userInfo = new CallbackUserInfo();
+		userInfo->arena = arena;
+		userInfo->arenaIdx = idx;
+		userInfo->envSet = this;
+		eventCallbackInfos[idx] = userInfo;
+		arena->SetCarBumpCallback(_BumpCallback, userInfo);
+
+		if (arena->gameMode != GameMode::HEATSEEKER && !config.batchedEventTracking) {
+			GameEventTracker* tracker = new GameEventTracker({});
+			eventTrackers[idx] = tracker;
+
+			tracker->SetShotCallback(_ShotEventCallback, userInfo);
+			tracker->SetGoalCallback(_GoalEventCallback, userInfo);
+			tracker->SetSaveCallback(_SaveEventCallback, userInfo);
+		} else {
+			eventTrackers[idx] = NULL;
+		}
 
-		appendMutex.lock();
-		{
-			arenas.push_back(arena);
-
-			auto userInfo = new CallbackUserInfo();
-			userInfo->arena = arena;
-			userInfo->arenaIdx = idx;
-			userInfo->envSet = this;
-			eventCallbackInfos.push_back(userInfo);
-			arena->SetCarBumpCallback(_BumpCallback, userInfo);
-
-			if (arena->gameMode != GameMode::HEATSEEKER) {
-				GameEventTracker* tracker = new GameEventTracker({});
-				eventTrackers.push_back(tracker);
-
-				tracker->SetShotCallback(_ShotEventCallback, userInfo);
-				tracker->SetGoalCallback(_GoalEventCallback, userInfo);
-				tracker->SetSaveCallback(_SaveEventCallback, userInfo);
-			} else {
-				eventTrackers.push_back(NULL);
-				eventCallbackInfos.push_back(NULL);
-			}
+		userInfos[idx] = createResult.userInfo;
 
-			userInfos.push_back(createResult.userInfo);
+		rewards[idx] = createResult.rewards;
+		terminalConditions[idx] = createResult.terminalConditions;
+		obsBuilders[idx] = createResult.obsBuilder;
+		actionParsers[idx] = createResult.actionParser;
+		stateSetters[idx] = createResult.stateSetter;
 
-			rewards.push_back(createResult.rewards);
-			terminalConditions.push_back(createResult.terminalConditions);
-			obsBuilders.push_back(createResult.obsBuilder);
-			actionParsers.push_back(createResult.actionParser);
-			stateSetters.push_back(createResult.stateSetter);
-		}
-		appendMutex.unlock();
+		arenaConstructTimes[idx] = fnSecondsSince(startTime);
 	};
-	g_ThreadPool.StartBatchedJobs(fnCreateArenas, config.numArenas, false);
+
+	// Build in parallel with the same chunking as stepping, which sends each chunk to the same worker (see StartBatchedJobsChunked())
+	// Each arena's memory is then first touched by the thread that steps it, so it lands on that thread's NUMA node
+	// NOTE: Worker threads aren't pinned to cores, so the OS can still move a worker to another node
+	g_ThreadPool.StartBatchedJobsChunked(fnCreateArena, numArenas, false);
 
 	state.Resize(arenas);
+
+	if (config.batchedEventTracking)
+		batchedEventTracker.Init(arenas, state.arenaPlayerStartIdx, state.numPlayers);
+
+	rngs.resize(arenas.size());
+	for (int i = 0; i < arenas.size(); i++)
+		rngs[i] = RNG(config.randomSeed, i);
+
+	if (config.ballPredNumStates > 0)
+		ballPreds.resize(arenas.size(), BallPrediction(config.ballPredNumStates, config.ballPredTickInterval));
+
+	if (!config.batchedRewards.empty()) {
+		stateBatch.Resize(state.arenaPlayerStartIdx, state.numPlayers);
+		for (auto& weighted : config.batchedRewards)
+			weighted.reward->Init(config.numArenas);
+	}
 	
 	// Determine obs size and action amount, initialize arrays accordingly
 	{
-		stateSetters[0]->ResetArena(arenas[0]);
+		// Use a separate stream so that arena 0 starts the same as the others
+		RNG testRNG = RNG(config.randomSeed).Fork(arenas.size());
+		stateSetters[0]->ResetArena(arenas[0], testRNG);
 		GameState testState = GameState(arenas[0]);
 		testState.userInfo = userInfos[0];
+		testState.rng = &testRNG;
+		BallPrediction testBallPred = BallPrediction(config.ballPredNumStates, config.ballPredTickInterval);
+		if (!ballPreds.empty())
+			testState.ballPred = &testBallPred;
 		obsBuilders[0]->Reset(testState);
 		obsSize = obsBuilders[0]->BuildObs(testState.players[0], testState).size();
 		state.obs = DimList2<float>(state.numPlayers, obsSize);
 
-		state.actionMasks = DimList2<uint8_t>(state.numPlayers, actionParsers[0]->GetActionAmount());
+		numActions = actionParsers[0]->GetActionAmount();
+		state.actionMasks = DimList2<uint8_t>(state.numPlayers, numActions);
+	}
+
+	// All arenas share one policy, so they must agree on the action amount
+	for (int i = 1; i < arenas.size(); i++) {
+		int arenaNumActions = actionParsers[i]->GetActionAmount();
+		if (arenaNumActions != numActions) {
+			RG_ERR_CLOSE(
+				"EnvSet: Action parser of arena " << i << " (" << state.modeNames[state.arenaModeIdx[i]] << ") has " << arenaNumActions << " actions, "
+				"but arena 0 (" << state.modeNames[state.arenaModeIdx[0]] << ") has " << numActions
+			);
+		}
 	}
 
 	// Reset all arenas initially
-	g_ThreadPool.StartBatchedJobs(
-		std::bind(&RLGC::EnvSet::ResetArena, this, std::placeholders::_1),
-		config.numArenas, false
-	);
-	
+	auto fnInitialReset = [&](int idx) {
+		auto startTime = std::chrono::steady_clock::now();
+		ResetArena(idx);
+		arenaConstructTimes[idx] += fnSecondsSince(startTime);
+	};
+	g_ThreadPool.StartBatchedJobsChunked(fnInitialReset, numArenas, false);
+
+	constructTime = fnSecondsSince(constructStartTime);
 }
 
 void RLGC::EnvSet::StepFirstHalf(bool async) {
+	RG_PROFILE_SCOPE("EnvSet::StepFirstHalf");
+
+	// Set previous gamestates by swapping buffers instead of copying
+	// The current gamestates are now left over from two steps ago, and are overwritten in StepSecondHalf()
+	std::swap(state.gameStates, state.prevGameStates);
 
 	auto fnStepArena = [&](int arenaIdx) {
 		Arena* arena = arenas[arenaIdx];
 		auto& gs = state.gameStates[arenaIdx];
 
-		// Set previous gamestates
-		state.prevGameStates[arenaIdx] = gs;
+		// The arena was reset last step, so the leftover state is empty
+		// The players still need to be present to receive events while stepping
+		if (gs.IsEmpty())
+			gs = state.prevGameStates[arenaIdx];
 
 		gs.ResetBeforeStep();
 
@@ -126,10 +189,11 @@ void RLGC::EnvSet::StepFirstHalf(bool async) {
 	};
 
 	// OPTIMISATION: Utiliser chunked jobs pour rduire l'overhead du thread pool
-	g_ThreadPool.StartBatchedJobsChunked(fnStepArena, arenas.size(), async);
+	g_ThreadPool.StartBatchedJobsChunked(fnStepArena, arenas.size(), async, "EnvSet::StepFirstHalf Job");
 }
 
 void RLGC::EnvSet::StepSecondHalf(const IList& actionIndices, bool async) {
+	RG_PROFILE_SCOPE("EnvSet::StepSecondHalf");
 
 	auto fnStepArenas = [&](int arenaIdx) {
 
@@ -155,146 +219,234 @@ void RLGC::EnvSet::StepSecondHalf(const IList& actionIndices, bool async) {
 		// Step arena
 		arena->Step(config.tickSkip - config.actionDelay);
 
-		if (eventTrackers[arenaIdx])
-			eventTrackers[arenaIdx]->Update(arena);
-
-		GameState* gsPrev = &state.prevGameStates[arenaIdx];
-		if (gsPrev->IsEmpty())
-			gsPrev = NULL;
-
-		gs.UpdateFromArena(arena, actions, gsPrev);
-
-		// Update terminal
-		uint8_t terminalType = TerminalType::NOT_TERMINAL;
-		for (auto cond : terminalConditions[arenaIdx]) {
-			if (cond->IsTerminal(gs)) {
-				bool isTrunc = cond->IsTruncation();
-				uint8_t curTerminalType = isTrunc ? TerminalType::TRUNCATED : TerminalType::NORMAL;
-				if (terminalType == TerminalType::NOT_TERMINAL) {
-					terminalType = curTerminalType;
-				} else if (curTerminalType == TerminalType::NORMAL) {
-					terminalType = curTerminalType;
-				}
+		uint8_t terminalType = UpdateArenaState(arenaIdx, actions);
+		StepArenaRewards(arenaIdx, terminalType);
+		BuildArenaObs(arenaIdx);
+	};
+
+	// OPTIMISATION: Utiliser chunked jobs pour rduire l'overhead
+	if (config.batchedRewards.empty()) {
+		g_ThreadPool.StartBatchedJobsChunked(fnStepArenas, arenas.size(), async, "EnvSet::StepSecondHalf Job");
+	} else {
+		// Batched rewards need every arena to be stepped first
+		g_ThreadPool.StartBatchedJobsChunked(fnStepArenas, arenas.size(), false, "EnvSet::StepSecondHalf Job");
+		StepBatchedRewards(async);
+	}
+
+	stepCount++;
+}
+
+uint8_t RLGC::EnvSet::UpdateArenaState(int arenaIdx, const std::vector<Action>& actions) {
+	Arena* arena = arenas[arenaIdx];
+	auto& gs = state.gameStates[arenaIdx];
+
+	UpdateArenaEvents(arenaIdx);
+
+	GameState* gsPrev = &state.prevGameStates[arenaIdx];
+	if (gsPrev->IsEmpty())
+		gsPrev = NULL;
+
+	gs.UpdateFromArena(arena, actions, gsPrev);
+
+	// Update terminal
+	uint8_t terminalType = TerminalType::NOT_TERMINAL;
+	for (auto cond : terminalConditions[arenaIdx]) {
+		if (cond->IsTerminal(gs)) {
+			bool isTrunc = cond->IsTruncation();
+			uint8_t curTerminalType = isTrunc ? TerminalType::TRUNCATED : TerminalType::NORMAL;
+			if (terminalType == TerminalType::NOT_TERMINAL) {
+				terminalType = curTerminalType;
+			} else if (curTerminalType == TerminalType::NORMAL) {
+				terminalType = curTerminalType;
 			}
 		}
-		state.terminals[arenaIdx] = terminalType;
-		
-		// Pre-step rewards
-		for (auto& weighted : rewards[arenaIdx])
-			weighted.reward->PreStep(gs);
+	}
+	state.terminals[arenaIdx] = terminalType;
+
+	if (!config.batchedRewards.empty())
+		stateBatch.SetArena(arenaIdx, gs, terminalType);
+
+	return terminalType;
+}
+
+void RLGC::EnvSet::StepArenaRewards(int arenaIdx, uint8_t terminalType) {
+	auto& gs = state.gameStates[arenaIdx];
+	const int playerStartIdx = state.arenaPlayerStartIdx[arenaIdx];
+	const int numPlayersInArena = static_cast<int>(gs.players.size());
 
-		// OPTIMISATION MAJEURE: Rutiliser allRewards avec thread_local
-		thread_local FList allRewards;
-		allRewards.assign(numPlayersInArena, 0.0f);
+	// Pre-step rewards
+	for (auto& weighted : rewards[arenaIdx])
+		weighted.reward->PreStep(gs);
+
+	// OPTIMISATION MAJEURE: Rutiliser allRewards avec thread_local
+	thread_local FList allRewards;
+	allRewards.assign(numPlayersInArena, 0.0f);
+	
+	// OPTIMISATION: Cache le nombre de reward functions
+	const int numRewardFuncs = static_cast<int>(rewards[arenaIdx].size());
+	
+	// OPTIMISATION: Pr-allouer lastRewards si ncessaire
+	const size_t numSavedRewards = numRewardFuncs + config.batchedRewards.size();
+	if (config.saveRewards && state.lastRewards[arenaIdx].size() != numSavedRewards) {
+		state.lastRewards[arenaIdx].resize(numSavedRewards);
+	}
+	
+	// OPTIMISATION MAJEURE: Buffer thread-local pour viter allocation par reward
+	thread_local FList rewardOutputBuffer;
+	rewardOutputBuffer.resize(numPlayersInArena);
+	
+	for (int rewardIdx = 0; rewardIdx < numRewardFuncs; rewardIdx++) {
+		auto& weightedReward = rewards[arenaIdx][rewardIdx];
 		
-		// OPTIMISATION: Cache le nombre de reward functions
-		const int numRewardFuncs = static_cast<int>(rewards[arenaIdx].size());
+		// OPTIMISATION: Utiliser GetAllRewardsInPlace pour viter l'allocation
+		weightedReward.reward->GetAllRewardsInPlace(gs, terminalType, rewardOutputBuffer.data());
 		
-		// OPTIMISATION: Pr-allouer lastRewards si ncessaire
-		if (config.saveRewards && state.lastRewards[arenaIdx].size() != static_cast<size_t>(numRewardFuncs)) {
-			state.lastRewards[arenaIdx].resize(numRewardFuncs);
+		const float weight = weightedReward.weight;
+		
+		// OPTIMISATION: Accs direct aux donnes sans bounds checking
+		float* allRewardsPtr = allRewards.data();
+		const float* outputPtr = rewardOutputBuffer.data();
+		
+		// OPTIMISATION: Loop unrolling x4 pour 2v2 (4 joueurs)
+		int i = 0;
+		const int unrollEnd = numPlayersInArena - (numPlayersInArena % 4);
+		for (; i < unrollEnd; i += 4) {
+			allRewardsPtr[i]   += outputPtr[i]   * weight;
+			allRewardsPtr[i+1] += outputPtr[i+1] * weight;
+			allRewardsPtr[i+2] += outputPtr[i+2] * weight;
+			allRewardsPtr[i+3] += outputPtr[i+3] * weight;
+		}
+		for (; i < numPlayersInArena; i++) {
+			allRewardsPtr[i] += outputPtr[i] * weight;
+		}
+
+		if (config.saveRewards) {
+			int playerSampleIndex = GetRewardSampleIndex(arenaIdx);
+			float rewardToSave = rewardOutputBuffer[playerSampleIndex];
+				
+			const std::vector<float>* innerRewards = weightedReward.reward->GetInnerRewards();
+			if (innerRewards && playerSampleIndex < static_cast<int>(innerRewards->size())) {
+				rewardToSave = (*innerRewards)[playerSampleIndex];
+			}
+
+			state.lastRewards[arenaIdx][rewardIdx] = rewardToSave;
 		}
+	}
+
+	// OPTIMISATION: Copie directe des rewards
+	for (int i = 0; i < numPlayersInArena; i++) {
+		state.rewards[playerStartIdx + i] = allRewards[i];
+	}
+}
+
+void RLGC::EnvSet::BuildArenaObs(int arenaIdx) {
+	auto& gs = state.gameStates[arenaIdx];
+	const int playerStartIdx = state.arenaPlayerStartIdx[arenaIdx];
+	const int numPlayersInArena = static_cast<int>(gs.players.size());
+
+	// OPTIMISATION MAJEURE: Build obs et masks en utilisant SetFromPtr quand possible
+	for (int i = 0; i < numPlayersInArena; i++) {
+		const auto& player = gs.players[i];
 		
-		// OPTIMISATION MAJEURE: Buffer thread-local pour viter allocation par reward
-		thread_local FList rewardOutputBuffer;
-		rewardOutputBuffer.resize(numPlayersInArena);
+		// Build obs directement dans la ligne
+		size_t builtObsSize = obsBuilders[arenaIdx]->BuildObsInto(player, gs, state.obs.GetRowPtr(playerStartIdx + i), obsSize);
+		RG_ASSERT(builtObsSize == obsSize);
 		
-		for (int rewardIdx = 0; rewardIdx < numRewardFuncs; rewardIdx++) {
-			auto& weightedReward = rewards[arenaIdx][rewardIdx];
-			
-			// OPTIMISATION: Utiliser GetAllRewardsInPlace pour viter l'allocation
-			weightedReward.reward->GetAllRewardsInPlace(gs, terminalType, rewardOutputBuffer.data());
-			
+		// Build action mask et set directement
+		auto maskVec = actionParsers[arenaIdx]->GetActionMask(player, gs);
+		state.actionMasks.SetFromPtr(playerStartIdx + i, maskVec.data(), maskVec.size());
+	}
+}
+
+int RLGC::EnvSet::GetRewardSampleIndex(int arenaIdx) {
+	auto& gs = state.gameStates[arenaIdx];
+	const int numPlayersInArena = static_cast<int>(gs.players.size());
+
+	if (config.shuffleRewardSampling)
+		return rngs[arenaIdx].RandInt(0, numPlayersInArena);
+
+	int playerSampleIndex = 0;
+	for (int i = 1; i < numPlayersInArena; i++)
+		if (gs.players[i].carId < gs.players[playerSampleIndex].carId)
+			playerSampleIndex = i;
+	return playerSampleIndex;
+}
+
+void RLGC::EnvSet::StepBatchedRewards(bool async) {
+	RG_PROFILE_SCOPE("EnvSet::StepBatchedRewards");
+	batchedRewardOutputs.resize(state.numPlayers);
+
+	// One contiguous range of arenas per thread, each range only writes the rows of its own players
+	const int numArenas = arenas.size();
+	const int numRanges = RS_MIN(numArenas, g_ThreadPool.GetNumThreads());
+
+	auto fnStepRange = [this, numArenas, numRanges](int rangeIdx) {
+		StateBatch::Range range = stateBatch.GetRange(numArenas * rangeIdx / numRanges, numArenas * (rangeIdx + 1) / numRanges);
+
+		for (int rewardIdx = 0; rewardIdx < config.batchedRewards.size(); rewardIdx++) {
+			auto& weightedReward = config.batchedRewards[rewardIdx];
+			weightedReward.reward->PreStep(stateBatch, range);
+			weightedReward.reward->GetAllRewards(stateBatch, range, batchedRewardOutputs.data());
+
 			const float weight = weightedReward.weight;
-			
-			// OPTIMISATION: Accs direct aux donnes sans bounds checking
-			float* allRewardsPtr = allRewards.data();
-			const float* outputPtr = rewardOutputBuffer.data();
-			
-			// OPTIMISATION: Loop unrolling x4 pour 2v2 (4 joueurs)
-			int i = 0;
-			const int unrollEnd = numPlayersInArena - (numPlayersInArena % 4);
-			for (; i < unrollEnd; i += 4) {
-				allRewardsPtr[i]   += outputPtr[i]   * weight;
-				allRewardsPtr[i+1] += outputPtr[i+1] * weight;
-				allRewardsPtr[i+2] += outputPtr[i+2] * weight;
-				allRewardsPtr[i+3] += outputPtr[i+3] * weight;
-			}
-			for (; i < numPlayersInArena; i++) {
-				allRewardsPtr[i] += outputPtr[i] * weight;
-			}
+			for (int i = range.playerStart; i < range.playerEnd; i++)
+				state.rewards[i] += batchedRewardOutputs[i] * weight;
 
 			if (config.saveRewards) {
-				int playerSampleIndex;
-				if (config.shuffleRewardSampling) {
-					playerSampleIndex = Math::RandInt(0, numPlayersInArena);
-				} else {
-					playerSampleIndex = 0;
-					int lowestID = gs.players[0].carId;
-					for (int pi = 1; pi < numPlayersInArena; pi++) {
-						if (gs.players[pi].carId < lowestID) {
-							lowestID = gs.players[pi].carId;
-							playerSampleIndex = pi;
-						}
-					}
+				for (int arenaIdx = range.arenaStart; arenaIdx < range.arenaEnd; arenaIdx++) {
+					int playerSampleIndex = GetRewardSampleIndex(arenaIdx);
+					float rewardToSave = batchedRewardOutputs[state.arenaPlayerStartIdx[arenaIdx] + playerSampleIndex];
+					state.lastRewards[arenaIdx][rewards[arenaIdx].size() + rewardIdx] = rewardToSave;
 				}
-				float rewardToSave = rewardOutputBuffer[playerSampleIndex];
-					
-				const std::vector<float>* innerRewards = weightedReward.reward->GetInnerRewards();
-				if (innerRewards && playerSampleIndex < static_cast<int>(innerRewards->size())) {
-					rewardToSave = (*innerRewards)[playerSampleIndex];
-				}
-
-				state.lastRewards[arenaIdx][rewardIdx] = rewardToSave;
 			}
 		}
-
-		// OPTIMISATION: Copie directe des rewards
-		for (int i = 0; i < numPlayersInArena; i++) {
-			state.rewards[playerStartIdx + i] = allRewards[i];
-		}
-
-		// OPTIMISATION MAJEURE: Build obs et masks en utilisant SetFromPtr quand possible
-		for (int i = 0; i < numPlayersInArena; i++) {
-			const auto& player = gs.players[i];
-			
-			// Build obs et set directement
-			auto obsVec = obsBuilders[arenaIdx]->BuildObs(player, gs);
-			state.obs.SetFromPtr(playerStartIdx + i, obsVec.data(), obsVec.size());
-			
-			// Build action mask et set directement
-			auto maskVec = actionParsers[arenaIdx]->GetActionMask(player, gs);
-			state.actionMasks.SetFromPtr(playerStartIdx + i, maskVec.data(), maskVec.size());
-		}
 	};
 
-	// OPTIMISATION: Utiliser chunked jobs pour rduire l'overhead
-	g_ThreadPool.StartBatchedJobsChunked(fnStepArenas, arenas.size(), async);
+	g_ThreadPool.StartBatchedJobs(fnStepRange, numRanges, async, "EnvSet::StepBatchedRewards Job");
 }
 
 void RLGC::EnvSet::ResetArena(int index) {
-	stateSetters[index]->ResetArena(arenas[index]);
+	stateSetters[index]->ResetArena(arenas[index], rngs[index]);
 	GameState newState = GameState(arenas[index]);
+	newState.userInfo = userInfos[index];
+	newState.rng = &rngs[index];
+	if (!ballPreds.empty()) {
+		ballPreds[index].Invalidate();
+		newState.ballPred = &ballPreds[index];
+	}
 	state.gameStates[index] = newState;
 
-	newState.userInfo = userInfos[index];
-
-	if (eventTrackers[index])
-		eventTrackers[index]->ResetPersistentInfo();
+	ResetArenaEvents(index);
 
 	obsBuilders[index]->Reset(newState);
 	for (auto& cond : terminalConditions[index])
 		cond->Reset(newState);
 	for (auto& weightedReward : rewards[index])
 		weightedReward.reward->Reset(newState);
+	for (auto& weightedReward : config.batchedRewards)
+		weightedReward.reward->Reset(index, newState);
 
 	const int playerStartIdx = state.arenaPlayerStartIdx[index];
 	const int numPlayers = static_cast<int>(newState.players.size());
+
+	// Rows are packed by the player counts at construction, so they can't change
+	if (numPlayers != state.arenaNumPlayers[index]) {
+		RG_ERR_CLOSE(
+			"EnvSet::ResetArena(): Arena " << index << " has " << numPlayers << " players after reset, "
+			"but had " << state.arenaNumPlayers[index] << " when the EnvSet was created (state setters must not add or remove cars)"
+		);
+	}
 	
-	// OPTIMISATION: Build obs and masks using SetFromPtr
+	// OPTIMISATION: Build obs directly into its row, and masks using SetFromPtr
 	for (int i = 0; i < numPlayers; i++) {
-		auto obsVec = obsBuilders[index]->BuildObs(newState.players[i], newState);
-		state.obs.SetFromPtr(playerStartIdx + i, obsVec.data(), obsVec.size());
+		size_t builtObsSize = obsBuilders[index]->BuildObsInto(newState.players[i], newState, state.obs.GetRowPtr(playerStartIdx + i), obsSize);
+		if (builtObsSize != obsSize) {
+			RG_ERR_CLOSE(
+				"EnvSet::ResetArena(): Obs builder of arena " << index << " (" << state.modeNames[state.arenaModeIdx[index]] << ") "
+				"built an obs of size " << builtObsSize << ", but arena 0 (" << state.modeNames[state.arenaModeIdx[0]] << ") built " << obsSize << ".\n"
+				"When mixing team sizes, use an obs builder with a fixed size (e.g. DefaultObsPadded) in every arena."
+			);
+		}
 		
 		auto maskVec = actionParsers[index]->GetActionMask(newState.players[i], newState);
 		state.actionMasks.SetFromPtr(playerStartIdx + i, maskVec.data(), maskVec.size());
@@ -304,6 +456,7 @@ void RLGC::EnvSet::ResetArena(int index) {
 }
 
 void RLGC::EnvSet::Reset() {
+	RG_PROFILE_SCOPE("EnvSet::Reset");
 	// OPTIMISATION: Early exit si rien  rinitialiser
 	bool hasTerminals = false;
 	const size_t numArenas = arenas.size();
@@ -341,6 +494,7 @@ void RLGC::EnvSet::Reset() {
 		// Utiliser le thread pool pour les resets parallles
 		for (int idx : indicesToReset) {
 			g_ThreadPool.StartJobAsync([this, idx]() {
+				RG_PROFILE_SCOPE("EnvSet::ResetArena Job");
 				ResetArena(idx);
 			});
 		}
@@ -351,4 +505,21 @@ void RLGC::EnvSet::Reset() {
 			ResetArena(idx);
 		}
 	}
-}
\ No newline at end of file
+}
+
+void RLGC::EnvSet::UpdateArenaEvents(int index) {
+	if (config.batchedEventTracking) {
+		batchedEventTracker.UpdateArena(index, arenas[index]);
+		batchedEventTracker.ApplyToState(index, state.gameStates[index]);
+	} else if (eventTrackers[index]) {
+		eventTrackers[index]->Update(arenas[index]);
+	}
+}
+
+void RLGC::EnvSet::ResetArenaEvents(int index) {
+	if (config.batchedEventTracking) {
+		batchedEventTracker.ResetArena(index);
+	} else if (eventTrackers[index]) {
+		eventTrackers[index]->ResetPersistentInfo();
+	}
+}
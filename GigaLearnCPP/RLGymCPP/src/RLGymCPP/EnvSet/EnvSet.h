@@ -3,10 +3,12 @@
 #include "../BasicTypes/Action.h"
 #include "../TerminalConditions/TerminalCondition.h"
 #include "../Rewards/Reward.h"
+#include "../Rewards/BatchedReward.h"
 #include "../OBSBuilders/OBSBuilder.h"
 #include "../ActionParsers/ActionParser.h"
 #include "../StateSetters/StateSetter.h"
 #include "../ThreadPool.h"
+#include "BatchedEventTracker.h"
 #include <RLGymCPP/Rewards/Reward.h>
 
 namespace RLGC {
@@ -30,6 +32,23 @@ namespace RLGC {
 		int actionDelay;
 		bool saveRewards;
 		bool shuffleRewardSampling = true;
+
+		// Each arena gets its own random stream made from this seed and its index (see RNG)
+		uint64_t randomSeed = 0;
+
+		// Rewards evaluated for all arenas at once, after every arena has been stepped
+		// These are added on top of each arena's own rewards
+		std::vector<WeightedBatchedReward> batchedRewards = {};
+
+		// Future ball states for each arena, see GameState::GetBallPred()
+		// Only computed when something asks for it, disabled when ballPredNumStates is 0
+		int ballPredNumStates = 0;
+		int ballPredTickInterval = 8; // Ticks between predicted states, old predictions can only be reused if this divides tickSkip
+
+		// Track shots, goals, and saves of all arenas with one BatchedEventTracker instead of a GameEventTracker per arena
+		// It uses the same detection, but maps events to players by their index in Arena::_cars, so it relies on the car order being stable
+		// Off by default until it's been checked against GameEventTracker on recorded rollouts
+		bool batchedEventTracking = false;
 	};
 
 	struct EnvState {
@@ -39,16 +58,52 @@ namespace RLGC {
 		DimList2<float> obs;
 		DimList2<uint8_t> actionMasks;
 		std::vector<float> rewards;
-		std::vector<std::vector<float>> lastRewards; // Only from the first arena
+		std::vector<std::vector<float>> lastRewards; // Arena rewards followed by batched rewards
 		std::vector<uint8_t> terminals;
 
+		// Arenas can have different player counts, so rows of obs, actionMasks and rewards are packed without padding
+		// Arena i owns rows [arenaPlayerStartIdx[i], arenaPlayerStartIdx[i] + arenaNumPlayers[i])
 		std::vector<int> arenaPlayerStartIdx = {};
+		std::vector<int> arenaNumPlayers = {};
+		std::vector<int> playerArenaIdx = {}; // Arena of each row
+
+		// Arenas with the same team sizes (e.g. "2v2") make up a mode
+		std::vector<std::string> modeNames = {};
+		std::vector<int> modeNumArenas = {};
+		std::vector<int> modeNumPlayers = {};
+		std::vector<int> arenaModeIdx = {};
 
 		void Resize(std::vector<Arena*>& arenas) {
 			numPlayers = 0;
+			arenaPlayerStartIdx.clear();
+			arenaNumPlayers.clear();
+			playerArenaIdx.clear();
+			modeNames.clear();
+			modeNumArenas.clear();
+			modeNumPlayers.clear();
+			arenaModeIdx.clear();
+
 			for (int i = 0; i < arenas.size(); i++) {
+				int teamSizes[2] = {};
+				for (Car* car : arenas[i]->_cars)
+					teamSizes[(int)car->team]++;
+				int arenaPlayers = teamSizes[0] + teamSizes[1];
+
 				arenaPlayerStartIdx.push_back(numPlayers);
-				numPlayers += arenas[i]->_cars.size();
+				arenaNumPlayers.push_back(arenaPlayers);
+				playerArenaIdx.insert(playerArenaIdx.end(), arenaPlayers, i);
+				numPlayers += arenaPlayers;
+
+				std::string modeName = RS_STR(teamSizes[0] << "v" << teamSizes[1]);
+				int modeIdx = std::find(modeNames.begin(), modeNames.end(), modeName) - modeNames.begin();
+				if (modeIdx == modeNames.size()) {
+					modeNames.push_back(modeName);
+					modeNumArenas.push_back(0);
+					modeNumPlayers.push_back(0);
+				}
+				modeNumArenas[modeIdx]++;
+				modeNumPlayers[modeIdx] += arenaPlayers;
+				arenaModeIdx.push_back(modeIdx);
 			}
 
 			gameStates.resize(arenas.size());
@@ -68,7 +123,8 @@ namespace RLGC {
 		};
 
 		std::vector<Arena*> arenas;
-		std::vector<GameEventTracker*> eventTrackers;
+		std::vector<GameEventTracker*> eventTrackers; // Null for every arena if batched event tracking is on
+		BatchedEventTracker batchedEventTracker = {};
 
 		std::vector<CallbackUserInfo*> eventCallbackInfos;
 		std::vector<void*> userInfos;
@@ -83,8 +139,19 @@ namespace RLGC {
 		std::vector<ObsBuilder*> obsBuilders;
 		std::vector<ActionParser*> actionParsers;
 		std::vector<StateSetter*> stateSetters;
+		std::vector<RNG> rngs; // One per arena, only used by that arena's jobs
+		std::vector<BallPrediction> ballPreds; // One per arena, empty if ball prediction is disabled
 
 		EnvState state = {};
+		uint64_t stepCount = 0; // Amount of times StepSecondHalf() was called
+
+		// Only filled if there are batched rewards
+		StateBatch stateBatch = {};
+		std::vector<float> batchedRewardOutputs; // One per player, each batched reward writes here before it's weighted
+
+		// Construction timing, in seconds
+		float constructTime = 0;
+		std::vector<float> arenaConstructTimes; // Arena creation, setup and initial reset, per arena
 
 		EnvSet(const EnvSetConfig& config);
 
@@ -105,7 +172,26 @@ namespace RLGC {
 		void StepFirstHalf(bool async);
 		void StepSecondHalf(const IList& actionIndices, bool async);
 		void Sync() { g_ThreadPool.WaitUntilDone(); }
+
+		// Evaluates the batched rewards once every arena has been stepped, with each thread taking a range of arenas
+		void StepBatchedRewards(bool async);
+
+		// The parts of StepSecondHalf() that run for each arena after it's stepped, in order
+		// These are also called by RunEnvSetBenchmark(), so it measures the same code
+		uint8_t UpdateArenaState(int arenaIdx, const std::vector<Action>& actions); // Events, game state, and terminal, returns the terminal type
+		void StepArenaRewards(int arenaIdx, uint8_t terminalType);
+		void BuildArenaObs(int arenaIdx); // Obs and action masks
+
+		// Which player of the arena to save rewards of for metrics (see EnvSetConfig::shuffleRewardSampling)
+		// Random if shuffling, otherwise the player with the lowest car ID
+		int GetRewardSampleIndex(int arenaIdx);
 		void ResetArena(int index);
 		void Reset();
+
+		// Detects events after the arena was stepped, and sets them in its current state's players
+		void UpdateArenaEvents(int index);
+
+		// Clears the arena's persistent event tracking info, for when its state is set
+		void ResetArenaEvents(int index);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,759 @@
+#include "EnvSetBenchmark.h"
+#include "../../../RocketSim/src/Sim/ArenaClonePool/ArenaClonePool.h"
+#include <deque>
+#include <map>
+#include <tuple>
+
+using namespace RLGC;
+
+RLGC::EnvSetBenchmarkResult RLGC::RunEnvSetBenchmark(EnvSet* envSet, const EnvSetBenchmarkConfig& config) {
+	enum { PHASE_ARENA_STEP, PHASE_REWARDS, PHASE_OBS, PHASE_AMOUNT };
+
+	EnvSetBenchmarkResult result = {};
+	result.phases = {
+		{ "arena_step", "tick" },
+		{ "rewards", "reward_call" },
+		{ "obs", "obs_row" },
+	};
+
+	const int numArenas = envSet->arenas.size();
+	const int tickSkip = envSet->config.tickSkip;
+	auto& state = envSet->state;
+
+	result.numArenas = numArenas;
+	result.numPlayers = state.numPlayers;
+	result.tickSkip = tickSkip;
+	result.numSteps = config.numSteps;
+
+	// One set of counters per phase, each only counts during its phase
+	std::vector<std::unique_ptr<PerfCounters>> counters;
+	if (config.usePerfCounters) {
+		for (int i = 0; i < PHASE_AMOUNT; i++)
+			counters.push_back(std::make_unique<PerfCounters>());
+		result.perfCounterError = counters[0]->error;
+	} else {
+		result.perfCounterError = "Perf counters disabled";
+	}
+
+	bool measuring = false;
+	std::chrono::steady_clock::time_point phaseStartTime;
+	auto fnStartPhase = [&](int phase) {
+		if (!measuring)
+			return;
+		if (!counters.empty())
+			counters[phase]->Start();
+		phaseStartTime = std::chrono::steady_clock::now();
+	};
+	auto fnEndPhase = [&](int phase, uint64_t numUnits) {
+		if (!measuring)
+			return;
+		result.phases[phase].time += std::chrono::duration<double>(std::chrono::steady_clock::now() - phaseStartTime).count();
+		if (!counters.empty())
+			counters[phase]->Stop();
+		result.phases[phase].numUnits += numUnits;
+	};
+
+	std::vector<Action> actions;
+
+	for (int step = 0; step < config.warmupSteps + config.numSteps; step++) {
+		measuring = step >= config.warmupSteps;
+
+		for (int arenaIdx = 0; arenaIdx < numArenas; arenaIdx++) {
+			Arena* arena = envSet->arenas[arenaIdx];
+			auto& gs = state.gameStates[arenaIdx];
+			auto& gsPrev = state.prevGameStates[arenaIdx];
+			const int numPlayersInArena = gs.players.size();
+			ActionParser* actionParser = envSet->actionParsers[arenaIdx];
+
+			gsPrev = gs;
+			gs.ResetBeforeStep();
+
+			actions.resize(numPlayersInArena);
+			auto carItr = arena->_cars.begin();
+			for (int i = 0; i < numPlayersInArena; i++, carItr++) {
+				int actionIdx = envSet->rngs[arenaIdx].RandInt(0, actionParser->GetActionAmount());
+				actions[i] = actionParser->ParseAction(actionIdx, gs.players[i], gs);
+				(*carItr)->controls = (CarControls)actions[i];
+			}
+
+			fnStartPhase(PHASE_ARENA_STEP);
+			arena->Step(tickSkip);
+			fnEndPhase(PHASE_ARENA_STEP, tickSkip);
+
+			uint8_t terminalType = envSet->UpdateArenaState(arenaIdx, actions);
+
+			fnStartPhase(PHASE_REWARDS);
+			envSet->StepArenaRewards(arenaIdx, terminalType);
+			fnEndPhase(PHASE_REWARDS, envSet->rewards[arenaIdx].size() * numPlayersInArena);
+
+			fnStartPhase(PHASE_OBS);
+			envSet->BuildArenaObs(arenaIdx);
+			fnEndPhase(PHASE_OBS, numPlayersInArena);
+		}
+
+		envSet->Reset();
+	}
+
+	for (int i = 0; i < PHASE_AMOUNT; i++) {
+		if (!counters.empty()) {
+			result.phases[i].counters = counters[i]->Read();
+		} else {
+			for (auto& count : result.phases[i].counters.counts)
+				count = -1;
+		}
+	}
+
+	return result;
+}
+
+static std::string EscapeJSON(const std::string& str) {
+	std::string result = {};
+	for (char c : str) {
+		if (c == '"' || c == '\\') {
+			result += '\\';
+			result += c;
+		} else if ((unsigned char)c >= 0x20) {
+			result += c;
+		}
+	}
+	return result;
+}
+
+std::string RLGC::EnvSetBenchmarkResult::ToJSON() const {
+	std::stringstream stream;
+	stream << std::setprecision(10);
+
+	stream << "{\n";
+	stream << "\t\"num_arenas\": " << numArenas << ",\n";
+	stream << "\t\"num_players\": " << numPlayers << ",\n";
+	stream << "\t\"tick_skip\": " << tickSkip << ",\n";
+	stream << "\t\"num_steps\": " << numSteps << ",\n";
+	stream << "\t\"perf_counter_error\": " << (perfCounterError.empty() ? "null" : "\"" + EscapeJSON(perfCounterError) + "\"") << ",\n";
+	stream << "\t\"phases\": {";
+
+	for (size_t i = 0; i < phases.size(); i++) {
+		const Phase& phase = phases[i];
+		double numUnits = RS_MAX(phase.numUnits, 1);
+
+		stream << (i > 0 ? "," : "") << "\n\t\t\"" << phase.name << "\": {\n";
+		stream << "\t\t\t\"unit\": \"" << phase.unitName << "\",\n";
+		stream << "\t\t\t\"num_units\": " << phase.numUnits << ",\n";
+		stream << "\t\t\t\"time\": " << phase.time << ",\n";
+		stream << "\t\t\t\"ns_per_unit\": " << (phase.time * 1e9 / numUnits) << ",\n";
+
+		// Totals and per-unit values, null if the counter wasn't available
+		std::stringstream totals, perUnit;
+		totals << std::setprecision(10);
+		perUnit << std::setprecision(10);
+		for (int j = 0; j < PerfCounters::COUNTER_AMOUNT; j++) {
+			const char* sep = (j > 0) ? ", " : "";
+			int64_t count = phase.counters.counts[j];
+			totals << sep << "\"" << PerfCounters::COUNTER_NAMES[j] << "\": ";
+			perUnit << sep << "\"" << PerfCounters::COUNTER_NAMES[j] << "\": ";
+			if (count >= 0) {
+				totals << count;
+				perUnit << (count / numUnits);
+			} else {
+				totals << "null";
+				perUnit << "null";
+			}
+		}
+
+		int64_t cycles = phase.counters[PerfCounters::CYCLES], instructions = phase.counters[PerfCounters::INSTRUCTIONS];
+		stream << "\t\t\t\"counters\": { " << totals.str() << " },\n";
+		stream << "\t\t\t\"per_unit\": { " << perUnit.str() << " },\n";
+		stream << "\t\t\t\"ipc\": ";
+		if (cycles > 0 && instructions >= 0) {
+			stream << ((double)instructions / cycles);
+		} else {
+			stream << "null";
+		}
+		stream << "\n\t\t}";
+	}
+
+	stream << "\n\t}\n}\n";
+	return stream.str();
+}
+
+void RLGC::EnvSetBenchmarkResult::WriteJSON(std::filesystem::path path) const {
+	std::ofstream fileOut(path);
+	if (!fileOut.good())
+		RG_ERR_CLOSE("EnvSetBenchmarkResult::WriteJSON(): Failed to open " << path);
+	fileOut << ToJSON();
+}
+
+// Steps an env set with random actions, resetting arenas that were terminal
+static void StepRandom(EnvSet* envSet, IList& actionIndices) {
+	auto& state = envSet->state;
+	actionIndices.resize(state.numPlayers);
+	for (int i = 0; i < state.numPlayers; i++)
+		actionIndices[i] = envSet->rngs[state.playerArenaIdx[i]].RandInt(0, envSet->numActions);
+
+	envSet->Reset();
+	envSet->StepFirstHalf(false);
+	envSet->StepSecondHalf(actionIndices, false);
+}
+
+RLGC::FeatureCacheBenchmarkResult RLGC::RunFeatureCacheBenchmark(EnvSet* envSet, int numSteps) {
+	FeatureCacheBenchmarkResult result = {};
+	result.numSteps = numSteps;
+
+	auto& state = envSet->state;
+	const int obsSize = envSet->obsSize;
+
+	IList actionIndices;
+	FList outputs[2];
+	StateFeatures features = {};
+
+	for (int step = 0; step < numSteps; step++) {
+		StepRandom(envSet, actionIndices);
+
+		for (int arenaIdx = 0; arenaIdx < (int)envSet->arenas.size(); arenaIdx++) {
+			GameState& gs = state.gameStates[arenaIdx];
+			ObsBuilder* obsBuilder = envSet->obsBuilders[arenaIdx];
+			auto& rewards = envSet->rewards[arenaIdx];
+			const int numPlayers = gs.players.size();
+			const bool isFinal = state.terminals[arenaIdx] != TerminalType::NOT_TERMINAL;
+
+			auto start = std::chrono::steady_clock::now();
+			features.Compute(gs);
+			result.computeTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			for (auto& weighted : rewards)
+				weighted.reward->PreStep(gs);
+
+			for (int pass = 0; pass < 2; pass++) {
+				bool recompute = (pass == 1);
+				FList& output = outputs[pass];
+				output.resize((size_t)numPlayers * (obsSize + rewards.size()));
+				float* rewardOutput = output.data() + (size_t)numPlayers * obsSize;
+
+				gs._featuresValid = false;
+				start = std::chrono::steady_clock::now();
+				for (int i = 0; i < numPlayers; i++) {
+					if (recompute)
+						gs._featuresValid = false;
+					obsBuilder->BuildObsInto(gs.players[i], gs, output.data() + (size_t)i * obsSize, obsSize);
+				}
+				for (size_t j = 0; j < rewards.size(); j++) {
+					if (recompute)
+						gs._featuresValid = false;
+					rewards[j].reward->GetAllRewardsInPlace(gs, isFinal, rewardOutput + j * numPlayers);
+				}
+				double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				(recompute ? result.recomputeTime : result.cachedTime) += time;
+			}
+
+			if (memcmp(outputs[0].data(), outputs[1].data(), outputs[0].size() * sizeof(float)) != 0)
+				result.outputsMatch = false;
+
+			result.numArenaSteps++;
+			result.numPlayerSteps += numPlayers;
+		}
+	}
+
+	return result;
+}
+
+std::string RLGC::FeatureCacheBenchmarkResult::ToString() const {
+	double numArenas = RS_MAX(numArenaSteps, 1), numPlayers = RS_MAX(numPlayerSteps, 1);
+
+	std::stringstream stream;
+	stream << std::fixed << std::setprecision(1);
+	stream << "Feature cache benchmark (" << numSteps << " steps, " << numPlayerSteps << " player steps):\n";
+	stream << "\tStateFeatures::Compute(): " << (computeTime * 1e9 / numArenas) << "ns per arena step\n";
+	stream << "\tObs + rewards, cached: " << (cachedTime * 1e9 / numPlayers) << "ns per player\n";
+	stream << "\tObs + rewards, recomputed every call: " << (recomputeTime * 1e9 / numPlayers) << "ns per player\n";
+	stream << "\tOutputs " << (outputsMatch ? "matched" : "DID NOT MATCH") << "\n";
+	return stream.str();
+}
+
+// Reference frame stack, keeps a vector of past obs per player and concatenates them every build
+// Same output as FrameStackObs
+struct NaiveFrameStack {
+	ObsBuilder* inner;
+	int numFrames, stride;
+	std::vector<std::deque<FList>> playerHistories;
+
+	NaiveFrameStack(ObsBuilder* inner, int numFrames, int stride) : inner(inner), numFrames(numFrames), stride(stride) {}
+	RG_NO_COPY(NaiveFrameStack);
+	~NaiveFrameStack() {
+		delete inner;
+	}
+
+	void Reset(const GameState& initialState) {
+		inner->Reset(initialState);
+		playerHistories.assign(initialState.players.size(), {});
+	}
+
+	FList BuildObs(const Player& player, const GameState& state) {
+		auto& history = playerHistories[player.index];
+		size_t historyLen = (size_t)(numFrames - 1) * stride + 1;
+
+		FList obs = inner->BuildObs(player, state);
+		if (history.empty()) {
+			history.assign(historyLen, obs);
+		} else {
+			history.push_front(obs);
+			history.pop_back();
+		}
+
+		FList result = {};
+		for (int i = 0; i < numFrames; i++)
+			result.insert(result.end(), history[(size_t)i * stride].begin(), history[(size_t)i * stride].end());
+		return result;
+	}
+};
+
+RLGC::FrameStackBenchmarkResult RLGC::RunFrameStackBenchmark(
+	EnvSet* envSet, std::function<ObsBuilder*()> innerCreateFn,
+	const std::vector<std::pair<int, int>>& framesAndStrides, int numSteps) {
+
+	FrameStackBenchmarkResult result = {};
+	result.numSteps = numSteps;
+
+	auto& state = envSet->state;
+	const int numArenas = envSet->arenas.size();
+
+	struct ArenaBuilders {
+		std::unique_ptr<ObsBuilder> inner;
+		std::vector<std::unique_ptr<NaiveFrameStack>> naive;
+		std::vector<std::unique_ptr<FrameStackObs>> ring;
+	};
+	std::vector<ArenaBuilders> arenaBuilders(numArenas);
+	for (int arenaIdx = 0; arenaIdx < numArenas; arenaIdx++) {
+		auto& builders = arenaBuilders[arenaIdx];
+		builders.inner.reset(innerCreateFn());
+		for (auto& pair : framesAndStrides) {
+			builders.naive.push_back(std::make_unique<NaiveFrameStack>(innerCreateFn(), pair.first, pair.second));
+			builders.ring.push_back(std::make_unique<FrameStackObs>(innerCreateFn(), pair.first, pair.second));
+		}
+	}
+
+	for (auto& pair : framesAndStrides) {
+		FrameStackBenchmarkResult::Row row = {};
+		row.numFrames = pair.first;
+		row.stride = pair.second;
+		result.rows.push_back(row);
+	}
+
+	auto fnResetBuilders = [&](int arenaIdx) {
+		auto& builders = arenaBuilders[arenaIdx];
+		const GameState& gs = state.gameStates[arenaIdx];
+		builders.inner->Reset(gs);
+		for (size_t i = 0; i < framesAndStrides.size(); i++) {
+			builders.naive[i]->Reset(gs);
+			builders.ring[i]->Reset(gs);
+		}
+	};
+	for (int arenaIdx = 0; arenaIdx < numArenas; arenaIdx++)
+		fnResetBuilders(arenaIdx);
+
+	IList actionIndices;
+	FList ringOutput;
+	std::vector<uint8_t> wasTerminal;
+
+	for (int step = 0; step < numSteps; step++) {
+		wasTerminal = state.terminals;
+		StepRandom(envSet, actionIndices);
+
+		for (int arenaIdx = 0; arenaIdx < numArenas; arenaIdx++) {
+			if (wasTerminal[arenaIdx])
+				fnResetBuilders(arenaIdx);
+
+			auto& builders = arenaBuilders[arenaIdx];
+			const GameState& gs = state.gameStates[arenaIdx];
+
+			auto start = std::chrono::steady_clock::now();
+			for (auto& player : gs.players)
+				builders.inner->BuildObs(player, gs);
+			double innerTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			for (size_t i = 0; i < framesAndStrides.size(); i++) {
+				auto& row = result.rows[i];
+				row.innerTime += innerTime;
+
+				for (auto& player : gs.players) {
+					start = std::chrono::steady_clock::now();
+					FList naiveOutput = builders.naive[i]->BuildObs(player, gs);
+					auto mid = std::chrono::steady_clock::now();
+
+					ringOutput.resize(naiveOutput.size());
+					builders.ring[i]->BuildObsInto(player, gs, ringOutput.data(), ringOutput.size());
+					auto end = std::chrono::steady_clock::now();
+
+					row.naiveTime += std::chrono::duration<double>(mid - start).count();
+					row.ringTime += std::chrono::duration<double>(end - mid).count();
+					if (ringOutput != naiveOutput)
+						row.outputsMatch = false;
+				}
+
+				row.historyBytesPerPlayer = builders.ring[i]->GetHistoryBytesPerPlayer();
+			}
+
+			result.numObs += gs.players.size();
+		}
+	}
+
+	return result;
+}
+
+std::string RLGC::FrameStackBenchmarkResult::ToString() const {
+	double num = RS_MAX(numObs, 1);
+
+	std::stringstream stream;
+	stream << std::fixed << std::setprecision(1);
+	stream << "Frame stack benchmark (" << numSteps << " steps, " << numObs << " obs per builder), ns per obs:\n";
+	stream << "\tframes/stride\tinner\tnaive\tring\thistory/player\n";
+	for (auto& row : rows) {
+		stream << "\t" << row.numFrames << " / " << row.stride << "\t\t";
+		stream << (row.innerTime * 1e9 / num) << "\t" << (row.naiveTime * 1e9 / num) << "\t" << (row.ringTime * 1e9 / num) << "\t";
+		stream << row.historyBytesPerPlayer << " B";
+		if (!row.outputsMatch)
+			stream << " (OUTPUT DID NOT MATCH)";
+		stream << "\n";
+	}
+	return stream.str();
+}
+
+RLGC::ArenaCloneBenchmarkResult RLGC::RunArenaCloneBenchmark(EnvSet* envSet, int numClones, int rolloutTicks) {
+	ArenaCloneBenchmarkResult result = {};
+	result.numClones = numClones;
+	result.rolloutTicks = rolloutTicks;
+
+	const int numArenas = envSet->arenas.size();
+	auto fnTimeEach = [&](auto fn) {
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < numClones; i++)
+			fn(envSet->arenas[i % numArenas]);
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / RS_MAX(numClones, 1);
+	};
+
+	ArenaClonePool pool = {};
+	pool.Reserve(envSet->arenas[0], 1);
+
+	result.createTime = fnTimeEach([](Arena* source) { delete Arena::Create(source->gameMode, source->GetArenaConfig(), source->GetTickRate()); });
+	result.createLikeTime = fnTimeEach([](Arena* source) { delete Arena::CreateLike(source); });
+	result.cloneTime = fnTimeEach([](Arena* source) { delete source->Clone(false); });
+	result.acquireTime = fnTimeEach([&](Arena* source) { pool.Release(pool.Acquire(source)); });
+
+	{ // Car IDs with gaps, that also don't start right after the copy's last car ID
+		Arena* source = Arena::CreateLike(envSet->arenas[0]);
+		for (int i = 0; i < 4; i++)
+			source->AddCar((i % 2) ? Team::ORANGE : Team::BLUE);
+		source->RemoveCar(1);
+		source->RemoveCar(3);
+		source->AddCar(Team::BLUE); // IDs are now 2, 4, 5
+
+		auto fnCheckCopy = [&](Arena* copy) {
+			bool matched = copy->_cars.size() == source->_cars.size() && copy->_carIDMap.size() == source->_carIDMap.size();
+			for (size_t i = 0; i < copy->_cars.size() && matched; i++) {
+				Car* car = copy->_cars[i];
+				matched = car->id == source->_cars[i]->id && car->team == source->_cars[i]->team && copy->GetCar(car->id) == car;
+			}
+
+			if (matched) {
+				Car* newCar = copy->AddCar(Team::ORANGE);
+				matched = newCar->id > source->_lastCarID;
+				copy->RemoveCar(newCar);
+			}
+
+			if (!matched)
+				result.carIDsMatched = false;
+		};
+
+		Arena* clone = source->Clone(false);
+		fnCheckCopy(clone);
+		delete clone;
+
+		Arena* copied = Arena::CreateLike(source);
+		copied->CopyStateFrom(source, false);
+		fnCheckCopy(copied);
+		delete copied;
+
+		DataStreamOut out = {};
+		source->Serialize(out);
+		DataStreamIn in = {};
+		in.data = out.data;
+		Arena* deserialized = Arena::DeserializeNew(in);
+		fnCheckCopy(deserialized);
+		delete deserialized;
+
+		// The pool's arena already has the env set's cars
+		ArenaClonePool idPool = {};
+		idPool.Release(idPool.Acquire(envSet->arenas[0]));
+		Arena* pooled = idPool.Acquire(source);
+		fnCheckCopy(pooled);
+		idPool.Release(pooled);
+
+		delete source;
+	}
+
+	RNG rng = RNG(envSet->config.randomSeed);
+	for (int i = 0; i < numClones; i++) {
+		Arena* source = envSet->arenas[i % numArenas];
+
+		Arena* fresh = Arena::Create(source->gameMode, source->GetArenaConfig(), source->GetTickRate());
+		fresh->CopyStateFrom(source, false);
+		Arena* pooled = pool.Acquire(source);
+
+		for (int tick = 0; tick < rolloutTicks; tick++) {
+			for (size_t carIdx = 0; carIdx < fresh->_cars.size(); carIdx++) {
+				CarControls controls = {};
+				controls.throttle = rng.RandFloat(-1, 1);
+				controls.steer = rng.RandFloat(-1, 1);
+				controls.pitch = rng.RandFloat(-1, 1);
+				controls.yaw = rng.RandFloat(-1, 1);
+				controls.roll = rng.RandFloat(-1, 1);
+				controls.jump = rng.RandInt(0, 2);
+				controls.boost = rng.RandInt(0, 2);
+				controls.handbrake = rng.RandInt(0, 2);
+
+				fresh->_cars[carIdx]->controls = controls;
+				pooled->_cars[carIdx]->controls = controls;
+			}
+
+			fresh->Step();
+			pooled->Step();
+		}
+
+		DataStreamOut freshOut = {}, pooledOut = {};
+		fresh->Serialize(freshOut);
+		pooled->Serialize(pooledOut);
+		if (freshOut.data == pooledOut.data)
+			result.numMatched++;
+
+		delete fresh;
+		pool.Release(pooled);
+	}
+
+	return result;
+}
+
+std::string RLGC::ArenaCloneBenchmarkResult::ToString() const {
+	std::stringstream stream;
+	stream << std::fixed << std::setprecision(1);
+	stream << "Arena clone benchmark (" << numClones << " clones), us per arena:\n";
+	stream << "\tArena::Create(): " << (createTime * 1e6) << "\n";
+	stream << "\tArena::CreateLike(): " << (createLikeTime * 1e6) << "\n";
+	stream << "\tArena::Clone(): " << (cloneTime * 1e6) << "\n";
+	stream << "\tArenaClonePool::Acquire() + Release(): " << (acquireTime * 1e6) << "\n";
+	stream << "\tPooled rollouts matching fresh ones (" << rolloutTicks << " ticks): " << numMatched << "/" << numClones << "\n";
+	stream << "\tCar IDs with gaps " << (carIDsMatched ? "copied correctly" : "WERE NOT COPIED CORRECTLY") << "\n";
+	return stream.str();
+}
+
+// Contacts between a car or the ball and an arena mesh triangle, as the narrowphase adds them
+// Recorded from the contact added callback, since the manifolds only keep 4 contacts per pair, and which ones depends on their order
+struct NarrowphaseContact {
+	btVector3 point; // On the arena mesh, in uu
+	btVector3 normal; // Pointing from the arena mesh to the car or ball
+	float distance; // Uu, negative if penetrating
+};
+typedef std::tuple<int, int, int> NarrowphaseContactKey; // Car index (-1 for the ball), arena mesh index, triangle index
+static Arena* g_NarrowphaseRecordArena = NULL;
+static std::map<NarrowphaseContactKey, NarrowphaseContact> g_NarrowphaseContacts = {};
+
+static bool NarrowphaseRecordContactCallback(
+	btManifoldPoint& contactPoint,
+	const btCollisionObjectWrapper* objA, int partID_A, int indexA,
+	const btCollisionObjectWrapper* objB, int partID_B, int indexB) {
+
+	bool result = Arena::_BulletContactAddedCallback(contactPoint, objA, partID_A, indexA, objB, partID_B, indexB);
+
+	Arena* arena = g_NarrowphaseRecordArena;
+	const btCollisionObject* bodies[2] = { objA->m_collisionObject, objB->m_collisionObject };
+	int indices[2] = { indexA, indexB };
+	int meshIdx = -1, dynamicIdx = -2, triIdx = -1;
+	bool meshIsB = false;
+	for (int i = 0; i < 2; i++) {
+		const btCollisionObject* body = bodies[i];
+		if (body >= arena->_worldCollisionRBs && body < arena->_worldCollisionRBs + arena->_worldCollisionRBAmount) {
+			if (body->getCollisionShape()->getShapeType() == TRIANGLE_MESH_SHAPE_PROXYTYPE) {
+				meshIdx = (const btRigidBody*)body - arena->_worldCollisionRBs;
+				triIdx = indices[i];
+				meshIsB = (i == 1);
+			}
+		} else if (body == &arena->ball->_rigidBody) {
+			dynamicIdx = -1;
+		} else {
+			for (size_t carIdx = 0; carIdx < arena->_cars.size(); carIdx++)
+				if (body == &arena->_cars[carIdx]->_rigidBody)
+					dynamicIdx = carIdx;
+		}
+	}
+
+	if (meshIdx != -1 && dynamicIdx != -2) {
+		g_NarrowphaseContacts[{ dynamicIdx, meshIdx, triIdx }] = {
+			(meshIsB ? contactPoint.m_positionWorldOnB : contactPoint.m_positionWorldOnA) * BT_TO_UU,
+			meshIsB ? contactPoint.m_normalWorldOnB : -contactPoint.m_normalWorldOnB,
+			contactPoint.getDistance() * BT_TO_UU
+		};
+	}
+
+	return result;
+}
+
+RLGC::NarrowphaseBenchmarkResult RLGC::RunNarrowphaseBenchmark(EnvSet* envSet, int numTicks, float pointTolerance, float normalTolerance, float maxDepth) {
+	NarrowphaseBenchmarkResult result = {};
+	result.numTicks = numTicks;
+	result.pointTolerance = pointTolerance;
+	result.normalTolerance = normalTolerance;
+	result.maxDepth = maxDepth;
+
+	Arena* envArena = envSet->arenas[0];
+	ArenaConfig defaultConfig = envArena->GetArenaConfig();
+	defaultConfig.useCustomBallNarrowphase = false;
+	defaultConfig.useCustomCarNarrowphase = false;
+	ArenaConfig customConfig = defaultConfig;
+	customConfig.useCustomBallNarrowphase = true;
+	customConfig.useCustomCarNarrowphase = true;
+
+	Arena* driver = Arena::Create(envArena->gameMode, defaultConfig, envArena->GetTickRate());
+	Arena* defaultArena = Arena::Create(envArena->gameMode, defaultConfig, envArena->GetTickRate());
+	Arena* customArena = Arena::Create(envArena->gameMode, customConfig, envArena->GetTickRate());
+	driver->CopyStateFrom(envArena, false);
+
+	// Starts over from the env's state setter every so often, so more kinds of situations get covered
+	constexpr int RESET_INTERVAL = 120;
+	StateSetter* stateSetter = envSet->stateSetters[0];
+
+	auto fnRandomizeControls = [](Arena* arena, RNG& rng) {
+		for (Car* car : arena->_cars) {
+			CarControls& controls = car->controls;
+			controls.throttle = rng.RandFloat(-1, 1);
+			controls.steer = rng.RandFloat(-1, 1);
+			controls.pitch = rng.RandFloat(-1, 1);
+			controls.yaw = rng.RandFloat(-1, 1);
+			controls.roll = rng.RandFloat(-1, 1);
+			controls.jump = rng.RandInt(0, 2);
+			controls.boost = rng.RandInt(0, 2);
+			controls.handbrake = rng.RandInt(0, 2);
+		}
+	};
+
+	// Finds the arena's contacts from its current state, and returns them along with the seconds it took to dispatch every pair
+	// The pairs are dispatched twice, and only the second time is timed, so that the algorithms and manifolds already exist like in a normal tick
+	auto fnFindContacts = [](Arena* arena, double& timeOut) {
+		btDiscreteDynamicsWorld& world = arena->_bulletWorld;
+		world.setWorldUserInfo(arena);
+		world.updateAabbs();
+		world.computeOverlappingPairs();
+
+		btCollisionDispatcher* dispatcher = &arena->_bulletWorldParams.collisionDispatcher;
+		btOverlappingPairCache* pairCache = world.getBroadphase()->getOverlappingPairCache();
+
+		g_NarrowphaseRecordArena = arena;
+		g_NarrowphaseContacts.clear();
+		gContactAddedCallback = &NarrowphaseRecordContactCallback;
+		dispatcher->dispatchAllCollisionPairs(pairCache, world.getDispatchInfo(), dispatcher);
+		gContactAddedCallback = &Arena::_BulletContactAddedCallback;
+
+		auto start = std::chrono::steady_clock::now();
+		dispatcher->dispatchAllCollisionPairs(pairCache, world.getDispatchInfo(), dispatcher);
+		timeOut += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		return std::move(g_NarrowphaseContacts);
+	};
+
+	RNG rng = RNG(envSet->config.randomSeed);
+	for (int tick = 0; tick < numTicks; tick++) {
+		if (tick % RESET_INTERVAL == 0)
+			stateSetter->ResetArena(driver, rng);
+
+		defaultArena->CopyStateFrom(driver, false);
+		customArena->CopyStateFrom(driver, false);
+		auto defaultContacts = fnFindContacts(defaultArena, result.defaultNarrowphaseTime);
+		auto customContacts = fnFindContacts(customArena, result.customNarrowphaseTime);
+
+		// Compare the contacts on each triangle that either narrowphase found to be penetrating
+		// Separated contacts are only within the contact breaking threshold, and don't push anything apart yet
+		auto fnCompare = [&](const NarrowphaseContactKey& key, const NarrowphaseContact* contact, const NarrowphaseContact* other) {
+			const NarrowphaseContact* deepest = (contact && (!other || contact->distance <= other->distance)) ? contact : other;
+			if (deepest->distance >= 0)
+				return;
+
+			NarrowphaseBenchmarkResult::ContactStats* stats;
+			if (std::get<0>(key) == -1) {
+				stats = &result.ballContacts;
+			} else if (-deepest->distance > maxDepth) {
+				stats = &result.deepCarContacts;
+			} else {
+				stats = &result.carContacts;
+			}
+
+			stats->numContacts++;
+			if (!contact || !other) {
+				(contact ? stats->numMissing : stats->numExtra)++;
+				return;
+			}
+
+			float pointDelta = contact->point.distance(other->point);
+			float normalDelta = (contact->normal - other->normal).length();
+			if (pointDelta <= pointTolerance && normalDelta <= normalTolerance)
+				stats->numWithinTolerance++;
+			stats->maxPointDelta = RS_MAX(stats->maxPointDelta, pointDelta);
+			stats->maxNormalDelta = RS_MAX(stats->maxNormalDelta, normalDelta);
+		};
+
+		for (auto& pair : defaultContacts) {
+			auto itr = customContacts.find(pair.first);
+			fnCompare(pair.first, &pair.second, (itr != customContacts.end()) ? &itr->second : NULL);
+		}
+		for (auto& pair : customContacts)
+			if (!defaultContacts.count(pair.first))
+				fnCompare(pair.first, NULL, &pair.second);
+
+		fnRandomizeControls(driver, rng);
+		driver->Step();
+	}
+
+	// Time full steps over the same rollout (they diverge after a while, but the situations stay similar)
+	for (Arena* arena : { defaultArena, customArena }) {
+		RNG stepRNG = RNG(envSet->config.randomSeed);
+		arena->CopyStateFrom(envArena, false);
+		double stepTime = 0;
+		for (int tick = 0; tick < numTicks; tick++) {
+			if (tick % RESET_INTERVAL == 0)
+				stateSetter->ResetArena(arena, stepRNG);
+
+			fnRandomizeControls(arena, stepRNG);
+			auto start = std::chrono::steady_clock::now();
+			arena->Step();
+			stepTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+		(arena == defaultArena ? result.defaultStepTime : result.customStepTime) = stepTime;
+	}
+
+	result.defaultNarrowphaseTime /= RS_MAX(numTicks, 1);
+	result.customNarrowphaseTime /= RS_MAX(numTicks, 1);
+	result.defaultStepTime /= RS_MAX(numTicks, 1);
+	result.customStepTime /= RS_MAX(numTicks, 1);
+
+	delete driver;
+	delete defaultArena;
+	delete customArena;
+	return result;
+}
+
+std::string RLGC::NarrowphaseBenchmarkResult::ToString() const {
+	std::stringstream stream;
+	stream << std::fixed << std::setprecision(2);
+	stream << "Narrowphase benchmark (" << numTicks << " ticks), us per tick (default -> custom):\n";
+	stream << "\tNarrowphase: " << (defaultNarrowphaseTime * 1e6) << " -> " << (customNarrowphaseTime * 1e6) << "\n";
+	stream << "\tArena::Step(): " << (defaultStepTime * 1e6) << " -> " << (customStepTime * 1e6) << "\n";
+	stream << "Penetrating contacts within tolerance (" << pointTolerance << "uu, " << normalTolerance << " normal):\n";
+
+	auto fnWriteStats = [&](const char* name, const ContactStats& stats) {
+		stream << "\t" << name << ": " << stats.numWithinTolerance << "/" << stats.numContacts;
+		if (stats.numMissing || stats.numExtra)
+			stream << " (" << stats.numMissing << " MISSING, " << stats.numExtra << " EXTRA)";
+		stream << ", max point delta: " << stats.maxPointDelta << "uu, max normal delta: " << stats.maxNormalDelta << "\n";
+	};
+	fnWriteStats("Ball", ballContacts);
+	fnWriteStats("Car", carContacts);
+	fnWriteStats(("Car, deeper than " + RS_STR(maxDepth) + "uu (not checked)").c_str(), deepCarContacts);
+
+	stream << (Passed() ? "PASSED" : "FAILED") << "\n";
+	return stream.str();
+}
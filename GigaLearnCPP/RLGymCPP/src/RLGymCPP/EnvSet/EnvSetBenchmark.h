@@ -0,0 +1,143 @@
+#pragma once
+#include "EnvSet.h"
+#include "../PerfCounters.h"
+#include "../ObsBuilders/FrameStackObs.h"
+
+namespace RLGC {
+	struct EnvSetBenchmarkConfig {
+		int numSteps = 500; // Env steps to measure, each steps every arena by tickSkip ticks
+		int warmupSteps = 50;
+		bool usePerfCounters = true; // Read hardware counters (see PerfCounters)
+	};
+
+	struct EnvSetBenchmarkResult {
+		struct Phase {
+			std::string name;
+			std::string unitName; // What the per-unit numbers are normalized by
+			uint64_t numUnits = 0;
+			double time = 0; // Seconds
+			PerfCounters::Values counters = {};
+		};
+
+		// "arena_step": Arena::Step(), per arena tick
+		// "rewards": EnvSet::StepArenaRewards(), per reward call (one reward function for one player)
+		// "obs": EnvSet::BuildArenaObs(), obs and action mask per row
+		std::vector<Phase> phases;
+
+		int numArenas = 0, numPlayers = 0, tickSkip = 0, numSteps = 0;
+		std::string perfCounterError = {}; // Empty if every counter was available
+
+		std::string ToJSON() const;
+		void WriteJSON(std::filesystem::path path) const;
+	};
+
+	// Steps every arena of the env set on the calling thread, timing each part of the step separately
+	// Actions are random, arenas are reset as usual when terminal
+	// Batched rewards aren't included
+	EnvSetBenchmarkResult RunEnvSetBenchmark(EnvSet* envSet, const EnvSetBenchmarkConfig& config = {});
+
+	struct FeatureCacheBenchmarkResult {
+		int numSteps = 0;
+		uint64_t numArenaSteps = 0, numPlayerSteps = 0;
+
+		double computeTime = 0; // StateFeatures::Compute() alone, once per arena step
+		double cachedTime = 0; // Obs and rewards with the cache computed once per step (as in training)
+		double recomputeTime = 0; // Obs and rewards with the cache invalidated before every obs build and reward call
+
+		bool outputsMatch = true; // Whether the obs and rewards were identical with and without recomputing
+
+		std::string ToString() const;
+	};
+
+	// Times every arena's obs builder and rewards on the env set's states, with and without the GameState feature cache (see GameState::GetFeatures())
+	// Recomputing before every call is an upper bound for code that doesn't share the cache, as each call computes every player's features
+	// NOTE: Obs builders and rewards are called twice per step, so stateful ones will see every step twice
+	FeatureCacheBenchmarkResult RunFeatureCacheBenchmark(EnvSet* envSet, int numSteps = 300);
+
+	struct FrameStackBenchmarkResult {
+		struct Row {
+			int numFrames, stride;
+			double innerTime = 0; // The inner obs builder alone
+			double naiveTime = 0; // A vector of past obs per player, concatenated every build
+			double ringTime = 0; // FrameStackObs
+			size_t historyBytesPerPlayer = 0; // Of FrameStackObs
+			bool outputsMatch = true; // Whether FrameStackObs matched the naive version
+		};
+
+		int numSteps = 0;
+		uint64_t numObs = 0; // Obs built per builder
+		std::vector<Row> rows;
+
+		std::string ToString() const;
+	};
+
+	// Steps the env set and builds every player's obs with a fresh inner obs builder alone, the naive frame stack, and FrameStackObs
+	// Each builder gets its own inner obs builder from innerCreateFn for each arena, so stateful inner builders are fine
+	FrameStackBenchmarkResult RunFrameStackBenchmark(
+		EnvSet* envSet, std::function<ObsBuilder*()> innerCreateFn,
+		const std::vector<std::pair<int, int>>& framesAndStrides = { { 4, 1 }, { 4, 4 }, { 8, 1 }, { 8, 4 } }, int numSteps = 200
+	);
+
+	struct ArenaCloneBenchmarkResult {
+		int numClones = 0, rolloutTicks = 0;
+
+		// Seconds per arena
+		double createTime = 0; // Arena::Create()
+		double createLikeTime = 0; // Arena::CreateLike(), which ArenaClonePool uses for new arenas
+		double cloneTime = 0; // Arena::Clone()
+		double acquireTime = 0; // ArenaClonePool::Acquire() and Release(), with a free arena in the pool
+
+		int numMatched = 0; // Pooled rollouts that ended identical to the same rollout from a fresh Create() + CopyStateFrom() arena
+
+		// Whether every way of copying kept the cars and their IDs when the source's car IDs had gaps,
+		//	and the copy's next AddCar() didn't reuse one of them
+		bool carIDsMatched = true;
+
+		std::string ToString() const;
+	};
+
+	// Times the ways of copying the env set's arenas, then checks that pooled copies simulate exactly like freshly created ones
+	// Each rollout steps both copies for rolloutTicks with the same random controls, then compares their serialized states
+	// Also checks copying an arena whose car IDs aren't contiguous (see carIDsMatched)
+	ArenaCloneBenchmarkResult RunArenaCloneBenchmark(EnvSet* envSet, int numClones = 200, int rolloutTicks = 120);
+
+	struct NarrowphaseBenchmarkResult {
+		int numTicks = 0;
+		float pointTolerance = 0, normalTolerance = 0, maxDepth = 0;
+
+		// Seconds per tick, for the default (Bullet) narrowphase and the custom one (ArenaConfig::useCustomBallNarrowphase and useCustomCarNarrowphase)
+		double defaultNarrowphaseTime = 0, customNarrowphaseTime = 0; // Dispatching every overlapping pair once
+		double defaultStepTime = 0, customStepTime = 0; // Arena::Step()
+
+		// Contacts between a car or the ball and an arena mesh triangle, that either narrowphase found to be penetrating
+		// Each default contact is compared to the custom contact on the same triangle
+		struct ContactStats {
+			uint64_t numContacts = 0;
+			uint64_t numWithinTolerance = 0;
+			uint64_t numMissing = 0; // Only the default narrowphase had a contact on that triangle
+			uint64_t numExtra = 0; // Only the custom narrowphase had a contact on that triangle
+			float maxPointDelta = 0; // Uu
+			float maxNormalDelta = 0; // Length of the difference between the normals
+
+			bool AllWithinTolerance() const {
+				return numWithinTolerance == numContacts;
+			}
+		};
+		ContactStats ballContacts, carContacts;
+
+		// Car contacts deeper than maxDepth are only reported, as GJK/EPA and the box test can settle on different faces once a car is that far in
+		ContactStats deepCarContacts;
+
+		bool Passed() const {
+			return ballContacts.AllWithinTolerance() && carContacts.AllWithinTolerance();
+		}
+
+		std::string ToString() const;
+	};
+
+	// Runs the same scenario with the custom narrowphases on and off, and compares their contacts against the arena meshes
+	// Every tick, the state of a randomly-driven arena is copied into one arena of each kind, which then each find their contacts once
+	// Also times the narrowphase and full steps of each over the same rollout
+	NarrowphaseBenchmarkResult RunNarrowphaseBenchmark(
+		EnvSet* envSet, int numTicks = 5000, float pointTolerance = 1.f, float normalTolerance = 0.01f, float maxDepth = 4.f);
+}
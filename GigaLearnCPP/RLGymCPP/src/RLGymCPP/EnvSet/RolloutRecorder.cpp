@@ -0,0 +1,225 @@
+#include "RolloutRecorder.h"
+
+using namespace RLGC;
+
+static uint64_t HashBytes(const void* data, size_t size, uint64_t hash) {
+	// FNV-1a over 8-byte words, then the leftover bytes
+	constexpr uint64_t PRIME = 0x100000001B3ull;
+	const uint8_t* bytes = (const uint8_t*)data;
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8) {
+		uint64_t word;
+		memcpy(&word, bytes + i, 8);
+		hash = (hash ^ word) * PRIME;
+	}
+	for (; i < size; i++)
+		hash = (hash ^ bytes[i]) * PRIME;
+	return RNG::Mix(hash);
+}
+
+constexpr uint64_t HASH_START = 0xCBF29CE484222325ull;
+
+uint64_t RLGC::RolloutRecorder::HashObs(const EnvState& state) {
+	uint64_t hash = HashBytes(state.obs.data.data(), state.obs.data.size() * sizeof(float), HASH_START);
+	return HashBytes(state.actionMasks.data.data(), state.actionMasks.data.size(), hash);
+}
+
+uint64_t RLGC::RolloutRecorder::HashResult(const EnvState& state) {
+	uint64_t hash = HashBytes(state.rewards.data(), state.rewards.size() * sizeof(float), HASH_START);
+	return HashBytes(state.terminals.data(), state.terminals.size(), hash);
+}
+
+template <typename T>
+static void WriteVal(std::ofstream& out, const T& val) {
+	out.write((const char*)&val, sizeof(T));
+}
+
+template <typename T>
+static void ReadVal(std::ifstream& in, T& val) {
+	in.read((char*)&val, sizeof(T));
+}
+
+RLGC::RolloutRecorder::RolloutRecorder(std::filesystem::path path, const EnvSet* envSet) : path(path) {
+	// Every step before the window is re-stepped to replay it, so there must be no steps we don't have
+	if (envSet->stepCount > 0)
+		RG_ERR_CLOSE("RolloutRecorder: Must be made before the env set's first step (it has taken " << envSet->stepCount << ")");
+
+	if (path.has_parent_path())
+		std::filesystem::create_directories(path.parent_path());
+
+	fileOut = std::ofstream(path, std::ios::binary);
+	if (!fileOut.good())
+		RG_ERR_CLOSE("RolloutRecorder: Failed to open " << path);
+
+	auto& state = envSet->state;
+	auto& config = envSet->config;
+
+	// Actions are stored as uint16
+	if (envSet->numActions > UINT16_MAX + 1)
+		RG_ERR_CLOSE("RolloutRecorder: Too many actions to record (" << envSet->numActions << ")");
+
+	memcpy(header.magic, RolloutFileHeader::MAGIC, sizeof(header.magic));
+	header.version = RolloutFileHeader::VERSION;
+	header.numArenas = envSet->arenas.size();
+	header.numPlayers = state.numPlayers;
+	header.obsSize = envSet->obsSize;
+	header.numActions = envSet->numActions;
+	header.tickSkip = config.tickSkip;
+	header.actionDelay = config.actionDelay;
+	header.randomSeed = config.randomSeed;
+	header.ballPredNumStates = config.ballPredNumStates;
+	header.ballPredTickInterval = config.ballPredTickInterval;
+	header.saveRewards = config.saveRewards;
+	header.shuffleRewardSampling = config.shuffleRewardSampling;
+	header.numBatchedRewards = config.batchedRewards.size();
+	header.windowStartStep = 0;
+	WriteVal(fileOut, header);
+
+	if (!fileOut.good())
+		RG_ERR_CLOSE("RolloutRecorder: Failed to write to " << path);
+
+	RG_LOG("RolloutRecorder: Recording " << header.numArenas << " arenas to " << path);
+}
+
+void RLGC::RolloutRecorder::StartWindow() {
+	header.windowStartStep = numSteps;
+
+	// Rewrite the header now, so the window is kept even if we never get to Close()
+	std::streampos endPos = fileOut.tellp();
+	fileOut.seekp(0);
+	WriteVal(fileOut, header);
+	fileOut.seekp(endPos);
+
+	if (!fileOut.good())
+		RG_ERR_CLOSE("RolloutRecorder: Failed to write to " << path);
+
+	RG_LOG("RolloutRecorder: Window starts at step " << numSteps);
+}
+
+void RLGC::RolloutRecorder::RecordObs(const EnvSet* envSet) {
+	obsHash = HashObs(envSet->state);
+}
+
+void RLGC::RolloutRecorder::RecordStep(const EnvSet* envSet, const IList& actionIndices) {
+	RG_ASSERT(actionIndices.size() == header.numPlayers);
+
+	actionsBuffer.resize(actionIndices.size());
+	for (int i = 0; i < actionIndices.size(); i++)
+		actionsBuffer[i] = (uint16_t)actionIndices[i];
+
+	WriteVal(fileOut, obsHash);
+	WriteVal(fileOut, HashResult(envSet->state));
+	fileOut.write((const char*)actionsBuffer.data(), actionsBuffer.size() * sizeof(uint16_t));
+	numSteps++;
+}
+
+void RLGC::RolloutRecorder::Close() {
+	if (!fileOut.is_open())
+		return;
+
+	fileOut.close();
+	RG_LOG("RolloutRecorder: Recorded " << numSteps << " steps to " << path);
+}
+
+/////////////////////////////
+
+static RolloutFileHeader ReadRolloutHeader(std::ifstream& in, std::filesystem::path path) {
+	RolloutFileHeader header = {};
+	ReadVal(in, header);
+	if (!in.good() || memcmp(header.magic, RolloutFileHeader::MAGIC, sizeof(header.magic)) != 0)
+		RG_ERR_CLOSE("Rollout file " << path << " is invalid");
+	if (header.version != RolloutFileHeader::VERSION)
+		RG_ERR_CLOSE("Rollout file " << path << " has version " << header.version << ", expected " << RolloutFileHeader::VERSION);
+	return header;
+}
+
+RLGC::EnvSetConfig RLGC::MakeRolloutEnvSetConfig(std::filesystem::path path, EnvCreateFn envCreateFn) {
+	std::ifstream fileIn(path, std::ios::binary);
+	if (!fileIn.good())
+		RG_ERR_CLOSE("MakeRolloutEnvSetConfig(): Failed to open " << path);
+	RolloutFileHeader header = ReadRolloutHeader(fileIn, path);
+
+	EnvSetConfig config = {};
+	config.envCreateFn = envCreateFn;
+	config.numArenas = header.numArenas;
+	config.tickSkip = header.tickSkip;
+	config.actionDelay = header.actionDelay;
+	config.randomSeed = header.randomSeed;
+	config.ballPredNumStates = header.ballPredNumStates;
+	config.ballPredTickInterval = header.ballPredTickInterval;
+	config.saveRewards = header.saveRewards;
+	config.shuffleRewardSampling = header.shuffleRewardSampling;
+	return config;
+}
+
+RLGC::RolloutReplayResult RLGC::ReplayRollout(EnvSet* envSet, std::filesystem::path path) {
+	std::ifstream fileIn(path, std::ios::binary);
+	if (!fileIn.good())
+		RG_ERR_CLOSE("ReplayRollout(): Failed to open " << path);
+	RolloutFileHeader header = ReadRolloutHeader(fileIn, path);
+
+	auto& state = envSet->state;
+	if (
+		header.numArenas != envSet->arenas.size() || header.numPlayers != state.numPlayers ||
+		header.obsSize != envSet->obsSize || header.numActions != envSet->numActions ||
+		header.numBatchedRewards != envSet->config.batchedRewards.size()
+		) {
+		RG_ERR_CLOSE(
+			"ReplayRollout(): Env set doesn't match the recording "
+			"(arenas: " << envSet->arenas.size() << " vs " << header.numArenas << ", players: " << state.numPlayers << " vs " << header.numPlayers << ", "
+			"obs size: " << envSet->obsSize << " vs " << header.obsSize << ", actions: " << envSet->numActions << " vs " << header.numActions << ", "
+			"batched rewards: " << envSet->config.batchedRewards.size() << " vs " << header.numBatchedRewards << ")"
+		);
+	}
+
+	if (envSet->stepCount > 0)
+		RG_ERR_CLOSE("ReplayRollout(): The env set has already been stepped");
+
+	RolloutReplayResult result = {};
+	IList actionIndices = IList(header.numPlayers);
+	std::vector<uint16_t> actionsBuffer = std::vector<uint16_t>(header.numPlayers);
+
+	while (true) {
+		uint64_t recordedObsHash, recordedResultHash;
+		ReadVal(fileIn, recordedObsHash);
+		ReadVal(fileIn, recordedResultHash);
+		fileIn.read((char*)actionsBuffer.data(), actionsBuffer.size() * sizeof(uint16_t));
+		if (!fileIn.good())
+			break; // End of the recording (or a step cut off by the recorder being killed)
+
+		for (int i = 0; i < header.numPlayers; i++)
+			actionIndices[i] = actionsBuffer[i];
+
+		const uint64_t stepIdx = result.numPrefixSteps + result.numSteps;
+		const bool inWindow = stepIdx >= header.windowStartStep;
+
+		auto startTime = std::chrono::steady_clock::now();
+		envSet->Reset();
+		double stepTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+		bool obsMatches = RolloutRecorder::HashObs(state) == recordedObsHash;
+
+		startTime = std::chrono::steady_clock::now();
+		envSet->StepFirstHalf(false);
+		envSet->StepSecondHalf(actionIndices, false);
+		stepTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+		bool resultMatches = RolloutRecorder::HashResult(state) == recordedResultHash;
+
+		if (!obsMatches)
+			result.numObsMismatches++;
+		if (!resultMatches)
+			result.numResultMismatches++;
+		if ((!obsMatches || !resultMatches) && result.firstMismatchStep == -1)
+			result.firstMismatchStep = stepIdx;
+
+		if (inWindow) {
+			result.stepTime += stepTime;
+			result.numSteps++;
+		} else {
+			result.numPrefixSteps++;
+		}
+	}
+
+	return result;
+}
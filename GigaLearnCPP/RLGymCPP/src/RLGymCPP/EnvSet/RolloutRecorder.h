@@ -0,0 +1,100 @@
+#pragma once
+#include "EnvSet.h"
+
+namespace RLGC {
+	// Records the env side of collection (every step's actions) into a compact file,
+	//	so that a window of it can be re-stepped later with ReplayRollout() without a policy in the loop
+	// Hashes of each step's obs and rewards are stored too, so the replay can check that it reproduced them
+	//
+	// File layout (native endianness):
+	//	RolloutFileHeader
+	//	Then one record per step until the end of the file: obs hash, result hash, then one uint16 action index per player
+	//
+	// Recording always starts at the env set's first step, since a new env set with the same config starts in the same state,
+	//	and the replay reproduces the recording exactly
+	// A window starting later is replayed by re-stepping everything before it first, rather than restoring a snapshot,
+	//	since neither Arena::Serialize() nor the obs builders, rewards, and terminal conditions keep all of their state
+	// The steps before the window only cost 16 bytes plus 2 bytes per player each
+	struct RolloutFileHeader {
+		static constexpr char MAGIC[8] = { 'G', 'G', 'L', 'R', 'O', 'L', 'L', 'O' };
+		static constexpr uint32_t VERSION = 2;
+
+		char magic[8];
+		uint32_t version;
+		uint32_t _pad0;
+
+		uint32_t numArenas;
+		uint32_t numPlayers;
+		uint32_t obsSize;
+		uint32_t numActions;
+
+		uint32_t tickSkip;
+		uint32_t actionDelay;
+		uint64_t randomSeed;
+		uint32_t ballPredNumStates;
+		uint32_t ballPredTickInterval;
+		uint8_t saveRewards;
+		uint8_t shuffleRewardSampling;
+		uint8_t _pad1[2];
+		uint32_t numBatchedRewards;
+
+		// Steps before this are only re-stepped to reach the start of the window (see RolloutRecorder::StartWindow())
+		uint64_t windowStartStep;
+	};
+
+	struct RolloutRecorder {
+		std::filesystem::path path;
+		std::ofstream fileOut;
+		RolloutFileHeader header = {};
+
+		uint64_t obsHash = 0; // From RecordObs(), written with the next step
+		uint64_t numSteps = 0;
+
+		std::vector<uint16_t> actionsBuffer;
+
+		// Opens the file and writes the header
+		// Must be made before the env set's first step
+		RolloutRecorder(std::filesystem::path path, const EnvSet* envSet);
+
+		RG_NO_COPY(RolloutRecorder);
+
+		// Marks the next recorded step as the start of the window, which is what ReplayRollout() times
+		// If never called, the window is the whole recording
+		void StartWindow();
+
+		// Call after EnvSet::Reset(), before anything modifies the obs (e.g. normalization)
+		void RecordObs(const EnvSet* envSet);
+
+		// Call after EnvSet::StepSecondHalf() with the actions it was given
+		void RecordStep(const EnvSet* envSet, const IList& actionIndices);
+
+		void Close();
+		~RolloutRecorder() { Close(); }
+
+		// Hashes of the env state, used to check that a replay matches the recording
+		static uint64_t HashObs(const EnvState& state);
+		static uint64_t HashResult(const EnvState& state); // Rewards and terminals
+	};
+
+	// Reads a rollout file's header and makes the matching env set config
+	// The env create function and batched rewards can't be stored in the file, so they must be set by the caller to whatever was used when recording
+	EnvSetConfig MakeRolloutEnvSetConfig(std::filesystem::path path, EnvCreateFn envCreateFn);
+
+	struct RolloutReplayResult {
+		uint64_t numSteps = 0; // Steps in the window
+		uint64_t numPrefixSteps = 0; // Steps re-stepped to reach the window
+
+		// Every step is checked, including those before the window
+		uint64_t numObsMismatches = 0, numResultMismatches = 0;
+		int64_t firstMismatchStep = -1; // Counting from the env set's first step, -1 if everything matched
+
+		double stepTime = 0; // Seconds spent in EnvSet::Reset() and stepping, during the window
+		double StepsPerSecond() const {
+			return stepTime > 0 ? numSteps / stepTime : 0;
+		}
+	};
+
+	// Re-steps the env set with the recorded actions, checking the obs and rewards against the recording
+	// The env set must have been made from MakeRolloutEnvSetConfig() and not stepped yet
+	RolloutReplayResult ReplayRollout(EnvSet* envSet, std::filesystem::path path);
+}
@@ -0,0 +1,74 @@
+#include "BallPrediction.h"
+
+using namespace RLGC;
+
+// Ball-only arena used to simulate predictions
+// One per thread and game mode, since predictions are made from the arena stepping jobs
+static Arena* GetPredArena(const Arena* arena) {
+	struct PredArenaEntry {
+		GameMode gameMode;
+		float tickTime;
+		std::unique_ptr<Arena> arena;
+	};
+	thread_local std::vector<PredArenaEntry> predArenas = {};
+
+	for (auto& entry : predArenas)
+		if (entry.gameMode == arena->gameMode && entry.tickTime == arena->tickTime)
+			return entry.arena.get();
+
+	// NOTE: Arenas of the same game mode with different configs will share the config of the first one seen
+	Arena* predArena = Arena::Create(arena->gameMode, arena->GetArenaConfig(), arena->GetTickRate());
+	predArenas.push_back({ arena->gameMode, arena->tickTime, std::unique_ptr<Arena>(predArena) });
+	return predArena;
+}
+
+void RLGC::BallPrediction::Update(const BallState& ball, uint64_t curTickCount, const Arena* arena) {
+	if (numStates <= 0)
+		return;
+
+	RG_ASSERT(tickInterval > 0);
+	if (_states.size() != (size_t)numStates) {
+		_states.resize(numStates);
+		valid = false;
+	}
+
+	int shift = 0; // Amount of old predicted states that are now in the past
+	if (valid && curTickCount >= tickCount) {
+		uint64_t ticksPassed = curTickCount - tickCount;
+		if (ticksPassed == 0)
+			return; // Already predicted from this tick
+
+		if (ticksPassed % tickInterval == 0 && ticksPassed / tickInterval <= (uint64_t)numStates) {
+			int candidateShift = ticksPassed / tickInterval;
+			if (Get(candidateShift - 1).Matches(ball))
+				shift = candidateShift;
+		}
+	}
+
+	Arena* predArena = GetPredArena(arena);
+
+	int firstNewIdx;
+	if (shift > 0) {
+		// Ball is on its predicted path, keep the states that are still in the future
+		// Continue simulating from the last old state, which stays at index (numStates - 1 - shift)
+		predArena->ball->SetState(Get(numStates - 1));
+		_startIdx = (_startIdx + shift) % numStates;
+		firstNewIdx = numStates - shift;
+		numReusedUpdates++;
+	} else {
+		predArena->ball->SetState(ball);
+		firstNewIdx = 0;
+		numFullUpdates++;
+	}
+
+	for (int i = firstNewIdx; i < numStates; i++) {
+		predArena->Step(tickInterval);
+		int ringIdx = _startIdx + i;
+		if (ringIdx >= numStates)
+			ringIdx -= numStates;
+		_states[ringIdx] = predArena->ball->GetState();
+	}
+
+	tickCount = curTickCount;
+	valid = true;
+}
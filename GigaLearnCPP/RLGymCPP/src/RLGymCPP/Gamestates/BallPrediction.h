@@ -0,0 +1,47 @@
+#pragma once
+#include "../Framework.h"
+
+namespace RLGC {
+
+	// Future ball states of one arena, evenly spaced in time
+	// Unlike BallPredTracker, this doesn't own an arena: the ball is simulated in a ball-only arena shared by all predictions on the same thread
+	// When the ball ends up where it was predicted to be (i.e. nothing touched it), the old prediction is shifted and only the new end is simulated
+	struct BallPrediction {
+		int numStates;
+		int tickInterval; // Ticks between predicted states
+
+		// Ring buffer of predicted states, see Get()
+		std::vector<BallState> _states;
+		int _startIdx = 0;
+
+		bool valid = false;
+		uint64_t tickCount = 0; // Arena tick count of the ball state this was predicted from
+
+		// Amount of full re-predictions and reused predictions, useful for tuning tickInterval
+		uint64_t numFullUpdates = 0, numReusedUpdates = 0;
+
+		BallPrediction(int numStates = 0, int tickInterval = 8) : numStates(numStates), tickInterval(tickInterval) {}
+
+		// Predicted ball after (index + 1) * tickInterval ticks
+		const BallState& Get(int index) const {
+			int ringIdx = _startIdx + index;
+			if (ringIdx >= numStates)
+				ringIdx -= numStates;
+			return _states[ringIdx];
+		}
+
+		// Seconds from the current state until the predicted state at this index
+		float GetTime(int index, float tickTime) const {
+			return (index + 1) * tickInterval * tickTime;
+		}
+
+		// Forces the next update to re-predict everything, use when the ball was state-set
+		void Invalidate() {
+			valid = false;
+		}
+
+		// Predicts from a ball state at a given tick count, reusing the previous prediction when possible
+		// The arena is only used to get the game mode and tick rate
+		void Update(const BallState& ball, uint64_t curTickCount, const Arena* arena);
+	};
+}
@@ -59,10 +59,16 @@ void RLGC::GameState::ResetBeforeStep() {
 
 void RLGC::GameState::UpdateFromArena(Arena* arena, const std::vector<Action>& actions, GameState* prev) {
 	this->prev = prev;
-	if (prev)
+	if (prev) {
 		prev->prev = NULL;
 
+		// This state may be a recycled buffer (see EnvSet::StepFirstHalf()), so continue from prev
+		lastTickCount = prev->lastTickCount;
+		lastTouchCarID = prev->lastTouchCarID;
+	}
+
 	lastArena = arena;
+	_featuresValid = false;
 	
 	// OPTIMISATION: Utiliser des entiers au lieu de uint64_t quand possible
 	const uint64_t currentTick = arena->tickCount;
@@ -72,11 +78,10 @@ void RLGC::GameState::UpdateFromArena(Arena* arena, const std::vector<Action>& a
 	// OPTIMISATION: Copie directe du ball state
 	ball = arena->ball->GetState();
 
-	// OPTIMISATION: viter le resize si mme taille
 	const size_t numCars = arena->_cars.size();
-	if (players.size() != numCars) {
-		players.resize(numCars);
-	}
+	if (numCars > CommonValues::MAX_PLAYERS)
+		RG_ERR_CLOSE("GameState::UpdateFromArena(): Too many cars in arena (" << numCars << "/" << CommonValues::MAX_PLAYERS << ")");
+	players.resize(numCars);
 
 	// OPTIMISATION: Utiliser un itrateur et un index en parallle
 	auto carItr = arena->_cars.begin();
@@ -96,17 +101,8 @@ void RLGC::GameState::UpdateFromArena(Arena* arena, const std::vector<Action>& a
 		boostPadIndexMapMutex.unlock();
 	}
 
-	// OPTIMISATION MAJEURE: Traitement vectoris des boost pads
-	const int numBoostPads = static_cast<int>(arena->_boostPads.size());
-	
-	// Redimensionner seulement si ncessaire
-	if (boostPads.size() != static_cast<size_t>(numBoostPads)) {
-		boostPads.resize(numBoostPads);
-		boostPadsInv.resize(numBoostPads);
-		boostPadTimers.resize(numBoostPads);
-		boostPadTimersInv.resize(numBoostPads);
-	}
-	
+	const int numBoostPads = CommonValues::BOOST_LOCATIONS_AMOUNT;
+
 	// OPTIMISATION: Pr-calculer les indices inverss et traiter par paires
 	// Cela exploite mieux le cache CPU
 	for (int i = 0; i < numBoostPads; i++) {
@@ -1,7 +1,11 @@
 #pragma once
 #include "Player.h"
+#include "StateFeatures.h"
+#include "BallPrediction.h"
 #include "../CommonValues.h"
 #include "../BasicTypes/Action.h"
+#include "../BasicTypes/Lists.h"
+#include "../BasicTypes/RNG.h"
 
 namespace RLGC {
 	struct ScoreLine {
@@ -17,6 +21,7 @@ namespace RLGC {
 	};
 
 	// https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/gamestates/game_state.py
+	// NOTE: Uses only fixed-size storage so that it is trivially copyable
 	struct GameState {
 		
 		GameState* prev = NULL;
@@ -25,12 +30,12 @@ namespace RLGC {
 
 		bool goalScored = false; // If the ball is in the goal
 		int lastTouchCarID = -1;
-		std::vector<Player> players;
+		FixedList<Player, CommonValues::MAX_PLAYERS> players;
 
 		BallState ball;
 
-		std::vector<bool> boostPads, boostPadsInv;
-		std::vector<float> boostPadTimers, boostPadTimersInv;
+		std::array<bool, CommonValues::BOOST_LOCATIONS_AMOUNT> boostPads, boostPadsInv;
+		std::array<float, CommonValues::BOOST_LOCATIONS_AMOUNT> boostPadTimers, boostPadTimersInv;
 
 		// Last arena we updated with
 		// Can be used to determine current arena from within reward function, for example
@@ -42,11 +47,23 @@ namespace RLGC {
 
 		void* userInfo = NULL;
 
+		// Random generator of the arena this state belongs to, use it instead of global random functions to keep runs reproducible
+		// NOTE: Could be null (e.g. states made outside of an EnvSet)
+		RNG* rng = NULL;
+
+		// Ball prediction of the arena this state belongs to, see GetBallPred()
+		// NOTE: Null unless enabled in the EnvSetConfig
+		BallPrediction* ballPred = NULL;
+
+		// Per-step cache, see GetFeatures()
+		mutable StateFeatures _features;
+		mutable bool _featuresValid = false;
+
 		GameState() {
-			boostPads = std::vector<bool>(CommonValues::BOOST_LOCATIONS_AMOUNT, true);
-			boostPadsInv = std::vector<bool>(CommonValues::BOOST_LOCATIONS_AMOUNT, true);
-			boostPadTimers = std::vector<float>(CommonValues::BOOST_LOCATIONS_AMOUNT, 0);
-			boostPadTimersInv = std::vector<float>(CommonValues::BOOST_LOCATIONS_AMOUNT, 0);
+			boostPads.fill(true);
+			boostPadsInv.fill(true);
+			boostPadTimers.fill(0);
+			boostPadTimersInv.fill(0);
 		}
 		explicit GameState(Arena* arena) {
 			UpdateFromArena(arena, std::vector<Action>(arena->_cars.size()), NULL);
@@ -60,6 +77,25 @@ namespace RLGC {
 			return inverted ? boostPadTimers : boostPadTimersInv;
 		}
 
+		// Derived values (inverted physics, directions to the ball, etc.), computed on first access after each update
+		// NOTE: The first access after an update computes the cache, so it shouldn't be done from multiple threads at once
+		const StateFeatures& GetFeatures() const {
+			if (!_featuresValid) {
+				_features.Compute(*this);
+				_featuresValid = true;
+			}
+			return _features;
+		}
+
+		// Future ball states from this state's ball, computed on first access after each update
+		// Returns null if ball prediction is disabled
+		// NOTE: The prediction is shared with the arena's other states, so only use this on the current state
+		const BallPrediction* GetBallPred() const {
+			if (ballPred)
+				ballPred->Update(ball, lastTickCount, lastArena);
+			return ballPred;
+		}
+
 		// Called before updating to reset the per-step state
 		void ResetBeforeStep();
 
@@ -71,6 +107,9 @@ namespace RLGC {
 
 		void MakeEmpty() {
 			players.clear();
+			_featuresValid = false;
 		}
 	};
+
+	static_assert(std::is_trivially_copyable_v<GameState>, "GameState must be trivially copyable");
 }
\ No newline at end of file
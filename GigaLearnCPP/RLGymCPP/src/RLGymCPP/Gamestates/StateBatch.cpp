@@ -0,0 +1,88 @@
+#include "StateBatch.h"
+
+void RLGC::StateBatch::Resize(const std::vector<int>& arenaPlayerStartIdx, int numPlayers) {
+	this->numArenas = arenaPlayerStartIdx.size();
+	this->numPlayers = numPlayers;
+
+	this->arenaPlayerStartIdx = arenaPlayerStartIdx;
+	this->arenaPlayerStartIdx.push_back(numPlayers);
+
+	gameStates.assign(numArenas, NULL);
+	isFinal.resize(numArenas);
+	goalScored.resize(numArenas);
+	hasPrev.resize(numArenas);
+	ballPos.Resize(numArenas);
+	ballVel.Resize(numArenas);
+	ballAngVel.Resize(numArenas);
+	prevBallVel.Resize(numArenas);
+
+	arenaIdx.resize(numPlayers);
+	for (int i = 0; i < numArenas; i++)
+		for (int j = this->arenaPlayerStartIdx[i]; j < this->arenaPlayerStartIdx[i + 1]; j++)
+			arenaIdx[j] = i;
+
+	team.resize(numPlayers);
+	pos.Resize(numPlayers);
+	vel.Resize(numPlayers);
+	angVel.Resize(numPlayers);
+	forward.Resize(numPlayers);
+	up.Resize(numPlayers);
+
+	for (auto col : { &boost, &prevBoost })
+		col->resize(numPlayers);
+
+	for (auto col : {
+		&isOnGround, &isDemoed, &isFlipping, &prevIsOnGround, &prevIsFlipping, &ballTouchedStep, &ballTouchedTick,
+		&eventGoal, &eventSave, &eventAssist, &eventShot, &eventShotPass, &eventBump, &eventBumped, &eventDemo, &eventDemoed
+		})
+		col->resize(numPlayers);
+}
+
+void RLGC::StateBatch::SetArena(int arenaIdx, const GameState& state, uint8_t isFinal) {
+	const int startIdx = arenaPlayerStartIdx[arenaIdx];
+	RG_ASSERT(startIdx + state.players.size() == arenaPlayerStartIdx[arenaIdx + 1]);
+
+	gameStates[arenaIdx] = &state;
+	this->isFinal[arenaIdx] = isFinal;
+	goalScored[arenaIdx] = state.goalScored;
+	hasPrev[arenaIdx] = state.prev != NULL;
+
+	ballPos.Set(arenaIdx, state.ball.pos);
+	ballVel.Set(arenaIdx, state.ball.vel);
+	ballAngVel.Set(arenaIdx, state.ball.angVel);
+	prevBallVel.Set(arenaIdx, state.prev ? state.prev->ball.vel : state.ball.vel);
+
+	for (int i = 0; i < state.players.size(); i++) {
+		const Player& player = state.players[i];
+		const Player& prevPlayer = player.prev ? *player.prev : player;
+		const int row = startIdx + i;
+
+		team[row] = (uint8_t)player.team;
+		pos.Set(row, player.pos);
+		vel.Set(row, player.vel);
+		angVel.Set(row, player.angVel);
+		forward.Set(row, player.rotMat.forward);
+		up.Set(row, player.rotMat.up);
+
+		boost[row] = player.boost;
+		prevBoost[row] = prevPlayer.boost;
+		isOnGround[row] = player.isOnGround;
+		isDemoed[row] = player.isDemoed;
+		isFlipping[row] = player.isFlipping;
+		prevIsOnGround[row] = prevPlayer.isOnGround;
+		prevIsFlipping[row] = prevPlayer.isFlipping;
+		ballTouchedStep[row] = player.ballTouchedStep;
+		ballTouchedTick[row] = player.ballTouchedTick;
+
+		const PlayerEventState& events = player.eventState;
+		eventGoal[row] = events.goal;
+		eventSave[row] = events.save;
+		eventAssist[row] = events.assist;
+		eventShot[row] = events.shot;
+		eventShotPass[row] = events.shotPass;
+		eventBump[row] = events.bump;
+		eventBumped[row] = events.bumped;
+		eventDemo[row] = events.demo;
+		eventDemoed[row] = events.demoed;
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "GameState.h"
+
+namespace RLGC {
+
+	// Three float columns (x, y, z) stored separately so loops over them can be vectorized
+	struct VecColumn {
+		std::vector<float> x, y, z;
+
+		void Resize(size_t size) {
+			x.resize(size);
+			y.resize(size);
+			z.resize(size);
+		}
+
+		void Set(size_t index, const Vec& vec) {
+			x[index] = vec.x;
+			y[index] = vec.y;
+			z[index] = vec.z;
+		}
+
+		Vec Get(size_t index) const {
+			return Vec(x[index], y[index], z[index]);
+		}
+	};
+
+	// Columnar snapshot of every arena's state in an EnvSet
+	// Player rows use the same global indices as EnvState (rewards, obs, actions)
+	// Filled by the EnvSet after all arenas have been stepped, and passed to batched rewards
+	struct StateBatch {
+		int numArenas = 0;
+		int numPlayers = 0;
+
+		///////////////
+		// Per-arena data
+
+		// Index of the first player of each arena, with one extra entry at the end equal to numPlayers
+		std::vector<int> arenaPlayerStartIdx;
+
+		std::vector<const GameState*> gameStates;
+		std::vector<uint8_t> isFinal; // Terminal type of the arena for this step (non-zero if final)
+		std::vector<uint8_t> goalScored;
+		std::vector<uint8_t> hasPrev; // If false, all "prev" columns are copies of the current values
+
+		VecColumn ballPos, ballVel, ballAngVel;
+		VecColumn prevBallVel;
+
+		///////////////
+		// Per-player data
+
+		std::vector<int> arenaIdx;
+		std::vector<uint8_t> team;
+
+		VecColumn pos, vel, angVel;
+		VecColumn forward, up;
+
+		std::vector<float> boost, prevBoost;
+		std::vector<uint8_t> isOnGround, isDemoed, isFlipping, prevIsOnGround, prevIsFlipping;
+		std::vector<uint8_t> ballTouchedStep, ballTouchedTick;
+
+		// Event flags (see PlayerEventState)
+		std::vector<uint8_t> eventGoal, eventSave, eventAssist, eventShot, eventShotPass;
+		std::vector<uint8_t> eventBump, eventBumped, eventDemo, eventDemoed;
+
+		///////////////
+
+		// arenaPlayerStartIdx: Start index of each arena's players (see EnvState)
+		void Resize(const std::vector<int>& arenaPlayerStartIdx, int numPlayers);
+
+		// Writes the rows of a single arena
+		// Different arenas can be set concurrently
+		void SetArena(int arenaIdx, const GameState& state, uint8_t isFinal);
+
+		int GetNumPlayersInArena(int arenaIdx) const {
+			return arenaPlayerStartIdx[arenaIdx + 1] - arenaPlayerStartIdx[arenaIdx];
+		}
+
+		// A contiguous range of arenas, along with their player rows
+		// Batched rewards are evaluated one range at a time, with different ranges running concurrently
+		struct Range {
+			int arenaStart, arenaEnd; // Arenas [arenaStart, arenaEnd)
+			int playerStart, playerEnd; // Player rows [playerStart, playerEnd)
+		};
+
+		Range GetRange(int arenaStart, int arenaEnd) const {
+			return { arenaStart, arenaEnd, arenaPlayerStartIdx[arenaStart], arenaPlayerStartIdx[arenaEnd] };
+		}
+	};
+}
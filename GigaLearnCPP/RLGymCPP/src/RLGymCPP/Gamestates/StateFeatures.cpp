@@ -0,0 +1,38 @@
+#include "StateFeatures.h"
+#include "GameState.h"
+
+using namespace RLGC;
+
+// Same as InvertPhys(), but writes in-place
+static inline void InvertPhysInto(const PhysState& phys, PhysState& out) {
+	out.pos = Vec(-phys.pos.x, -phys.pos.y, phys.pos.z);
+	out.rotMat.forward = Vec(-phys.rotMat.forward.x, -phys.rotMat.forward.y, phys.rotMat.forward.z);
+	out.rotMat.right = Vec(-phys.rotMat.right.x, -phys.rotMat.right.y, phys.rotMat.right.z);
+	out.rotMat.up = Vec(-phys.rotMat.up.x, -phys.rotMat.up.y, phys.rotMat.up.z);
+	out.vel = Vec(-phys.vel.x, -phys.vel.y, phys.vel.z);
+	out.angVel = Vec(-phys.angVel.x, -phys.angVel.y, phys.angVel.z);
+}
+
+void RLGC::StateFeatures::Compute(const GameState& state) {
+	ball[0] = state.ball;
+	InvertPhysInto(state.ball, ball[1]);
+
+	// Blue attacks the orange goal and vice versa
+	ballDirToGoal[(int)Team::BLUE] = (CommonValues::ORANGE_GOAL_BACK - state.ball.pos).Normalized();
+	ballDirToGoal[(int)Team::ORANGE] = (CommonValues::BLUE_GOAL_BACK - state.ball.pos).Normalized();
+
+	players.resize(state.players.size());
+	for (int i = 0; i < state.players.size(); i++) {
+		const Player& player = state.players[i];
+		PlayerFeatures& features = players[i];
+
+		InvertPhysInto(player, features.invPhys);
+
+		features.localAngVel = player.rotMat.Dot(player.angVel);
+		features.speed = player.vel.Length();
+
+		features.toBall = state.ball.pos - player.pos;
+		features.ballDist = features.toBall.Length();
+		features.dirToBall = (features.ballDist > 0) ? (features.toBall / features.ballDist) : Vec();
+	}
+}
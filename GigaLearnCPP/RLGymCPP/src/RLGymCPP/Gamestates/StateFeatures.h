@@ -0,0 +1,37 @@
+#pragma once
+#include "Player.h"
+#include "../CommonValues.h"
+#include "../BasicTypes/Lists.h"
+
+namespace RLGC {
+	struct GameState;
+
+	struct PlayerFeatures {
+		PhysState invPhys; // Physics from orange's perspective (see InvertPhys())
+
+		Vec localAngVel; // rotMat.Dot(angVel), identical from both perspectives
+		float speed;
+
+		Vec toBall; // Ball pos - player pos
+		float ballDist;
+		Vec dirToBall; // Normalized toBall
+	};
+
+	// Derived values commonly needed by obs builders and rewards
+	// Computed once per step from a GameState, see GameState::GetFeatures()
+	struct StateFeatures {
+		PhysState ball[2]; // Indexed by whether it is inverted (i.e. from orange's perspective)
+
+		// Normalized direction from the ball to the goal each team is attacking, indexed by team
+		Vec ballDirToGoal[2];
+
+		FixedList<PlayerFeatures, CommonValues::MAX_PLAYERS> players; // Same order as GameState::players
+
+		void Compute(const GameState& state);
+
+		// Physics of a player from either perspective, without copying
+		const PhysState& GetPlayerPhys(const Player& player, bool inverted) const {
+			return inverted ? players[player.index].invPhys : player;
+		}
+	};
+}
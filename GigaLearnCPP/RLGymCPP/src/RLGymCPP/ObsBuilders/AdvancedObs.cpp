@@ -69,44 +69,9 @@ public:
 	size_t Written() const { return ptr - (end - 256); } // Approximation
 };
 
-// OPTIMISATION MAJEURE: Inversion inline sans cration d'objet temporaire
-// crit directement les valeurs inverses
-struct InvertedPhys {
-	Vec pos, vel, angVel;
-	Vec forward, right, up;
-	
-	// Constructeur depuis Player avec inversion optionnelle
-	InvertedPhys(const Player& p, bool inv) {
-		if (inv) {
-			pos.x = -p.pos.x; pos.y = -p.pos.y; pos.z = p.pos.z;
-			vel.x = -p.vel.x; vel.y = -p.vel.y; vel.z = p.vel.z;
-			angVel.x = -p.angVel.x; angVel.y = -p.angVel.y; angVel.z = p.angVel.z;
-			forward.x = -p.rotMat.forward.x; forward.y = -p.rotMat.forward.y; forward.z = p.rotMat.forward.z;
-			right.x = -p.rotMat.right.x; right.y = -p.rotMat.right.y; right.z = p.rotMat.right.z;
-			up.x = -p.rotMat.up.x; up.y = -p.rotMat.up.y; up.z = p.rotMat.up.z;
-		} else {
-			pos = p.pos; vel = p.vel; angVel = p.angVel;
-			forward = p.rotMat.forward; right = p.rotMat.right; up = p.rotMat.up;
-		}
-	}
-	
-	// Constructeur depuis BallState avec inversion optionnelle
-	InvertedPhys(const BallState& b, bool inv) {
-		if (inv) {
-			pos.x = -b.pos.x; pos.y = -b.pos.y; pos.z = b.pos.z;
-			vel.x = -b.vel.x; vel.y = -b.vel.y; vel.z = b.vel.z;
-			angVel.x = -b.angVel.x; angVel.y = -b.angVel.y; angVel.z = b.angVel.z;
-		} else {
-			pos = b.pos; vel = b.vel; angVel = b.angVel;
-		}
-		// Ball n'a pas de rotation
-		forward = right = up = Vec(0, 0, 0);
-	}
-};
-
 // OPTIMISATION MAJEURE: AddPlayerToObs avec criture directe dans buffer
-static inline void AddPlayerToObsFast(float*& ptr, const Player& player, bool inv, const InvertedPhys& ball) {
-	InvertedPhys phys(player, inv);
+// phys: The player's physics from the observer's perspective
+static inline void AddPlayerToObsFast(float*& ptr, const Player& player, const PhysState& phys, const Vec& localAngVel, const PhysState& ball) {
 	
 	// Position (3)
 	ptr[0] = phys.pos.x * POS_COEF;
@@ -115,15 +80,15 @@ static inline void AddPlayerToObsFast(float*& ptr, const Player& player, bool in
 	ptr += 3;
 	
 	// Forward (3)
-	ptr[0] = phys.forward.x;
-	ptr[1] = phys.forward.y;
-	ptr[2] = phys.forward.z;
+	ptr[0] = phys.rotMat.forward.x;
+	ptr[1] = phys.rotMat.forward.y;
+	ptr[2] = phys.rotMat.forward.z;
 	ptr += 3;
 	
 	// Up (3)
-	ptr[0] = phys.up.x;
-	ptr[1] = phys.up.y;
-	ptr[2] = phys.up.z;
+	ptr[0] = phys.rotMat.up.x;
+	ptr[1] = phys.rotMat.up.y;
+	ptr[2] = phys.rotMat.up.z;
 	ptr += 3;
 	
 	// Velocity (3)
@@ -139,27 +104,27 @@ static inline void AddPlayerToObsFast(float*& ptr, const Player& player, bool in
 	ptr += 3;
 	
 	// Local angular velocity (3) - rotMat.Dot(angVel)
-	ptr[0] = (phys.forward.x * phys.angVel.x + phys.forward.y * phys.angVel.y + phys.forward.z * phys.angVel.z) * ANG_VEL_COEF;
-	ptr[1] = (phys.right.x * phys.angVel.x + phys.right.y * phys.angVel.y + phys.right.z * phys.angVel.z) * ANG_VEL_COEF;
-	ptr[2] = (phys.up.x * phys.angVel.x + phys.up.y * phys.angVel.y + phys.up.z * phys.angVel.z) * ANG_VEL_COEF;
+	ptr[0] = localAngVel.x * ANG_VEL_COEF;
+	ptr[1] = localAngVel.y * ANG_VEL_COEF;
+	ptr[2] = localAngVel.z * ANG_VEL_COEF;
 	ptr += 3;
 	
 	// Local ball pos (3)
 	const float relBallX = ball.pos.x - phys.pos.x;
 	const float relBallY = ball.pos.y - phys.pos.y;
 	const float relBallZ = ball.pos.z - phys.pos.z;
-	ptr[0] = (phys.forward.x * relBallX + phys.forward.y * relBallY + phys.forward.z * relBallZ) * POS_COEF;
-	ptr[1] = (phys.right.x * relBallX + phys.right.y * relBallY + phys.right.z * relBallZ) * POS_COEF;
-	ptr[2] = (phys.up.x * relBallX + phys.up.y * relBallY + phys.up.z * relBallZ) * POS_COEF;
+	ptr[0] = (phys.rotMat.forward.x * relBallX + phys.rotMat.forward.y * relBallY + phys.rotMat.forward.z * relBallZ) * POS_COEF;
+	ptr[1] = (phys.rotMat.right.x * relBallX + phys.rotMat.right.y * relBallY + phys.rotMat.right.z * relBallZ) * POS_COEF;
+	ptr[2] = (phys.rotMat.up.x * relBallX + phys.rotMat.up.y * relBallY + phys.rotMat.up.z * relBallZ) * POS_COEF;
 	ptr += 3;
 	
 	// Local ball vel (3)
 	const float relVelX = ball.vel.x - phys.vel.x;
 	const float relVelY = ball.vel.y - phys.vel.y;
 	const float relVelZ = ball.vel.z - phys.vel.z;
-	ptr[0] = (phys.forward.x * relVelX + phys.forward.y * relVelY + phys.forward.z * relVelZ) * VEL_COEF;
-	ptr[1] = (phys.right.x * relVelX + phys.right.y * relVelY + phys.right.z * relVelZ) * VEL_COEF;
-	ptr[2] = (phys.up.x * relVelX + phys.up.y * relVelY + phys.up.z * relVelZ) * VEL_COEF;
+	ptr[0] = (phys.rotMat.forward.x * relVelX + phys.rotMat.forward.y * relVelY + phys.rotMat.forward.z * relVelZ) * VEL_COEF;
+	ptr[1] = (phys.rotMat.right.x * relVelX + phys.rotMat.right.y * relVelY + phys.rotMat.right.z * relVelZ) * VEL_COEF;
+	ptr[2] = (phys.rotMat.up.x * relVelX + phys.rotMat.up.y * relVelY + phys.rotMat.up.z * relVelZ) * VEL_COEF;
 	ptr += 3;
 	
 	// Player state (5)
@@ -182,12 +147,7 @@ void RLGC::AdvancedObs::AddPlayerToObs(FList& obs, const Player& player, bool in
 	obs.resize(startSize + PLAYER_OBS_SIZE);
 	float* ptr = obs.data() + startSize;
 	
-	InvertedPhys ballPhys(BallState{}, false);
-	ballPhys.pos = ball.pos;
-	ballPhys.vel = ball.vel;
-	ballPhys.angVel = ball.angVel;
-	
-	AddPlayerToObsFast(ptr, player, inv, ballPhys);
+	AddPlayerToObsFast(ptr, player, InvertPhys(player, inv), player.rotMat.Dot(player.angVel), ball);
 }
 
 FList RLGC::AdvancedObs::BuildObs(const Player& player, const GameState& state) {
@@ -208,7 +168,8 @@ FList RLGC::AdvancedObs::BuildObs(const Player& player, const GameState& state)
 	const bool inv = player.team == Team::ORANGE;
 	
 	// OPTIMISATION: Crer la balle inverse une seule fois
-	InvertedPhys ball(state.ball, inv);
+	const StateFeatures& features = state.GetFeatures();
+	const PhysState& ball = features.ball[inv];
 	
 	const auto& pads = state.GetBoostPads(inv);
 	const auto& padTimers = state.GetBoostPadTimers(inv);
@@ -244,21 +205,24 @@ FList RLGC::AdvancedObs::BuildObs(const Player& player, const GameState& state)
 	}
 	
 	// Current player (29)
-	AddPlayerToObsFast(ptr, player, inv, ball);
+	auto fnAddPlayer = [&](const Player& p) {
+		AddPlayerToObsFast(ptr, p, features.GetPlayerPhys(p, inv), features.players[p.index].localAngVel, ball);
+	};
+	fnAddPlayer(player);
 	
 	// OPTIMISATION MAJEURE: Une seule boucle avec tri en place
 	// Collecter d'abord les indices des coquipiers puis des adversaires
 	for (const auto& otherPlayer : state.players) {
 		if (otherPlayer.carId == player.carId) continue;
 		if (otherPlayer.team == player.team) {
-			AddPlayerToObsFast(ptr, otherPlayer, inv, ball);
+			fnAddPlayer(otherPlayer);
 		}
 	}
 	
 	for (const auto& otherPlayer : state.players) {
 		if (otherPlayer.carId == player.carId) continue;
 		if (otherPlayer.team != player.team) {
-			AddPlayerToObsFast(ptr, otherPlayer, inv, ball);
+			fnAddPlayer(otherPlayer);
 		}
 	}
 	
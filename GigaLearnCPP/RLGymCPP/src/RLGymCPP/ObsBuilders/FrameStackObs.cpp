@@ -0,0 +1,65 @@
+#include "FrameStackObs.h"
+
+void RLGC::FrameStackObs::Reset(const GameState& initialState) {
+	inner->Reset(initialState);
+
+	// Keep the buffers, they are refilled by the first build of each player
+	playerHistories.resize(initialState.players.size());
+	playerHeads.assign(initialState.players.size(), -1);
+}
+
+int RLGC::FrameStackObs::PushFrame(const Player& player, const GameState& state) {
+	if (player.index >= (int)playerHeads.size()) {
+		playerHistories.resize(player.index + 1);
+		playerHeads.resize(player.index + 1, -1);
+	}
+
+	FList& history = playerHistories[player.index];
+	int& head = playerHeads[player.index];
+
+	if (head == -1) {
+		// First obs since reset, there is no history yet so fill all of it with this obs
+		FList firstObs = inner->BuildObs(player, state);
+		if (innerObsSize == 0)
+			innerObsSize = firstObs.size();
+		if ((int)firstObs.size() != innerObsSize)
+			RG_ERR_CLOSE("FrameStackObs: Inner obs builder changed its obs size from " << innerObsSize << " to " << firstObs.size());
+
+		history.resize((size_t)historyLen * innerObsSize);
+		for (int i = 0; i < historyLen; i++)
+			memcpy(history.data() + (size_t)i * innerObsSize, firstObs.data(), innerObsSize * sizeof(float));
+		head = 0;
+	} else {
+		head = (head + 1) % historyLen;
+		size_t builtSize = inner->BuildObsInto(player, state, history.data() + (size_t)head * innerObsSize, innerObsSize);
+		if ((int)builtSize != innerObsSize)
+			RG_ERR_CLOSE("FrameStackObs: Inner obs builder changed its obs size from " << innerObsSize << " to " << builtSize);
+	}
+
+	return head;
+}
+
+void RLGC::FrameStackObs::WriteStack(int playerIdx, int head, float* out) const {
+	const float* history = playerHistories[playerIdx].data();
+	for (int i = 0; i < numFrames; i++) {
+		int slot = head - i * stride;
+		if (slot < 0)
+			slot += historyLen;
+		memcpy(out + (size_t)i * innerObsSize, history + (size_t)slot * innerObsSize, innerObsSize * sizeof(float));
+	}
+}
+
+RLGC::FList RLGC::FrameStackObs::BuildObs(const Player& player, const GameState& state) {
+	int head = PushFrame(player, state);
+
+	FList result = FList(GetObsSize());
+	WriteStack(player.index, head, result.data());
+	return result;
+}
+
+size_t RLGC::FrameStackObs::BuildObsInto(const Player& player, const GameState& state, float* out, size_t outSize) {
+	int head = PushFrame(player, state);
+	if (outSize == GetObsSize())
+		WriteStack(player.index, head, out);
+	return GetObsSize();
+}
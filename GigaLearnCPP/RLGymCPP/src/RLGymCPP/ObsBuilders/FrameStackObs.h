@@ -0,0 +1,54 @@
+#pragma once
+#include "ObsBuilder.h"
+
+namespace RLGC {
+	// Wraps another obs builder and stacks its last few obs together, giving the policy temporal context without an RNN
+	// Output is the current obs followed by older ones: [now, now - stride, now - stride * 2, ...]
+	// Each player has a fixed ring buffer of past obs, so history is never shifted or re-allocated
+	// NOTE: Every build counts as a new step for that player, and each arena needs its own FrameStackObs
+	class FrameStackObs : public ObsBuilder {
+	public:
+		ObsBuilder* inner;
+		int numFrames; // Amount of obs in the output, including the current one
+		int stride; // Steps between stacked frames, e.g. 2 skips every other step
+
+		int innerObsSize = 0;
+		int historyLen = 0; // Slots in each player's ring buffer
+
+		// Ring buffer of each player, historyLen * innerObsSize floats
+		std::vector<FList> playerHistories;
+		std::vector<int> playerHeads; // Slot of the most recent obs, -1 if nothing has been built since reset
+
+		FrameStackObs(ObsBuilder* inner, int numFrames, int stride = 1) : inner(inner), numFrames(numFrames), stride(stride) {
+			RG_ASSERT(numFrames >= 1 && stride >= 1);
+			historyLen = (numFrames - 1) * stride + 1;
+		}
+
+		RG_NO_COPY(FrameStackObs);
+
+		~FrameStackObs() {
+			delete inner;
+		}
+
+		size_t GetObsSize() const {
+			return (size_t)innerObsSize * numFrames;
+		}
+
+		// Memory used by the history of each player, in bytes
+		size_t GetHistoryBytesPerPlayer() const {
+			return (size_t)historyLen * innerObsSize * sizeof(float);
+		}
+
+		virtual void Reset(const GameState& initialState) override;
+
+		virtual FList BuildObs(const Player& player, const GameState& state) override;
+		virtual size_t BuildObsInto(const Player& player, const GameState& state, float* out, size_t outSize) override;
+
+	private:
+		// Writes the newest obs of a player into its ring buffer, and returns the slot it was written to
+		int PushFrame(const Player& player, const GameState& state);
+
+		// Copies the stacked frames of a player, newest first
+		void WriteStack(int playerIdx, int head, float* out) const;
+	};
+}
@@ -11,5 +11,17 @@ namespace RLGC {
 
 		// NOTE: May be called once during environment initialization to determine policy neuron size
 		virtual FList BuildObs(const Player& player, const GameState& state) = 0;
+
+		// Writes the obs straight into an output row (this is what EnvSet uses)
+		// Returns the size of the obs, nothing is written if it doesn't match outSize
+		// Override this to avoid allocating an FList per player per step
+		virtual size_t BuildObsInto(const Player& player, const GameState& state, float* out, size_t outSize) {
+			FList obs = BuildObs(player, state);
+			if (obs.size() == outSize)
+				memcpy(out, obs.data(), outSize * sizeof(float));
+			return obs.size();
+		}
+
+		virtual ~ObsBuilder() {}
 	};
 }
\ No newline at end of file
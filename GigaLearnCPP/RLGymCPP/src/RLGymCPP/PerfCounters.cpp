@@ -0,0 +1,108 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+RLGC::PerfCounters::PerfCounters() {
+	for (int& fd : fds)
+		fd = -1;
+
+#ifdef __linux__
+	struct EventType {
+		uint32_t type;
+		uint64_t config;
+	};
+
+	constexpr EventType EVENT_TYPES[COUNTER_AMOUNT] = {
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+		{
+			PERF_TYPE_HW_CACHE,
+			PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+		},
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+	};
+
+	for (int i = 0; i < COUNTER_AMOUNT; i++) {
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = EVENT_TYPES[i].type;
+		attr.config = EVENT_TYPES[i].config;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		// Calling thread, any CPU, no group
+		fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+		if (fds[i] < 0) {
+			if (!error.empty())
+				error += ", ";
+			error += RS_STR(COUNTER_NAMES[i] << ": " << strerror(errno));
+		}
+	}
+
+	if (!error.empty())
+		error = "Failed to open perf counters (" + error + ")";
+#else
+	error = "Perf counters are only supported on Linux";
+#endif
+}
+
+RLGC::PerfCounters::~PerfCounters() {
+#ifdef __linux__
+	for (int fd : fds)
+		if (fd >= 0)
+			close(fd);
+#endif
+}
+
+void RLGC::PerfCounters::Start() {
+#ifdef __linux__
+	for (int fd : fds)
+		if (fd >= 0)
+			ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+void RLGC::PerfCounters::Stop() {
+#ifdef __linux__
+	for (int fd : fds)
+		if (fd >= 0)
+			ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+}
+
+RLGC::PerfCounters::Values RLGC::PerfCounters::Read() const {
+	Values result;
+	for (int i = 0; i < COUNTER_AMOUNT; i++) {
+		result.counts[i] = -1;
+
+#ifdef __linux__
+		if (fds[i] < 0)
+			continue;
+
+		uint64_t data[3]; // Value, time enabled, time running
+		if (read(fds[i], data, sizeof(data)) != sizeof(data))
+			continue;
+
+		if (data[2] == 0) {
+			// Never got scheduled on the PMU
+			result.counts[i] = data[1] == 0 ? 0 : -1;
+		} else if (data[2] < data[1]) {
+			// Multiplexed with other counters, extrapolate to the full time
+			result.counts[i] = (int64_t)(data[0] * ((double)data[1] / data[2]));
+		} else {
+			result.counts[i] = data[0];
+		}
+#endif
+	}
+	return result;
+}
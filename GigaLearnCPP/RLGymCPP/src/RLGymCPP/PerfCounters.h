@@ -0,0 +1,63 @@
+#pragma once
+#include "Framework.h"
+
+namespace RLGC {
+	// Hardware performance counters for the calling thread, using Linux perf_event_open()
+	// Only user-space events are counted, so this works without root as long as kernel.perf_event_paranoid <= 2
+	// Counters the CPU/kernel doesn't support (common in VMs) are reported as unavailable, the rest still work
+	// On other platforms, every counter is unavailable
+	struct PerfCounters {
+		enum Counter {
+			CYCLES,
+			INSTRUCTIONS,
+			L1D_MISSES, // L1 data cache read misses
+			LLC_MISSES, // Last level cache misses
+			BRANCH_MISSES,
+
+			COUNTER_AMOUNT
+		};
+
+		static constexpr const char* COUNTER_NAMES[COUNTER_AMOUNT] = {
+			"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"
+		};
+
+		struct Values {
+			// Accumulated counts, -1 if unavailable
+			// Scaled up if the kernel had to multiplex counters
+			int64_t counts[COUNTER_AMOUNT];
+
+			int64_t operator[](Counter counter) const {
+				return counts[counter];
+			}
+		};
+
+		int fds[COUNTER_AMOUNT];
+
+		// Why counters are unavailable, empty if all were opened
+		std::string error = {};
+
+		// Opens the counters for the calling thread, they only count between Start() and Stop()
+		// Must be used from the thread that created it
+		PerfCounters();
+		~PerfCounters();
+
+		RG_NO_COPY(PerfCounters);
+
+		bool IsAvailable(Counter counter) const {
+			return fds[counter] >= 0;
+		}
+
+		bool AnyAvailable() const {
+			for (int fd : fds)
+				if (fd >= 0)
+					return true;
+			return false;
+		}
+
+		void Start();
+		void Stop();
+
+		// Counts accumulated over every Start()/Stop() since creation
+		Values Read() const;
+	};
+}
@@ -0,0 +1,139 @@
+#include "Profiler.h"
+
+using namespace RLGC;
+
+std::atomic<bool> Profiler::g_Enabled = false;
+
+static std::atomic<uint64_t> g_Gen = 0;
+static const auto g_StartTime = std::chrono::steady_clock::now();
+
+// Buffers are never freed, so buffers of exited threads can still be written out
+static std::mutex g_BuffersMutex = {};
+static std::vector<Profiler::ThreadBuffer*> g_Buffers = {};
+
+static thread_local Profiler::ThreadBuffer* t_Buffer = NULL;
+
+static Profiler::ThreadBuffer* GetThreadBuffer() {
+	if (!t_Buffer) {
+		std::lock_guard<std::mutex> lock(g_BuffersMutex);
+		t_Buffer = new Profiler::ThreadBuffer(g_Buffers.size());
+		g_Buffers.push_back(t_Buffer);
+	}
+	return t_Buffer;
+}
+
+int64_t RLGC::Profiler::GetTimeNs() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_StartTime).count();
+}
+
+void RLGC::Profiler::AddEvent(const char* name, int64_t startNs, int64_t endNs) {
+	ThreadBuffer* buffer = GetThreadBuffer();
+
+	uint64_t gen = g_Gen.load(std::memory_order_relaxed);
+	uint32_t idx;
+	if (buffer->gen.load(std::memory_order_relaxed) != gen) {
+		// First event of this recording, discard old ones
+		buffer->numDropped = 0;
+		buffer->gen.store(gen, std::memory_order_relaxed);
+		idx = 0;
+	} else {
+		idx = buffer->numEvents.load(std::memory_order_relaxed);
+	}
+
+	int blockIdx = idx / EVENTS_PER_BLOCK;
+	if (blockIdx >= MAX_BLOCKS_PER_THREAD) {
+		buffer->numDropped++;
+		return;
+	}
+
+	Event* block = buffer->blocks[blockIdx].load(std::memory_order_relaxed);
+	if (!block) {
+		block = new Event[EVENTS_PER_BLOCK];
+		buffer->blocks[blockIdx].store(block, std::memory_order_relaxed);
+	}
+
+	block[idx % EVENTS_PER_BLOCK] = { name, startNs, endNs };
+	buffer->numEvents.store(idx + 1, std::memory_order_release);
+}
+
+void RLGC::Profiler::SetThreadName(const std::string& name) {
+	ThreadBuffer* buffer = GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(g_BuffersMutex);
+	buffer->threadName = name;
+}
+
+void RLGC::Profiler::Start() {
+	g_Gen++;
+	g_Enabled = true;
+}
+
+void RLGC::Profiler::Stop() {
+	g_Enabled = false;
+}
+
+static void WriteJSONString(std::ostream& out, const char* str) {
+	out << '"';
+	for (const char* c = str; *c; c++) {
+		if (*c == '"' || *c == '\\') {
+			out << '\\' << *c;
+		} else if ((unsigned char)*c < 0x20) {
+			out << ' ';
+		} else {
+			out << *c;
+		}
+	}
+	out << '"';
+}
+
+void RLGC::Profiler::WriteChromeTrace(std::filesystem::path path) {
+	if (path.has_parent_path())
+		std::filesystem::create_directories(path.parent_path());
+
+	std::ofstream fileOut(path);
+	if (!fileOut.good())
+		RG_ERR_CLOSE("Profiler::WriteChromeTrace(): Failed to open " << path);
+
+	std::lock_guard<std::mutex> lock(g_BuffersMutex);
+	uint64_t gen = g_Gen.load();
+
+	fileOut << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	fileOut << std::fixed << std::setprecision(3);
+
+	bool first = true;
+	size_t totalEvents = 0;
+	uint64_t totalDropped = 0;
+	for (ThreadBuffer* buffer : g_Buffers) {
+		if (buffer->gen.load() != gen)
+			continue;
+
+		uint32_t numEvents = buffer->numEvents.load(std::memory_order_acquire);
+		if (numEvents == 0)
+			continue;
+
+		std::string threadName = buffer->threadName.empty() ? ("Thread " + std::to_string(buffer->tid)) : buffer->threadName;
+		if (!first)
+			fileOut << ",\n";
+		first = false;
+		fileOut << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+		WriteJSONString(fileOut, threadName.c_str());
+		fileOut << "}}";
+
+		for (uint32_t i = 0; i < numEvents; i++) {
+			Event& event = buffer->blocks[i / EVENTS_PER_BLOCK].load(std::memory_order_relaxed)[i % EVENTS_PER_BLOCK];
+			fileOut << ",\n{\"name\":";
+			WriteJSONString(fileOut, event.name);
+			fileOut << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->tid
+				<< ",\"ts\":" << (event.startNs / 1000.0)
+				<< ",\"dur\":" << ((event.endNs - event.startNs) / 1000.0) << "}";
+		}
+
+		totalEvents += numEvents;
+		totalDropped += buffer->numDropped;
+	}
+
+	fileOut << "\n]}\n";
+
+	RG_LOG("Profiler: Wrote " << totalEvents << " events to " << path);
+	if (totalDropped > 0)
+		RG_LOG(" > WARNING: " << totalDropped << " events were dropped because a thread's buffer was full");
+}
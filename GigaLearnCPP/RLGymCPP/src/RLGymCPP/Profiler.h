@@ -0,0 +1,88 @@
+#pragma once
+#include "Framework.h"
+
+// Scoped-zone profiler that dumps Chrome trace JSON (open in chrome://tracing or https://ui.perfetto.dev)
+// Usage: RG_PROFILE_SCOPE("Name") records the rest of the current scope as a zone on the current thread
+// Names must be string literals (or otherwise outlive the trace)
+//
+// Each thread records into its own buffer, which only that thread writes to, so recording never takes a lock
+// When not recording, a zone costs one relaxed atomic load
+// Define RG_NO_PROFILER to compile all zones out
+
+namespace RLGC {
+	namespace Profiler {
+		struct Event {
+			const char* name;
+			int64_t startNs, endNs;
+		};
+
+		constexpr int EVENTS_PER_BLOCK = 4096;
+		constexpr int MAX_BLOCKS_PER_THREAD = 1024;
+
+		struct ThreadBuffer {
+			int tid;
+			std::string threadName = {};
+
+			// Generation this buffer was last written in, events from older generations are stale
+			std::atomic<uint64_t> gen = 0;
+			std::atomic<uint32_t> numEvents = 0;
+			uint64_t numDropped = 0;
+
+			// Blocks are allocated by the owning thread as needed and kept for reuse
+			std::atomic<Event*> blocks[MAX_BLOCKS_PER_THREAD] = {};
+
+			ThreadBuffer(int tid) : tid(tid) {}
+
+			RG_NO_COPY(ThreadBuffer);
+		};
+
+		extern std::atomic<bool> g_Enabled;
+
+		inline bool IsRecording() {
+			return g_Enabled.load(std::memory_order_relaxed);
+		}
+
+		int64_t GetTimeNs();
+
+		// Adds a finished zone to the current thread's buffer
+		void AddEvent(const char* name, int64_t startNs, int64_t endNs);
+
+		// Sets the name of the current thread in the trace
+		void SetThreadName(const std::string& name);
+
+		// Clears previously recorded events and starts recording
+		void Start();
+
+		// Stops recording, events are kept until the next Start()
+		void Stop();
+
+		// Writes the events from the last recording as Chrome trace JSON
+		// Should only be called once all zones have ended (e.g. between iterations), as it reads every thread's buffer
+		void WriteChromeTrace(std::filesystem::path path);
+
+		struct Zone {
+			const char* name;
+			int64_t startNs;
+
+			Zone(const char* name) : name(name) {
+				startNs = IsRecording() ? GetTimeNs() : -1;
+			}
+
+			~Zone() {
+				if (startNs >= 0)
+					AddEvent(name, startNs, GetTimeNs());
+			}
+
+			RG_NO_COPY(Zone);
+		};
+	}
+}
+
+#define _RG_PROFILE_CONCAT2(a, b) a##b
+#define _RG_PROFILE_CONCAT(a, b) _RG_PROFILE_CONCAT2(a, b)
+
+#ifndef RG_NO_PROFILER
+#define RG_PROFILE_SCOPE(name) RLGC::Profiler::Zone _RG_PROFILE_CONCAT(_profileZone, __LINE__)(name)
+#else
+#define RG_PROFILE_SCOPE(name) {}
+#endif
@@ -0,0 +1,86 @@
+#pragma once
+#include "Reward.h"
+#include "../Gamestates/StateBatch.h"
+
+namespace RLGC {
+
+	// A reward that is evaluated once per step for all arenas of an EnvSet at once
+	// Instead of being called per-player, it receives a columnar snapshot of every arena (see StateBatch)
+	//	and writes all rewards in one go, which lets simple rewards be written as flat vectorizable loops
+	// NOTE: One instance is shared between all arenas
+	class BatchedReward {
+	private:
+		std::string _cachedName = {};
+
+	public:
+		// Called once by the EnvSet before any other function
+		virtual void Init(int numArenas) {}
+
+		// Called when an arena is reset
+		// NOTE: Arenas can be reset concurrently, so only touch data belonging to arenaIdx
+		virtual void Reset(int arenaIdx, const GameState& initialState) {}
+
+		// Called once per step for each range of arenas, before GetAllRewards() on that range
+		// NOTE: Ranges are evaluated concurrently, so only touch data belonging to the range's arenas
+		virtual void PreStep(const StateBatch& batch, const StateBatch::Range& range) {}
+
+		// Write the reward of each player in the range to output, at the player's row (range.playerStart to range.playerEnd)
+		virtual void GetAllRewards(const StateBatch& batch, const StateBatch::Range& range, float* output) = 0;
+
+		virtual std::string GetName() {
+			if (_cachedName.empty())
+				_cachedName = TrimRewardTypeName(typeid(*this).name());
+			return _cachedName;
+		}
+
+		virtual ~BatchedReward() {};
+	};
+
+	struct WeightedBatchedReward {
+		BatchedReward* reward;
+		float weight;
+
+		WeightedBatchedReward(BatchedReward* reward, float scale) : reward(reward), weight(scale) {}
+		WeightedBatchedReward(BatchedReward* reward, int scale) : reward(reward), weight(scale) {}
+	};
+
+	// Runs a regular per-player reward through the batched interface
+	// Since regular rewards can hold per-arena state, one instance is made per arena
+	class BatchedRewardAdapter : public BatchedReward {
+	public:
+		std::function<Reward*()> rewardCreateFn;
+		std::vector<Reward*> arenaRewards;
+
+		BatchedRewardAdapter(std::function<Reward*()> rewardCreateFn) : rewardCreateFn(rewardCreateFn) {}
+
+		RG_NO_COPY(BatchedRewardAdapter);
+
+		virtual void Init(int numArenas) override {
+			for (int i = arenaRewards.size(); i < numArenas; i++)
+				arenaRewards.push_back(rewardCreateFn());
+		}
+
+		virtual void Reset(int arenaIdx, const GameState& initialState) override {
+			arenaRewards[arenaIdx]->Reset(initialState);
+		}
+
+		virtual void PreStep(const StateBatch& batch, const StateBatch::Range& range) override {
+			for (int i = range.arenaStart; i < range.arenaEnd; i++)
+				arenaRewards[i]->PreStep(*batch.gameStates[i]);
+		}
+
+		virtual void GetAllRewards(const StateBatch& batch, const StateBatch::Range& range, float* output) override {
+			for (int i = range.arenaStart; i < range.arenaEnd; i++)
+				arenaRewards[i]->GetAllRewardsInPlace(*batch.gameStates[i], batch.isFinal[i], output + batch.arenaPlayerStartIdx[i]);
+		}
+
+		virtual std::string GetName() override {
+			return arenaRewards.empty() ? BatchedReward::GetName() : arenaRewards[0]->GetName();
+		}
+
+		virtual ~BatchedRewardAdapter() {
+			for (Reward* reward : arenaRewards)
+				delete reward;
+		}
+	};
+}
@@ -0,0 +1,212 @@
+#pragma once
+#include "BatchedReward.h"
+#include "../Math.h"
+
+// Batched versions of the stateless rewards in CommonRewards.h
+// Each one produces the same values as its per-player counterpart
+namespace RLGC {
+
+	template<std::vector<uint8_t> StateBatch::* COLUMN, bool NEGATIVE>
+	class BatchedEventReward : public BatchedReward {
+	public:
+		virtual void GetAllRewards(const StateBatch& batch, const StateBatch::Range& range, float* output) override {
+			const uint8_t* vals = (batch.*COLUMN).data();
+			const float scale = NEGATIVE ? -1 : 1;
+			for (int i = range.playerStart; i < range.playerEnd; i++)
+				output[i] = vals[i] * scale;
+		}
+	};
+
+	typedef BatchedEventReward<&StateBatch::eventGoal, false> BatchedPlayerGoalReward;
+	typedef BatchedEventReward<&StateBatch::eventAssist, false> BatchedAssistReward;
+	typedef BatchedEventReward<&StateBatch::eventShot, false> BatchedShotReward;
+	typedef BatchedEventReward<&StateBatch::eventShotPass, false> BatchedShotPassReward;
+	typedef BatchedEventReward<&StateBatch::eventSave, false> BatchedSaveReward;
+	typedef BatchedEventReward<&StateBatch::eventBump, false> BatchedBumpReward;
+	typedef BatchedEventReward<&StateBatch::eventBumped, true> BatchedBumpedPenalty;
+	typedef BatchedEventReward<&StateBatch::eventDemo, false> BatchedDemoReward;
+	typedef BatchedEventReward<&StateBatch::eventDemoed, true> BatchedDemoedPenalty;
+
+	// See GoalReward
+	class BatchedGoalReward : public BatchedReward {
+	public:
+		float concedeScale;
+		BatchedGoalReward(float concedeScale = -1) : concedeScale(concedeScale) {}
+
+		virtual void GetAllRewards(const StateBatch& batch, const StateBatch::Range& range, float* output) override {
+			for (int i = range.playerStart; i < range.playerEnd; i++) {
+				int arenaIdx = batch.arenaIdx[i];
+				if (!batch.goalScored[arenaIdx]) {
+					output[i] = 0;
+					continue;
+				}
+
+				bool scored = (batch.team[i] != (uint8_t)RS_TEAM_FROM_Y(batch.ballPos.y[arenaIdx]));
+				output[i] = scored ? 1 : concedeScale;
+			}
+		}
+	};
+
+	// See VelocityReward
+	class BatchedVelocityReward : public BatchedReward {
+	public:
+		bool isNegative;
+		BatchedVelocityReward(bool isNegative = false) : isNegative(isNegative) {}
+
+		virtual void GetAllRewards(const StateBatch& batch, const StateBatch::Range& range, float* output) override {
+			const float* vx = batch.vel.x.data();
+			const float* vy = batch.vel.y.data();
+			const float* vz = batch.vel.z.data();
+			const float scale = (1 - 2 * isNegative) / CommonValues::CAR_MAX_SPEED;
+			for (int i = range.playerStart; i < range.playerEnd; i++)
+				output[i] = sqrtf(vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i]) * scale;
+		}
+	};
+
+	// See SpeedReward
+	class BatchedSpeedReward : public BatchedVelocityReward {
+	public:
+		BatchedSpeedReward() : BatchedVelocityReward(false) {}
+	};
+
+	// See VelocityBallToGoalReward
+	class BatchedVelocityBallToGoalReward : public BatchedReward {
+	public:
+		bool ownGoal = false;
+		BatchedVelocityBallToGoalReward(bool ownGoal = false) : ownGoal(ownGoal) {}
+
+		// Reward for targeting the orange and blue goal, per arena
+		std::vector<float> _arenaRewards[2];
+
+		virtual void Init(int numArenas) override {
+			for (auto& rewards : _arenaRewards)
+				rewards.resize(numArenas);
+		}
+
+		virtual void GetAllRewards(const StateBatch& batch, const StateBatch::Range& range, float* output) override {
+			// Only depends on the ball and the target goal, so compute per-arena first
+			for (int t = 0; t < 2; t++) {
+				Vec targetPos = (t == 0) ? CommonValues::ORANGE_GOAL_BACK : CommonValues::BLUE_GOAL_BACK;
+				for (int i = range.arenaStart; i < range.arenaEnd; i++) {
+					Vec ballDirToGoal = (targetPos - batch.ballPos.Get(i)).Normalized();
+					_arenaRewards[t][i] = ballDirToGoal.Dot(batch.ballVel.Get(i) / CommonValues::BALL_MAX_SPEED);
+				}
+			}
+
+			for (int i = range.playerStart; i < range.playerEnd; i++) {
+				bool targetOrangeGoal = (batch.team[i] == (uint8_t)Team::BLUE) != ownGoal;
+				output[i] = _arenaRewards[targetOrangeGoal ? 0 : 1][batch.arenaIdx[i]];
+			}
+		}
+	};
+
+	// See VelocityPlayerToBallReward
+	class BatchedVelocityPlayerToBallReward : public BatchedReward {
+	public:
+		virtual void GetAllRewards(const StateBatch& batch, const StateBatch::Range& range, float* output) override {
+			for (int i = range.playerStart; i < range.playerEnd; i++) {
+				int arenaIdx = batch.arenaIdx[i];
+				float dx = batch.ballPos.x[arenaIdx] - batch.pos.x[i];
+				float dy = batch.ballPos.y[arenaIdx] - batch.pos.y[i];
+				float dz = batch.ballPos.z[arenaIdx] - batch.pos.z[i];
+				float dist = sqrtf(dx * dx + dy * dy + dz * dz);
+				float dot = dx * batch.vel.x[i] + dy * batch.vel.y[i] + dz * batch.vel.z[i];
+				output[i] = (dist > 0) ? (dot / (dist * CommonValues::CAR_MAX_SPEED)) : 0;
+			}
+		}
+	};
+
+	// See FaceBallReward
+	class BatchedFaceBallReward : public BatchedReward {
+	public:
+		virtual void GetAllRewards(const StateBatch& batch, const StateBatch::Range& range, float* output) override {
+			for (int i = range.playerStart; i < range.playerEnd; i++) {
+				int arenaIdx = batch.arenaIdx[i];
+				float dx = batch.ballPos.x[arenaIdx] - batch.pos.x[i];
+				float dy = batch.ballPos.y[arenaIdx] - batch.pos.y[i];
+				float dz = batch.ballPos.z[arenaIdx] - batch.pos.z[i];
+				float dist = sqrtf(dx * dx + dy * dy + dz * dz);
+				float dot = dx * batch.forward.x[i] + dy * batch.forward.y[i] + dz * batch.forward.z[i];
+				output[i] = (dist > 0) ? (dot / dist) : 0;
+			}
+		}
+	};
+
+	// See TouchBallReward
+	class BatchedTouchBallReward : public BatchedReward {
+	public:
+		virtual void GetAllRewards(const StateBatch& batch, const StateBatch::Range& range, float* output) override {
+			const uint8_t* touched = batch.ballTouchedStep.data();
+			for (int i = range.playerStart; i < range.playerEnd; i++)
+				output[i] = touched[i];
+		}
+	};
+
+	// See WavedashReward
+	class BatchedWavedashReward : public BatchedReward {
+	public:
+		virtual void GetAllRewards(const StateBatch& batch, const StateBatch::Range& range, float* output) override {
+			for (int i = range.playerStart; i < range.playerEnd; i++)
+				output[i] = batch.isOnGround[i] && batch.prevIsFlipping[i] && !batch.prevIsOnGround[i];
+		}
+	};
+
+	// See PickupBoostReward
+	class BatchedPickupBoostReward : public BatchedReward {
+	public:
+		virtual void GetAllRewards(const StateBatch& batch, const StateBatch::Range& range, float* output) override {
+			const float* boost = batch.boost.data();
+			const float* prevBoost = batch.prevBoost.data();
+			for (int i = range.playerStart; i < range.playerEnd; i++) {
+				float delta = sqrtf(boost[i] / 100.f) - sqrtf(prevBoost[i] / 100.f);
+				output[i] = RS_MAX(delta, 0);
+			}
+		}
+	};
+
+	// See SaveBoostReward
+	class BatchedSaveBoostReward : public BatchedReward {
+	public:
+		float exponent;
+		BatchedSaveBoostReward(float exponent = 0.5f) : exponent(exponent) {}
+
+		virtual void GetAllRewards(const StateBatch& batch, const StateBatch::Range& range, float* output) override {
+			const float* boost = batch.boost.data();
+			for (int i = range.playerStart; i < range.playerEnd; i++)
+				output[i] = RS_CLAMP(powf(boost[i] / 100, exponent), 0, 1);
+		}
+	};
+
+	// See AirReward
+	class BatchedAirReward : public BatchedReward {
+	public:
+		virtual void GetAllRewards(const StateBatch& batch, const StateBatch::Range& range, float* output) override {
+			const uint8_t* onGround = batch.isOnGround.data();
+			for (int i = range.playerStart; i < range.playerEnd; i++)
+				output[i] = !onGround[i];
+		}
+	};
+
+	// See StrongTouchReward
+	class BatchedStrongTouchReward : public BatchedReward {
+	public:
+		float minRewardedVel, maxRewardedVel;
+		BatchedStrongTouchReward(float minSpeedKPH = 20, float maxSpeedKPH = 130) {
+			minRewardedVel = RLGC::Math::KPHToVel(minSpeedKPH);
+			maxRewardedVel = RLGC::Math::KPHToVel(maxSpeedKPH);
+		}
+
+		virtual void GetAllRewards(const StateBatch& batch, const StateBatch::Range& range, float* output) override {
+			for (int i = range.playerStart; i < range.playerEnd; i++) {
+				int arenaIdx = batch.arenaIdx[i];
+				if (!batch.ballTouchedStep[i] || !batch.hasPrev[arenaIdx]) {
+					output[i] = 0;
+					continue;
+				}
+
+				float hitForce = (batch.ballVel.Get(arenaIdx) - batch.prevBallVel.Get(arenaIdx)).Length();
+				output[i] = (hitForce < minRewardedVel) ? 0 : RS_MIN(1, hitForce / maxRewardedVel);
+			}
+		}
+	};
+}
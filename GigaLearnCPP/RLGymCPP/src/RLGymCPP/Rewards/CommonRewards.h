@@ -49,7 +49,8 @@ namespace RLGC {
 		bool isNegative;
 		VelocityReward(bool isNegative = false) : isNegative(isNegative) {}
 		virtual float GetReward(const Player& player, const GameState& state, bool isFinal) {
-			return player.vel.Length() / CommonValues::CAR_MAX_SPEED * (1 - 2 * isNegative);
+			float speed = state.GetFeatures().players[player.index].speed;
+			return speed / CommonValues::CAR_MAX_SPEED * (1 - 2 * isNegative);
 		}
 	};
 
@@ -60,13 +61,8 @@ namespace RLGC {
 		VelocityBallToGoalReward(bool ownGoal = false) : ownGoal(ownGoal) {}
 
 		virtual float GetReward(const Player& player, const GameState& state, bool isFinal) {
-			bool targetOrangeGoal = player.team == Team::BLUE;
-			if (ownGoal)
-				targetOrangeGoal = !targetOrangeGoal;
-
-			Vec targetPos = targetOrangeGoal ? CommonValues::ORANGE_GOAL_BACK : CommonValues::BLUE_GOAL_BACK;
-			
-			Vec ballDirToGoal = (targetPos - state.ball.pos).Normalized();
+			Team targetTeam = ownGoal ? RS_OPPOSITE_TEAM(player.team) : player.team;
+			Vec ballDirToGoal = state.GetFeatures().ballDirToGoal[(int)targetTeam];
 			return ballDirToGoal.Dot(state.ball.vel / CommonValues::BALL_MAX_SPEED);
 		}
 	};
@@ -75,7 +71,7 @@ namespace RLGC {
 	class VelocityPlayerToBallReward : public Reward {
 	public:
 		virtual float GetReward(const Player& player, const GameState& state, bool isFinal) {
-			Vec dirToBall = (state.ball.pos - player.pos).Normalized();
+			const Vec& dirToBall = state.GetFeatures().players[player.index].dirToBall;
 			Vec normVel = player.vel / CommonValues::CAR_MAX_SPEED;
 			return dirToBall.Dot(normVel);
 		}
@@ -85,7 +81,7 @@ namespace RLGC {
 	class FaceBallReward : public Reward {
 	public:
 		virtual float GetReward(const Player& player, const GameState& state, bool isFinal) {
-			Vec dirToBall = (state.ball.pos - player.pos).Normalized();
+			const Vec& dirToBall = state.GetFeatures().players[player.index].dirToBall;
 			return player.rotMat.forward.Dot(dirToBall);
 		}
 	};
@@ -100,7 +96,7 @@ namespace RLGC {
 	class SpeedReward : public Reward {
 	public:
 		virtual float GetReward(const Player& player, const GameState& state, bool isFinal) {
-			return player.vel.Length() / CommonValues::CAR_MAX_SPEED;
+			return state.GetFeatures().players[player.index].speed / CommonValues::CAR_MAX_SPEED;
 		}
 	};
 
@@ -60,16 +60,17 @@ private:
 		TeamAnalysis analysis = {};  // Fixed: explicit initialization
 		int opponentCount = 0;
 		float totalOpponentSpeed = 0.f;
+		const StateFeatures& features = state.GetFeatures();
 
 		for (const auto& p : state.players) {
 			if (p.team == player.team && p.carId != player.carId) {
 				analysis.teammate = &p;
 				analysis.hasTeammate = true;
-				analysis.teammateDistToBall = (p.pos - state.ball.pos).Length();
+				analysis.teammateDistToBall = features.players[p.index].ballDist;
 			}
 			else if (p.team != player.team) {
-				float opponentDist = (p.pos - state.ball.pos).Length();
-				totalOpponentSpeed += p.vel.Length();
+				float opponentDist = features.players[p.index].ballDist;
+				totalOpponentSpeed += features.players[p.index].speed;
 				opponentCount++;
 
 				if (opponentDist < analysis.closestOpponentDist) {
@@ -94,14 +95,15 @@ private:
 	}
 
 	PlayerRole DeterminePlayerRole(const Player& player, const TeamAnalysis& analysis, const GameState& state) {
-		float playerDistToBall = (player.pos - state.ball.pos).Length();
+		const StateFeatures& features = state.GetFeatures();
+		float playerDistToBall = features.players[player.index].ballDist;
 
 		// Factor 1: Distance to ball (40% weight)
 		float distanceScore = (playerDistToBall < analysis.teammateDistToBall) ? 0.4f : 0.f;
 
 		// Factor 2: Speed toward ball (30% weight) - Fixed type issues
-		Vec playerToBall = (state.ball.pos - player.pos).Normalized();
-		Vec teammateToBall = (state.ball.pos - analysis.teammate->pos).Normalized();
+		const Vec& playerToBall = features.players[player.index].dirToBall;
+		const Vec& teammateToBall = features.players[analysis.teammate->index].dirToBall;
 		float playerVelToBall = player.vel.Dot(playerToBall);
 		float teammateVelToBall = analysis.teammate->vel.Dot(teammateToBall);
 		float speedScore = (playerVelToBall > teammateVelToBall) ? 0.3f : 0.f;
@@ -129,13 +131,14 @@ private:
 	}
 
 	float CalculateGoerReward(const Player& player, const TeamAnalysis& analysis, const GameState& state) {
-		float playerDistToBall = (player.pos - state.ball.pos).Length();
+		const PlayerFeatures& playerFeatures = state.GetFeatures().players[player.index];
+		float playerDistToBall = playerFeatures.ballDist;
 
 		// Base reward for being closer than opponents
 		float baseReward = (playerDistToBall < analysis.closestOpponentDist) ? goerReward : -goerReward * 0.5f;
 
 		// Speed differential bonus - Fixed type issues
-		Vec playerToBall = (state.ball.pos - player.pos).Normalized();
+		const Vec& playerToBall = playerFeatures.dirToBall;
 		float playerVelToBall = player.vel.Dot(playerToBall);
 		float speedBonus = RS_CLAMP(playerVelToBall / 2300.f, -0.3f, 0.3f); // Max car speed ~2300
 
@@ -149,7 +152,7 @@ private:
 		}
 
 		// Angle approach bonus (reward straight-line approaches)
-		Vec toBall = (state.ball.pos - player.pos).Normalized();
+		const Vec& toBall = playerFeatures.dirToBall;
 		Vec velocity = player.vel.Normalized();
 		float approachAngle = toBall.Dot(velocity);
 		float angleBonus = RS_MAX(0.f, approachAngle) * 0.2f;
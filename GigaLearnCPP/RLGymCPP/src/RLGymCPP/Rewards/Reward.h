@@ -4,6 +4,23 @@
 
 // https://github.com/AechPro/rocket-league-gym-sim/blob/main/rlgym_sim/utils/reward_functions/reward_function.py
 namespace RLGC {
+	// Turns a typeid() name into a readable class name
+	inline std::string TrimRewardTypeName(std::string rewardName) {
+		// Trim the string to after cetain keys
+		constexpr const char* TRIM_KEYS[] = {
+			"::", // Namespace separator
+			" " // Any spaces
+		};
+		for (const char* key : TRIM_KEYS) {
+			size_t idx = rewardName.rfind(key);
+			if (idx == std::string::npos)
+				continue;
+
+			rewardName.erase(rewardName.begin(), rewardName.begin() + idx + strlen(key));
+		}
+		return rewardName;
+	}
+
 	class Reward {
 	private:
 		std::string _cachedName = {};
@@ -57,22 +74,7 @@ namespace RLGC {
 			if (!_cachedName.empty())
 				return _cachedName;
 
-			std::string rewardName = typeid(*this).name();
-
-			// Trim the string to after cetain keys
-			{
-				constexpr const char* TRIM_KEYS[] = {
-					"::", // Namespace separator
-					" " // Any spaces
-				};
-				for (const char* key : TRIM_KEYS) {
-					size_t idx = rewardName.rfind(key);
-					if (idx == std::string::npos)
-						continue;
-
-					rewardName.erase(rewardName.begin(), rewardName.begin() + idx + strlen(key));
-				}
-			}
+			std::string rewardName = TrimRewardTypeName(typeid(*this).name());
 
 			_cachedName = rewardName;
 			return rewardName;
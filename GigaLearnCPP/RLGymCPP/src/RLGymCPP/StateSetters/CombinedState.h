@@ -31,12 +31,13 @@ namespace RLGC {
 			}
 		}
 
-		void ResetArena(Arena* arena) override {
-			float f = RocketSim::Math::RandFloat(0, totalWeight);
+		using StateSetter::ResetArena;
+		void ResetArena(Arena* arena, RNG& rng) override {
+			float f = rng.RandFloat(0, totalWeight);
 
 			for (int i = 0; i < setters.size(); i++) {
 				if (f <= cumulativeWeights[i]) {
-					setters[i]->ResetArena(arena);
+					setters[i]->ResetArena(arena, rng);
 					return;
 				}
 			}
@@ -14,13 +14,14 @@ namespace RLGC {
 			"FuzzedKickoffState::FUZZ_POS_RANGE range is too small to survive float rounding"
 		);
 
-		void ResetArena(Arena* arena) {
-			arena->ResetToRandomKickoff();
+		using StateSetter::ResetArena;
+		void ResetArena(Arena* arena, RNG& rng) override {
+			arena->ResetToRandomKickoff(rng.RandInt(0, INT_MAX));
 
 			for (auto& car : arena->_cars) {
 				auto state = car->GetState();
 				for (int i = 0; i < 3; i++)
-					state.pos[i] += RocketSim::Math::RandFloat(-FUZZ_POS_RANGE, FUZZ_POS_RANGE);
+					state.pos[i] += rng.RandFloat(-FUZZ_POS_RANGE, FUZZ_POS_RANGE);
 				car->SetState(state);
 			}
 		}
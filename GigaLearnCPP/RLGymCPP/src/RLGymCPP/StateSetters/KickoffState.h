@@ -4,8 +4,9 @@
 namespace RLGC {
 	class KickoffState : public StateSetter {
 	public:
-		void ResetArena(Arena* arena) {
-			arena->ResetToRandomKickoff();
+		using StateSetter::ResetArena;
+		void ResetArena(Arena* arena, RNG& rng) override {
+			arena->ResetToRandomKickoff(rng.RandInt(0, INT_MAX));
 		}
 	};
 }
\ No newline at end of file
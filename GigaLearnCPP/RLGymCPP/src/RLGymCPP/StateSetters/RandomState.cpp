@@ -1,17 +1,13 @@
 #include "RandomState.h"
-#include "../Math.h"
 
-using RocketSim::Math::RandFloat;
-using RLGC::Math::RandVec;
-
-Vec RandNormVec() {
-	return RandVec(Vec(-1, -1, -1), Vec(1, 1, 1)).Normalized();
+static Vec RandNormVec(RLGC::RNG& rng) {
+	return rng.RandVec(Vec(-1, -1, -1), Vec(1, 1, 1)).Normalized();
 }
 
-void RLGC::RandomState::ResetArena(Arena* arena) {
+void RLGC::RandomState::ResetArena(Arena* arena, RNG& rng) {
 	
 	// Reset boost pads and everything
-	arena->ResetToRandomKickoff();
+	arena->ResetToRandomKickoff(rng.RandInt(0, INT_MAX));
 
 	constexpr float
 		X_MAX = 3500,
@@ -25,27 +21,30 @@ void RLGC::RandomState::ResetArena(Arena* arena) {
 
 	{ // Randomize ball
 		BallState bs = {};
-		bs.pos = Math::RandVec(Vec(-X_MAX, -Y_MAX, CommonValues::BALL_RADIUS), Vec(X_MAX, Y_MAX, Z_MAX));
+		bs.pos = rng.RandVec(Vec(-X_MAX, -Y_MAX, CommonValues::BALL_RADIUS), Vec(X_MAX, Y_MAX, Z_MAX));
 		if (randBallSpeed) {
-			bs.vel = RandNormVec() * RandFloat(0, 4000);
-			bs.angVel = Math::RandVec(Vec(-4, -4, -4), Vec(4, 4, 4));
+			bs.vel = RandNormVec(rng) * rng.RandFloat(0, 4000);
+			bs.angVel = rng.RandVec(Vec(-4, -4, -4), Vec(4, 4, 4));
 		}
 		arena->ball->SetState(bs);
 	}
 
 	for (Car* car : arena->_cars) { // Randomize cars
 		CarState cs = {};
-		cs.pos = Math::RandVec(Vec(-X_MAX, -Y_MAX, CAR_Z_MIN), Vec(X_MAX, Y_MAX, Z_MAX));
+		cs.pos = rng.RandVec(Vec(-X_MAX, -Y_MAX, CAR_Z_MIN), Vec(X_MAX, Y_MAX, Z_MAX));
 
 		if (randCarSpeed) {
-			Vec randVelDir = Math::RandVec(Vec(-1, -1, -1), Vec(1, 1, 1)).Normalized();
-			cs.vel = RandNormVec() * RandFloat(0, RLConst::CAR_MAX_SPEED);
-			cs.angVel = RandNormVec() * ANGVEL_MAX;
+			cs.vel = RandNormVec(rng) * rng.RandFloat(0, RLConst::CAR_MAX_SPEED);
+			cs.angVel = RandNormVec(rng) * ANGVEL_MAX;
 		}
 
-		Angle angle = Angle(RandFloat(-YAW_MAX, YAW_MAX), RandFloat(-PITCH_MAX, PITCH_MAX), RandFloat(-ROLL_MAX, ROLL_MAX));
+		// Drawn one at a time so the order doesn't depend on argument evaluation order
+		float yaw = rng.RandFloat(-YAW_MAX, YAW_MAX);
+		float pitch = rng.RandFloat(-PITCH_MAX, PITCH_MAX);
+		float roll = rng.RandFloat(-ROLL_MAX, ROLL_MAX);
+		Angle angle = Angle(yaw, pitch, roll);
 
-		bool onGround = carsOnGround ? true : (RandFloat() > 0.5);
+		bool onGround = carsOnGround ? true : (rng.NextFloat() > 0.5);
 		if (onGround) {
 			cs.pos.z = 17;
 			angle.pitch = angle.roll = 0;
@@ -55,8 +54,8 @@ void RLGC::RandomState::ResetArena(Arena* arena) {
 
 		cs.rotMat = angle.ToRotMat();
 
-		cs.boost = RandFloat(0, 100);
+		cs.boost = rng.RandFloat(0, 100);
 
 		car->SetState(cs);
 	}
-}
\ No newline at end of file
+}
@@ -11,6 +11,7 @@ namespace RLGC {
 			randBallSpeed(randBallSpeed), randCarSpeed(randCarSpeed), carsOnGround(carsOnGround) {
 		}
 
-		virtual void ResetArena(Arena* arena);
+		using StateSetter::ResetArena;
+		virtual void ResetArena(Arena* arena, RNG& rng) override;
 	};
 }
\ No newline at end of file
@@ -1,9 +1,20 @@
 #pragma once
 #include "../Gamestates/GameState.h"
+#include "../BasicTypes/RNG.h"
 
 namespace RLGC {
 	class StateSetter {
 	public:
-		virtual void ResetArena(Arena* arena) = 0;
+		// All randomness should come from rng, which is owned by the arena being reset
+		// This keeps resets reproducible from the seed, no matter which thread runs them
+		virtual void ResetArena(Arena* arena, RNG& rng) = 0;
+
+		// For callers without an RNG, seeds one from RocketSim's global random engine (so it isn't reproducible)
+		// Not virtual, state setters must override the version above
+		// Subclasses should add "using StateSetter::ResetArena;" so this isn't hidden
+		void ResetArena(Arena* arena) {
+			RNG rng = RNG(RocketSim::Math::RandInt(0, INT_MAX));
+			ResetArena(arena, rng);
+		}
 	};
-}
\ No newline at end of file
+}
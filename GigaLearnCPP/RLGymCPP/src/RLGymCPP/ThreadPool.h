@@ -1,5 +1,6 @@
 #pragma once
 #include "Framework.h"
+#include "Profiler.h"
 
 #include <thread_pool.h>
 
@@ -26,10 +27,22 @@ namespace RLGC {
 			_tp->enqueue_detach(func, args...);
 		}
 
-		void StartBatchedJobs(std::function<void(int)> func, int num, bool async) {
+		// Runs the job on one worker (threadIdx is wrapped to the number of threads), so calls with the same index run on the same thread
+		// Other workers can't steal it, so only use this for evenly sized jobs
+		template <typename Function>
+		void StartJobOnThread(int threadIdx, Function&& func) {
+			_tp->enqueue_detach_to(threadIdx, func);
+		}
+
+		// profileName is the name of each job in the profiler trace (see Profiler.h)
+		void StartBatchedJobs(std::function<void(int)> func, int num, bool async, const char* profileName = "ThreadPool Job") {
 
-			for (int i = 0; i < num; i++)
-				StartJobAsync(func, i);
+			for (int i = 0; i < num; i++) {
+				StartJobAsync([func, i, profileName]() {
+					RG_PROFILE_SCOPE(profileName);
+					func(i);
+				});
+			}
 
 			if (!async)
 				WaitUntilDone();
@@ -37,12 +50,23 @@ namespace RLGC {
 		
 		// OPTIMISATION MAJEURE: Batched jobs avec chunks pour rduire l'overhead
 		// Au lieu de crer N jobs, on cre numThreads jobs qui traitent N/numThreads lments chacun
-		void StartBatchedJobsChunked(std::function<void(int)> func, int num, bool async) {
+		void StartBatchedJobsChunked(std::function<void(int)> func, int num, bool async, const char* profileName = "ThreadPool Job") {
 			if (num <= 0) return;
 			
-			// Si peu d'lments, utiliser la mthode standard
+			// Calls with the same num always run each item on the same worker (item or chunk t runs on worker t),
+			//	so memory first touched in one call (e.g. EnvSet construction) is used by the same thread in later calls
+			
+			// Si peu d'lments, un job par lment
 			if (num <= _numThreads * 2) {
-				StartBatchedJobs(func, num, async);
+				for (int i = 0; i < num; i++) {
+					StartJobOnThread(i, [func, i, profileName]() {
+						RG_PROFILE_SCOPE(profileName);
+						func(i);
+					});
+				}
+
+				if (!async)
+					WaitUntilDone();
 				return;
 			}
 			
@@ -55,7 +79,8 @@ namespace RLGC {
 				
 				if (start >= num) break;
 				
-				StartJobAsync([func, start, end]() {
+				StartJobOnThread(t, [func, start, end, profileName]() {
+					RG_PROFILE_SCOPE(profileName);
 					for (int i = start; i < end; i++) {
 						func(i);
 					}
@@ -68,13 +93,16 @@ namespace RLGC {
 		
 		// NOUVELLE FONCTIONNALIT: Parallel for avec range
 		template<typename Func>
-		void ParallelFor(int start, int end, Func&& func, bool async = false) {
+		void ParallelFor(int start, int end, Func&& func, bool async = false, const char* profileName = "ThreadPool Job") {
 			int num = end - start;
 			if (num <= 0) return;
 			
 			if (num <= _numThreads * 2) {
 				for (int i = start; i < end; i++) {
-					StartJobAsync([&func, i]() { func(i); });
+					StartJobAsync([&func, i, profileName]() {
+						RG_PROFILE_SCOPE(profileName);
+						func(i);
+					});
 				}
 			} else {
 				int chunkSize = (num + _numThreads - 1) / _numThreads;
@@ -85,7 +113,8 @@ namespace RLGC {
 					
 					if (chunkStart >= end) break;
 					
-					StartJobAsync([&func, chunkStart, chunkEnd]() {
+					StartJobAsync([&func, chunkStart, chunkEnd, profileName]() {
+						RG_PROFILE_SCOPE(profileName);
 						for (int i = chunkStart; i < chunkEnd; i++) {
 							func(i);
 						}
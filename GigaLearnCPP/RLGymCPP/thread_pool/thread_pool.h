@@ -58,6 +58,13 @@ namespace dp {
                             tasks_[id].signal.acquire();
 
                             do {
+                                // invoke the tasks only this thread can run
+                                while (auto task = tasks_[id].pinned_tasks.pop_front()) {
+                                    unassigned_tasks_.fetch_sub(1, std::memory_order_release);
+                                    std::invoke(std::move(task.value()));
+                                    in_flight_tasks_.fetch_sub(1, std::memory_order_release);
+                                }
+
                                 // invoke the task
                                 while (auto task = tasks_[id].tasks.pop_front()) {
                                     // decrement the unassigned tasks as the task is now going
@@ -223,6 +230,28 @@ namespace dp {
             }));
         }
 
+        /**
+         * @brief Enqueue a task onto a specific thread's queue. Any return value of the function
+         * will be ignored.
+         * @details The task is never stolen by another thread, so it waits for that thread even
+         * if others are idle.
+         * @param thread_index Index of the thread, wrapped to the number of threads.
+         * @param func The callable to be executed
+         */
+        template <typename Function>
+            requires std::invocable<Function>
+        void enqueue_detach_to(std::size_t thread_index, Function &&func) {
+            enqueue_task_to(thread_index % tasks_.size(),
+                            std::move([f = std::forward<Function>(func)]() mutable {
+                                // suppress exceptions
+                                try {
+                                    std::invoke(f);
+                                } catch (...) {
+                                }
+                            }),
+                            true);
+        }
+
         /**
          * @brief Returns the number of threads in the pool.
          *
@@ -253,6 +282,7 @@ namespace dp {
             size_t removed_task_count{0};
             for (auto &task_list : tasks_) {
                 removed_task_count += task_list.tasks.clear();
+                removed_task_count += task_list.pinned_tasks.clear();
             }
             in_flight_tasks_.fetch_sub(removed_task_count, std::memory_order_release);
             unassigned_tasks_.fetch_sub(removed_task_count, std::memory_order_release);
@@ -271,6 +301,11 @@ namespace dp {
             // get the index
             auto i = *(i_opt);
 
+            enqueue_task_to(i, std::forward<Function>(f), false);
+        }
+
+        template <typename Function>
+        void enqueue_task_to(std::size_t i, Function &&f, bool pinned) {
             // increment the unassigned tasks and in flight tasks
             unassigned_tasks_.fetch_add(1, std::memory_order_release);
             const auto prev_in_flight = in_flight_tasks_.fetch_add(1, std::memory_order_release);
@@ -281,12 +316,17 @@ namespace dp {
             }
 
             // assign work
-            tasks_[i].tasks.push_back(std::forward<Function>(f));
+            if (pinned) {
+                tasks_[i].pinned_tasks.push_back(std::forward<Function>(f));
+            } else {
+                tasks_[i].tasks.push_back(std::forward<Function>(f));
+            }
             tasks_[i].signal.release();
         }
 
         struct task_item {
             dp::thread_safe_queue<FunctionType> tasks{};
+            dp::thread_safe_queue<FunctionType> pinned_tasks{};  // can't be stolen
             std::binary_semaphore signal{0};
         };
 
@@ -0,0 +1,41 @@
+import struct
+import sys
+
+# Reads a metrics file written by GGL::MetricFileWriter (see MetricFileWriter.h for the layout)
+# Returns a dict of metric name -> list with one value per iteration (NaN where the metric wasn't reported)
+def read_metrics(path):
+	with open(path, "rb") as f:
+		data = f.read()
+
+	if data[:8] != b"GGLMETRC":
+		raise Exception(f"{path} is not a metrics file")
+	version, = struct.unpack_from("<I", data, 8)
+	if version != 1:
+		raise Exception(f"Unsupported metrics file version {version}")
+
+	columns = []
+	rows = []
+	pos = 12
+	while pos + 5 <= len(data):
+		record_type, count = struct.unpack_from("<cI", data, pos)
+		pos += 5
+		if record_type == b"C":
+			for _ in range(count):
+				name_len, = struct.unpack_from("<H", data, pos)
+				columns.append(data[pos + 2 : pos + 2 + name_len].decode("utf-8", errors = "replace"))
+				pos += 2 + name_len
+		elif record_type == b"R":
+			if pos + count * 8 > len(data):
+				break # Incomplete last row
+			rows.append(struct.unpack_from(f"<{count}d", data, pos))
+			pos += count * 8
+		else:
+			raise Exception(f"Invalid record type {record_type} at byte {pos - 5}")
+
+	nan = float("nan")
+	return { name: [(row[i] if i < len(row) else nan) for row in rows] for i, name in enumerate(columns) }
+
+if __name__ == "__main__":
+	metrics = read_metrics(sys.argv[1])
+	for name, values in metrics.items():
+		print(f"{name}: {len(values)} values, last = {values[-1] if len(values) else None}")
@@ -0,0 +1,178 @@
+import struct
+import sys
+import time
+
+from multiprocessing import shared_memory
+
+# Reads frames from a GGL::RenderRing (see RenderRing.h for the layout) and sends them to the render receiver
+# Runs as its own process, at its own pace, so the training side never waits on rendering:
+#	python -m python_scripts.render_ring_reader [ring name] [time scale]
+
+GAMEMODES = ["soccar", "hoops", "heatseeker", "snowday"]
+
+HEADER_FORMAT = "<8sIIII"
+HEADER_SIZE = 56
+HEADER_WRITE_COUNT_OFFSET = 24
+HEADER_DROPPED_COUNT_OFFSET = 32
+HEADER_READ_COUNT_OFFSET = 40
+HEADER_READER_ATTACHED_OFFSET = 48
+
+SLOT_SIZE = 1096
+FRAME_OFFSET = 8 # After the slot's sequence number
+
+FRAME_HEADER_FORMAT = "<QfBBBx"
+PHYS_FORMAT = "<18f"
+MAX_BOOST_PADS = 36
+PLAYER_FORMAT = "<IBBBBB3xf18f8f"
+PLAYER_SIZE = 120
+MAX_PLAYERS = 8
+
+def phys_to_dict(vals):
+	return {
+		"pos": list(vals[0:3]),
+		"forward": list(vals[3:6]),
+		"right": list(vals[6:9]),
+		"up": list(vals[9:12]),
+		"vel": list(vals[12:15]),
+		"ang_vel": list(vals[15:18]),
+	}
+
+class RenderRingReader:
+	def __init__(self, name):
+		self.shm = shared_memory.SharedMemory(name = name)
+		try:
+			# Before python 3.13 attaching also registers the memory for cleanup, which would delete the writer's ring when we exit
+			from multiprocessing import resource_tracker
+			resource_tracker.unregister(self.shm._name, "shared_memory")
+		except Exception:
+			pass
+
+		self.buf = self.shm.buf
+		magic, version, self.num_slots, slot_size, max_players = struct.unpack_from(HEADER_FORMAT, self.buf, 0)
+		if magic != b"GGLRENDR":
+			raise Exception(f"Shared memory \"{name}\" is not a render ring (yet)")
+		if version != 1 or slot_size != SLOT_SIZE or max_players != MAX_PLAYERS:
+			raise Exception(f"Unsupported render ring (version {version}, slot size {slot_size}, max players {max_players})")
+
+		struct.pack_into("<I", self.buf, HEADER_READER_ATTACHED_OFFSET, 1)
+
+	def close(self):
+		try:
+			struct.pack_into("<I", self.buf, HEADER_READER_ATTACHED_OFFSET, 0)
+		except Exception:
+			pass
+		self.buf = None
+		self.shm.close()
+
+	def get_write_count(self):
+		return struct.unpack_from("<Q", self.buf, HEADER_WRITE_COUNT_OFFSET)[0]
+
+	def get_dropped_count(self):
+		return struct.unpack_from("<Q", self.buf, HEADER_DROPPED_COUNT_OFFSET)[0]
+
+	def set_read_count(self, read_count):
+		struct.pack_into("<Q", self.buf, HEADER_READ_COUNT_OFFSET, read_count)
+
+	# Returns (frame dict, gamemode name, delta time), or None if the frame was overwritten while we copied it
+	def read_frame(self, frame_idx):
+		slot_offset = HEADER_SIZE + (frame_idx % self.num_slots) * SLOT_SIZE
+		expected_seq = frame_idx * 2 + 2
+
+		if struct.unpack_from("<Q", self.buf, slot_offset)[0] != expected_seq:
+			return None
+		data = bytes(self.buf[slot_offset + FRAME_OFFSET : slot_offset + SLOT_SIZE])
+		if struct.unpack_from("<Q", self.buf, slot_offset)[0] != expected_seq:
+			return None
+
+		_, delta_time, gamemode, num_players, num_boost_pads = struct.unpack_from(FRAME_HEADER_FORMAT, data, 0)
+		pos = struct.calcsize(FRAME_HEADER_FORMAT)
+		ball = phys_to_dict(struct.unpack_from(PHYS_FORMAT, data, pos))
+		pos += struct.calcsize(PHYS_FORMAT)
+		boost_pads = [bool(b) for b in data[pos : pos + num_boost_pads]]
+		pos += MAX_BOOST_PADS
+
+		players = []
+		for i in range(num_players):
+			vals = struct.unpack_from(PLAYER_FORMAT, data, pos + i * PLAYER_SIZE)
+			players.append({
+				"car_id": vals[0],
+				"team_num": vals[1],
+				"is_demoed": bool(vals[2]),
+				"on_ground": bool(vals[3]),
+				"ball_touched": bool(vals[4]),
+				"has_flip": bool(vals[5]),
+				"boost_amount": vals[6],
+				"phys": phys_to_dict(vals[7:25]),
+				"action": list(vals[25:33]),
+			})
+
+		gamemode_name = GAMEMODES[gamemode] if gamemode < len(GAMEMODES) else "soccar"
+		return { "ball": ball, "players": players, "boost_pads": boost_pads }, gamemode_name, delta_time
+
+def attach(name):
+	while True:
+		try:
+			return RenderRingReader(name)
+		except Exception:
+			time.sleep(0.5)
+
+def run(name, time_scale = 1.0):
+	from python_scripts import render_receiver
+
+	print(f"Waiting for render ring \"{name}\"...")
+	reader = attach(name)
+	print(f"Attached to render ring \"{name}\" ({reader.num_slots} slots)")
+
+	next_frame = reader.get_write_count()
+	skipped = 0
+	last_frame_time = time.monotonic()
+	last_status_time = time.monotonic()
+
+	while True:
+		write_count = reader.get_write_count()
+
+		if write_count < next_frame:
+			# Writer restarted
+			next_frame = 0
+
+		if next_frame >= write_count:
+			if time.monotonic() - last_frame_time > 5:
+				# The writer might have exited and made a new ring, re-attach to check
+				reader.close()
+				reader = attach(name)
+				next_frame = reader.get_write_count()
+				last_frame_time = time.monotonic()
+			time.sleep(0.002)
+			continue
+
+		# Fell too far behind, jump to the newest frame instead of replaying old ones
+		if write_count - next_frame > reader.num_slots // 2:
+			skipped += write_count - 1 - next_frame
+			next_frame = write_count - 1
+
+		frame = reader.read_frame(next_frame)
+		next_frame += 1
+		reader.set_read_count(next_frame)
+		last_frame_time = time.monotonic()
+
+		if frame is None:
+			skipped += 1
+			continue
+
+		state, gamemode, delta_time = frame
+		try:
+			render_receiver.send_data_to_rsvis(state, gamemode)
+		except Exception as err:
+			print(f"Exception while sending data: {err}")
+
+		if time.monotonic() - last_status_time > 10:
+			print(f"Frames: {next_frame}, skipped by reader: {skipped}, dropped by writer: {reader.get_dropped_count()}")
+			last_status_time = time.monotonic()
+
+		time.sleep(delta_time / time_scale)
+
+if __name__ == "__main__":
+	run(
+		sys.argv[1] if len(sys.argv) > 1 else "gigalearn_render",
+		float(sys.argv[2]) if len(sys.argv) > 2 else 1.0
+	)
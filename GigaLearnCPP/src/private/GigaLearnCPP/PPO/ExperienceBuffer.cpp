@@ -13,6 +13,7 @@ GGL::ExperienceBuffer::ExperienceBuffer(int seed, torch::Device device) :
 }
 
 GGL::ExperienceTensors GGL::ExperienceBuffer::_GetSamples(const int64_t* indices, size_t size) const {
+	RG_PROFILE_SCOPE("ExperienceBuffer::GetSamples");
 	using Clock = std::chrono::high_resolution_clock;
 	auto t0 = Clock::now();
 
@@ -98,6 +99,7 @@ GGL::ExperienceTensors GGL::ExperienceBuffer::_GetSamples(const int64_t* indices
 }
 
 std::vector<GGL::ExperienceTensors> GGL::ExperienceBuffer::GetAllBatchesShuffled(int64_t batchSize, bool overbatching) {
+	RG_PROFILE_SCOPE("ExperienceBuffer::GetAllBatchesShuffled");
 
 	RG_NO_GRAD;
 
@@ -9,6 +9,7 @@ void GGL::GAE::Compute(
 	torch::Tensor& outAdvantages, torch::Tensor& outTargetValues, torch::Tensor& outReturns, float& outRewClipPortion,
 	float gamma, float lambda, float returnStd, float clipRange
 ) {
+	RG_PROFILE_SCOPE("GAE::Compute");
 	const bool hasTruncValPreds = truncValPreds.defined();
 	const int numReturns = static_cast<int>(rews.size(0));
 	
@@ -53,25 +54,11 @@ void GGL::GAE::Compute(
 	thread_local std::vector<float> nextValPreds;
 	thread_local std::vector<float> notDoneNotTruncs;
 	thread_local std::vector<float> normalizedRews;
-	thread_local std::vector<int> truncStepIndices;
 	
 	nextValPreds.resize(numReturns);
 	notDoneNotTruncs.resize(numReturns);
 	
-	// Construire le mapping truncation -> step
-	truncStepIndices.clear();
-	if (hasTruncValPreds) {
-		truncStepIndices.reserve(numTruncs);
-	}
-	
-	// PASSE 1: Construire les truncation indices
-	for (int i = 0; i < numReturns; i++) {
-		if (_terminals[i] == RLGC::TerminalType::TRUNCATED) {
-			truncStepIndices.push_back(i);
-		}
-	}
-	
-	// PASSE 2: Pr-calculer nextValPreds et notDoneNotTruncs
+	// PASSE 1: Pr-calculer nextValPreds et notDoneNotTruncs
 	int truncIdx = 0;
 	for (int step = 0; step < numReturns; step++) {
 		const int8_t terminal = _terminals[step];
@@ -85,15 +72,9 @@ void GGL::GAE::Compute(
 		if (terminal == RLGC::TerminalType::NORMAL) {
 			nextValPreds[step] = 0.0f;
 		} else if (terminal == RLGC::TerminalType::TRUNCATED && hasTruncValPreds) {
-			// Trouver l'index dans truncValPreds
-			int tidx = -1;
-			for (size_t ti = 0; ti < truncStepIndices.size(); ti++) {
-				if (truncStepIndices[ti] == step) {
-					tidx = static_cast<int>(ti);
-					break;
-				}
-			}
-			nextValPreds[step] = (tidx >= 0 && tidx < numTruncs) ? _truncValPreds[tidx] : 0.0f;
+			// Truncated next states are in the same order as the truncated steps
+			nextValPreds[step] = (truncIdx < numTruncs) ? _truncValPreds[truncIdx] : 0.0f;
+			truncIdx++;
 		} else if (step < lastStep) {
 			nextValPreds[step] = _valPreds[step + 1];
 		} else {
@@ -101,7 +82,7 @@ void GGL::GAE::Compute(
 		}
 	}
 
-	// PASSE 3 (optionnelle): Normaliser les rewards
+	// PASSE 2 (optionnelle): Normaliser les rewards
 	float localTotalRew = 0.0f;
 	float localTotalClippedRew = 0.0f;
 	const float* rewardsPtr;
@@ -166,7 +147,7 @@ void GGL::GAE::Compute(
 		rewardsPtr = _rews;
 	}
 
-	// PASSE 4: Boucle principale GAE (doit tre squentielle en arrire)
+	// PASSE 3: Boucle principale GAE (doit tre squentielle en arrire)
 	// OPTIMISATION: Toutes les branches ont t limines grce aux pr-calculs
 	float prevLambda = 0.0f;
 	float prevRet = 0.0f;
@@ -193,8 +174,8 @@ void GGL::GAE::Compute(
 	}
 	
 	// Vrification des truncations
-	if (hasTruncValPreds && truncStepIndices.size() != static_cast<size_t>(numTruncs))
-		RG_ERR_CLOSE("GAE: truncation count mismatch (" << truncStepIndices.size() << "/" << numTruncs << ")");
+	if (hasTruncValPreds && truncIdx != numTruncs)
+		RG_ERR_CLOSE("GAE: truncation count mismatch (" << truncIdx << "/" << numTruncs << ")");
 
 	// OPTIMISATION: Fused addition pour target values avec torch (optimis pour SIMD)
 	outTargetValues = valPreds.slice(0, 0, numReturns) + outAdvantages;
@@ -214,6 +195,7 @@ void GGL::GAE::ComputeGPU(
 	float gamma, float lambda, float returnStd, float clipRange,
 	torch::Device device
 ) {
+	RG_PROFILE_SCOPE("GAE::ComputeGPU");
 	// Pour l'instant, utiliser la version CPU puis transfrer
 	// (la boucle GAE est intrinsquement squentielle)
 	Compute(rews.cpu(), terminals.cpu(), valPreds.cpu(), 
@@ -117,7 +117,8 @@ void GGL::PPOLearner::InferActionsFromModels(
 	ModelSet& models,
 	torch::Tensor obs, torch::Tensor actionMasks, 
 	bool deterministic, float temperature, bool halfPrec,
-	torch::Tensor* outActions, torch::Tensor* outLogProbs) {
+	torch::Tensor* outActions, torch::Tensor* outLogProbs,
+	RLGC::RNG* rng) {
 
 	auto probs = InferPolicyProbsFromModels(models, obs, actionMasks, temperature, halfPrec);
 
@@ -153,13 +154,22 @@ void GGL::PPOLearner::InferActionsFromModels(
 	auto actionsPtr = actionsT.data_ptr<int64_t>();
 	auto logProbsPtr = logProbsT.data_ptr<float>();
 
-	// OPTIMISATION: Thread-local RNG avec meilleur seed
-	static thread_local std::mt19937 gen(std::random_device{}() ^ (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count());
+	// Draw all the random values up front
+	thread_local std::vector<float> randVals;
+	randVals.resize(numRows);
+	if (rng) {
+		rng->FillFloat(randVals.data(), numRows);
+	} else {
+		// OPTIMISATION: Thread-local RNG avec meilleur seed
+		static thread_local std::mt19937 gen(std::random_device{}() ^ (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count());
+		for (int64_t i = 0; i < numRows; i++)
+			randVals[i] = std::uniform_real_distribution<float>(0.0f, 1.0f)(gen);
+	}
 	
 	// OPTIMISATION: Vectorized sampling loop
 	for (int64_t i = 0; i < numRows; i++) {
 		// OPTIMISATION: Single pass cumulative sum + sampling
-		float r = std::uniform_real_distribution<float>(0.0f, 1.0f)(gen);
+		float r = randVals[i];
 		float running = 0.0f;
 		int64_t picked = cols - 1;
 		
@@ -184,7 +194,7 @@ void GGL::PPOLearner::InferActionsFromModels(
 }
 
 void GGL::PPOLearner::InferActions(torch::Tensor obs, torch::Tensor actionMasks, torch::Tensor* outActions, torch::Tensor* outLogProbs, ModelSet* models) {
-	InferActionsFromModels(models ? *models : this->models, obs, actionMasks, config.deterministic, config.policyTemperature, config.useHalfPrecision, outActions, outLogProbs);
+	InferActionsFromModels(models ? *models : this->models, obs, actionMasks, config.deterministic, config.policyTemperature, config.useHalfPrecision, outActions, outLogProbs, &sampleRNG);
 }
 
 torch::Tensor GGL::PPOLearner::InferCritic(torch::Tensor obs) {
@@ -276,6 +286,7 @@ torch::Tensor ComputeEntropy(torch::Tensor probs, torch::Tensor actionMasks, boo
 }
 
 void GGL::PPOLearner::Learn(ExperienceBuffer& experience, Report& report, bool isFirstIteration) {
+	RG_PROFILE_SCOPE("PPOLearner::Learn");
 	std::string stage = "init";
 	int64_t dbgLastActMin = 0;
 	int64_t dbgLastActMax = 0;
@@ -333,6 +344,7 @@ void GGL::PPOLearner::Learn(ExperienceBuffer& experience, Report& report, bool i
 		}
 
 		for (size_t batchIdx = 0; batchIdx < doubleBuffer.Size(); batchIdx++) {
+			RG_PROFILE_SCOPE("PPOLearner::Learn Batch");
 			stage = "batch_loop";
 			
 			// OPTIMISATION: Prefetch le prochain batch pendant qu'on traite le courant
@@ -370,6 +382,7 @@ void GGL::PPOLearner::Learn(ExperienceBuffer& experience, Report& report, bool i
 			}
 
 			auto fnRunMinibatch = [&](int start, int stop) {
+				RG_PROFILE_SCOPE("PPOLearner::Learn Minibatch");
 
 				const float batchSizeRatio = (stop - start) / (float)config.batchSize;
 
@@ -24,6 +24,9 @@ namespace GGL {
 		PPOLearnerConfig config;
 		torch::Device device;
 
+		// Used when sampling actions on the CPU, seeded by the Learner
+		RLGC::RNG sampleRNG = {};
+
 		PPOLearner(
 			int obsSize, int numActions,
 			PPOLearnerConfig config, torch::Device device
@@ -53,7 +56,8 @@ namespace GGL {
 			ModelSet& models, 
 			torch::Tensor obs, torch::Tensor actionMasks, 
 			bool deterministic, float temperature, bool halfPrec,
-			torch::Tensor* outActions, torch::Tensor* outLogProbs
+			torch::Tensor* outActions, torch::Tensor* outLogProbs,
+			RLGC::RNG* rng = NULL // Used for CPU sampling, if null a thread-local generator is used
 		);
 
 		void Learn(ExperienceBuffer& experience, Report& report, bool isFirstIteration);
@@ -24,6 +24,7 @@ GGL::PolicyVersionManager::PolicyVersionManager(
 	if (skill.config.enabled) {
 		RLGC::EnvSetConfig skillEnvSetConfig = envSetConfig;
 		skillEnvSetConfig.numArenas = skill.config.numArenas;
+		skillEnvSetConfig.batchedRewards.clear(); // Shared with the main env set, and rewards aren't needed here
 		skill.envSet = new RLGC::EnvSet(skillEnvSetConfig);
 		for (int i = 0; i < skill.envSet->arenas.size(); i++) {
 			skill.envSet->rewards[i].clear();
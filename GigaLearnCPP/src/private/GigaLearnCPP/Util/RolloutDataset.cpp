@@ -0,0 +1,376 @@
+#include "RolloutDataset.h"
+#include "../PPO/GAE.h"
+
+using namespace GGL;
+
+template <typename T>
+static void WriteVal(std::ostream& out, const T& val) {
+	out.write((const char*)&val, sizeof(T));
+}
+
+template <typename T>
+static T ReadVal(std::istream& in) {
+	T val = {};
+	in.read((char*)&val, sizeof(T));
+	return val;
+}
+
+/////////////////////////////
+// Encoding
+
+// All first bytes of each element, then all second bytes, etc.
+// Similar values then share most of their high bytes, which makes long runs
+static void ShuffleBytes(const uint8_t* src, uint8_t* dst, size_t numBytes, size_t elemSize) {
+	size_t numElems = numBytes / elemSize;
+	for (size_t b = 0; b < elemSize; b++)
+		for (size_t i = 0; i < numElems; i++)
+			dst[b * numElems + i] = src[i * elemSize + b];
+}
+
+static void UnshuffleBytes(const uint8_t* src, uint8_t* dst, size_t numBytes, size_t elemSize) {
+	size_t numElems = numBytes / elemSize;
+	for (size_t b = 0; b < elemSize; b++)
+		for (size_t i = 0; i < numElems; i++)
+			dst[i * elemSize + b] = src[b * numElems + i];
+}
+
+// Mask values are 0 or 1
+static void PackBits(const uint8_t* src, uint8_t* dst, size_t numValues) {
+	memset(dst, 0, (numValues + 7) / 8);
+	for (size_t i = 0; i < numValues; i++)
+		dst[i / 8] |= (src[i] != 0) << (i % 8);
+}
+
+static void UnpackBits(const uint8_t* src, uint8_t* dst, size_t numValues) {
+	for (size_t i = 0; i < numValues; i++)
+		dst[i] = (src[i / 8] >> (i % 8)) & 1;
+}
+
+// PackBits run-length encoding
+// Control byte n: [0, 127] means (n + 1) literal bytes follow, [129, 255] means the next byte is repeated (257 - n) times
+static void EncodeRLE(const uint8_t* src, size_t size, std::vector<uint8_t>& out) {
+	out.clear();
+	out.reserve(size + size / 128 + 1);
+
+	size_t i = 0;
+	while (i < size) {
+		size_t runLen = 1;
+		while (i + runLen < size && runLen < 128 && src[i + runLen] == src[i])
+			runLen++;
+
+		if (runLen >= 3) {
+			out.push_back((uint8_t)(257 - runLen));
+			out.push_back(src[i]);
+			i += runLen;
+			continue;
+		}
+
+		// Literals until the next run of 3 or more
+		size_t litStart = i;
+		while (i < size && i - litStart < 128) {
+			if (i + 2 < size && src[i] == src[i + 1] && src[i] == src[i + 2])
+				break;
+			i++;
+		}
+		size_t litLen = i - litStart;
+		out.push_back((uint8_t)(litLen - 1));
+		out.insert(out.end(), src + litStart, src + i);
+	}
+}
+
+static bool DecodeRLE(const uint8_t* src, size_t size, uint8_t* dst, size_t dstSize) {
+	size_t i = 0, o = 0;
+	while (i < size) {
+		uint8_t n = src[i++];
+		if (n < 128) {
+			size_t len = n + 1;
+			if (i + len > size || o + len > dstSize)
+				return false;
+			memcpy(dst + o, src + i, len);
+			i += len;
+			o += len;
+		} else if (n > 128) {
+			size_t len = 257 - n;
+			if (i >= size || o + len > dstSize)
+				return false;
+			memset(dst + o, src[i++], len);
+			o += len;
+		}
+	}
+	return o == dstSize;
+}
+
+/////////////////////////////
+
+struct ColumnInfo {
+	torch::Tensor RolloutData::* tensor;
+	torch::ScalarType dtype;
+	bool bitPacked;
+};
+
+static const ColumnInfo COLUMN_INFOS[RolloutDataset::COLUMN_AMOUNT] = {
+	{ &RolloutData::states, torch::kFloat32, false },
+	{ &RolloutData::actionMasks, torch::kUInt8, true },
+	{ &RolloutData::actions, torch::kInt32, false },
+	{ &RolloutData::logProbs, torch::kFloat32, false },
+	{ &RolloutData::rewards, torch::kFloat32, false },
+	{ &RolloutData::terminals, torch::kInt8, false },
+	{ &RolloutData::values, torch::kFloat32, false },
+	{ &RolloutData::truncValues, torch::kFloat32, false },
+};
+
+uint64_t GGL::RolloutDataset::WriteFile(std::filesystem::path path, const RolloutData& data, int chunkRows) {
+	RG_ASSERT(chunkRows > 0);
+
+	std::ofstream fileOut(path, std::ios::binary);
+	if (!fileOut.good())
+		RG_ERR_CLOSE("RolloutDataset::WriteFile(): Failed to open " << path);
+
+	int64_t numRows = data.Length();
+	int64_t numTruncRows = data.truncValues.defined() ? data.truncValues.size(0) : 0;
+
+	fileOut.write(MAGIC, sizeof(MAGIC));
+	WriteVal(fileOut, VERSION);
+	WriteVal(fileOut, numRows);
+	WriteVal(fileOut, numTruncRows);
+	WriteVal(fileOut, (uint32_t)data.states.size(1));
+	WriteVal(fileOut, (uint32_t)data.actionMasks.size(1));
+	WriteVal(fileOut, (uint32_t)chunkRows);
+	WriteVal(fileOut, (uint32_t)COLUMN_AMOUNT);
+
+	std::vector<uint8_t> transformed, encoded;
+	for (int col = 0; col < COLUMN_AMOUNT; col++) {
+		const ColumnInfo& info = COLUMN_INFOS[col];
+		torch::Tensor tensor = data.*info.tensor;
+		int64_t colRows = (col == TRUNC_VALUES) ? numTruncRows : numRows;
+		if (colRows > 0) {
+			tensor = tensor.to(torch::kCPU, info.dtype).contiguous();
+			RG_ASSERT(tensor.size(0) == colRows);
+		}
+
+		size_t rowBytes = colRows > 0 ? (tensor.numel() / colRows) * tensor.element_size() : 0;
+		size_t elemSize = colRows > 0 ? tensor.element_size() : 1;
+		uint32_t numChunks = (colRows + chunkRows - 1) / chunkRows;
+		WriteVal(fileOut, numChunks);
+
+		for (uint32_t chunk = 0; chunk < numChunks; chunk++) {
+			int64_t rowStart = (int64_t)chunk * chunkRows;
+			int64_t rowEnd = RS_MIN(rowStart + chunkRows, colRows);
+			const uint8_t* raw = (const uint8_t*)tensor.data_ptr() + rowStart * rowBytes;
+			size_t rawSize = (rowEnd - rowStart) * rowBytes;
+
+			if (info.bitPacked) {
+				transformed.resize((rawSize + 7) / 8);
+				PackBits(raw, transformed.data(), rawSize);
+			} else {
+				transformed.resize(rawSize);
+				ShuffleBytes(raw, transformed.data(), rawSize, elemSize);
+			}
+			EncodeRLE(transformed.data(), transformed.size(), encoded);
+
+			WriteVal(fileOut, (uint64_t)rawSize);
+			WriteVal(fileOut, (uint64_t)encoded.size());
+			fileOut.write((const char*)encoded.data(), encoded.size());
+		}
+	}
+
+	if (!fileOut.good())
+		RG_ERR_CLOSE("RolloutDataset::WriteFile(): Failed to write to " << path);
+
+	return (uint64_t)fileOut.tellp();
+}
+
+RolloutData GGL::RolloutDataset::ReadFile(std::filesystem::path path) {
+	std::ifstream fileIn(path, std::ios::binary);
+	if (!fileIn.good())
+		RG_ERR_CLOSE("RolloutDataset::ReadFile(): Failed to open " << path);
+
+	char magic[sizeof(MAGIC)];
+	fileIn.read(magic, sizeof(magic));
+	uint32_t version = ReadVal<uint32_t>(fileIn);
+	if (!fileIn.good() || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+		RG_ERR_CLOSE("RolloutDataset::ReadFile(): " << path << " is not a rollout file");
+	if (version != VERSION)
+		RG_ERR_CLOSE("RolloutDataset::ReadFile(): " << path << " has version " << version << ", expected " << VERSION);
+
+	int64_t numRows = ReadVal<int64_t>(fileIn);
+	int64_t numTruncRows = ReadVal<int64_t>(fileIn);
+	uint32_t obsSize = ReadVal<uint32_t>(fileIn);
+	uint32_t numActions = ReadVal<uint32_t>(fileIn);
+	ReadVal<uint32_t>(fileIn); // Chunk rows, only needed when writing
+	uint32_t numColumns = ReadVal<uint32_t>(fileIn);
+	if (numColumns != COLUMN_AMOUNT)
+		RG_ERR_CLOSE("RolloutDataset::ReadFile(): " << path << " has " << numColumns << " columns, expected " << COLUMN_AMOUNT);
+
+	RolloutData result = {};
+	for (int col = 0; col < COLUMN_AMOUNT; col++) {
+		const ColumnInfo& info = COLUMN_INFOS[col];
+		auto opts = torch::TensorOptions().dtype(info.dtype);
+		torch::Tensor& tensor = result.*info.tensor;
+		switch (col) {
+		case STATES:
+			tensor = torch::empty({ numRows, obsSize }, opts);
+			break;
+		case ACTION_MASKS:
+			tensor = torch::empty({ numRows, numActions }, opts);
+			break;
+		case TRUNC_VALUES:
+			if (numTruncRows > 0)
+				tensor = torch::empty({ numTruncRows }, opts);
+			break;
+		default:
+			tensor = torch::empty({ numRows }, opts);
+		}
+
+		uint8_t* out = tensor.defined() ? (uint8_t*)tensor.data_ptr() : NULL;
+		size_t totalSize = tensor.defined() ? tensor.numel() * tensor.element_size() : 0;
+		size_t elemSize = tensor.defined() ? tensor.element_size() : 1;
+
+		std::vector<uint8_t> encoded, transformed;
+		size_t offset = 0;
+		uint32_t numChunks = ReadVal<uint32_t>(fileIn);
+		for (uint32_t chunk = 0; chunk < numChunks; chunk++) {
+			uint64_t rawSize = ReadVal<uint64_t>(fileIn);
+			uint64_t encodedSize = ReadVal<uint64_t>(fileIn);
+			if (!fileIn.good() || offset + rawSize > totalSize)
+				RG_ERR_CLOSE("RolloutDataset::ReadFile(): " << path << " is corrupt (column " << col << ", chunk " << chunk << ")");
+
+			encoded.resize(encodedSize);
+			fileIn.read((char*)encoded.data(), encodedSize);
+
+			transformed.resize(info.bitPacked ? (rawSize + 7) / 8 : rawSize);
+			if (!fileIn.good() || !DecodeRLE(encoded.data(), encoded.size(), transformed.data(), transformed.size()))
+				RG_ERR_CLOSE("RolloutDataset::ReadFile(): " << path << " is corrupt (column " << col << ", chunk " << chunk << ")");
+
+			if (info.bitPacked) {
+				UnpackBits(transformed.data(), out + offset, rawSize);
+			} else {
+				UnshuffleBytes(transformed.data(), out + offset, rawSize, elemSize);
+			}
+			offset += rawSize;
+		}
+
+		if (offset != totalSize)
+			RG_ERR_CLOSE("RolloutDataset::ReadFile(): " << path << " is missing data (column " << col << ")");
+	}
+
+	return result;
+}
+
+std::vector<std::filesystem::path> GGL::RolloutDataset::ListFiles(std::filesystem::path folderPath) {
+	std::vector<std::filesystem::path> result = {};
+	if (!std::filesystem::is_directory(folderPath))
+		return result;
+
+	for (auto& entry : std::filesystem::directory_iterator(folderPath))
+		if (entry.is_regular_file() && entry.path().extension() == FILE_EXTENSION)
+			result.push_back(entry.path());
+
+	// Names are zero-padded iteration numbers
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+float GGL::RolloutDataset::LoadIntoExperience(
+	const RolloutData& data, ExperienceBuffer& experience,
+	float gaeGamma, float gaeLambda, float returnStd, float rewardClipRange) {
+
+	torch::Tensor tAdvantages, tTargetVals, tReturns;
+	float rewClipPortion = 0;
+	GAE::Compute(
+		data.rewards, data.terminals, data.values, data.truncValues,
+		tAdvantages, tTargetVals, tReturns, rewClipPortion,
+		gaeGamma, gaeLambda, returnStd, rewardClipRange
+	);
+
+	experience.data.actions = data.actions;
+	experience.data.logProbs = data.logProbs;
+	experience.data.actionMasks = data.actionMasks;
+	experience.data.states = data.states;
+	experience.data.advantages = tAdvantages;
+	experience.data.targetValues = tTargetVals;
+	experience.InvalidateCache();
+
+	return tAdvantages.numel() > 0 ? tAdvantages.abs().mean().item<float>() : 0;
+}
+
+/////////////////////////////
+
+GGL::RolloutDatasetWriter::RolloutDatasetWriter(std::filesystem::path folderPath, int chunkRows, int maxPending) :
+	folderPath(folderPath), chunkRows(chunkRows), maxPending(maxPending) {
+
+	RG_LOG("Initializing RolloutDatasetWriter...");
+	RG_ASSERT(chunkRows > 0 && maxPending > 0);
+
+	std::filesystem::create_directories(folderPath);
+	thread = std::thread(&RolloutDatasetWriter::_RunThread, this);
+
+	RG_LOG(" > Writing rollouts to " << folderPath);
+}
+
+double GGL::RolloutDatasetWriter::Add(uint64_t iteration, RolloutData data) {
+	char fileName[64];
+	snprintf(fileName, sizeof(fileName), "iter_%010llu%s", (unsigned long long)iteration, RolloutDataset::FILE_EXTENSION);
+
+	// The caller's tensors share storage with the experience buffer, which can be modified before we get to writing them
+	for (torch::Tensor* tensor : { &data.states, &data.actionMasks, &data.actions, &data.logProbs, &data.rewards, &data.terminals, &data.values, &data.truncValues })
+		if (tensor->defined())
+			*tensor = tensor->to(torch::kCPU, false, true).contiguous();
+
+	auto startTime = std::chrono::steady_clock::now();
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		cv.wait(lock, [&] { return pending.size() < (size_t)maxPending; });
+		pending.push_back({ folderPath / fileName, std::move(data) });
+	}
+	cv.notify_all();
+
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void GGL::RolloutDatasetWriter::_RunThread() {
+	while (true) {
+		std::pair<std::filesystem::path, RolloutData> job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			cv.wait(lock, [&] { return !pending.empty() || stopping; });
+			if (pending.empty())
+				return;
+			job = pending.front();
+		}
+
+		// Write to a temporary file first, so readers never see a partial file
+		std::filesystem::path tempPath = job.first;
+		tempPath += ".tmp";
+		uint64_t fileBytes = RolloutDataset::WriteFile(tempPath, job.second, chunkRows);
+		std::filesystem::rename(tempPath, job.first);
+
+		uint64_t rawBytes = 0;
+		for (int col = 0; col < RolloutDataset::COLUMN_AMOUNT; col++) {
+			const torch::Tensor& tensor = job.second.*COLUMN_INFOS[col].tensor;
+			if (tensor.defined())
+				rawBytes += tensor.numel() * tensor.element_size();
+		}
+		bytesWritten += fileBytes;
+		rawBytesWritten += rawBytes;
+		filesWritten++;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			pending.pop_front();
+		}
+		cv.notify_all();
+	}
+}
+
+GGL::RolloutDatasetWriter::~RolloutDatasetWriter() {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	cv.notify_all();
+
+	// Finishes writing what's still pending
+	if (thread.joinable())
+		thread.join();
+}
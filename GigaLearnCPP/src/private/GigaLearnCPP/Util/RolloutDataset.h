@@ -0,0 +1,90 @@
+#pragma once
+#include "../FrameworkTorch.h"
+#include "../PPO/ExperienceBuffer.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+namespace GGL {
+
+	// One iteration's rollout, as CPU tensors
+	// States are the normalized obs the policy saw
+	struct RolloutData {
+		torch::Tensor
+			states,       // [N, obsSize] float
+			actionMasks,  // [N, numActions] uint8
+			actions,      // [N] int32
+			logProbs,     // [N] float
+			rewards,      // [N] float
+			terminals,    // [N] int8 (see RLGC::TerminalType)
+			values,       // [N] float, critic predictions
+			truncValues;  // [numTruncated] float, critic predictions for the next states of truncated steps (can be undefined)
+
+		int64_t Length() const {
+			return states.defined() ? states.size(0) : 0;
+		}
+	};
+
+	// Offline rollout files, one per iteration
+	//
+	// File layout (native endianness):
+	//	Header: "GGLROUTS" magic, uint32 version, int64 numRows, int64 numTruncRows, uint32 obsSize, uint32 numActions, uint32 chunkRows, uint32 numColumns
+	//	For each column (in RolloutDataset::Column order): uint32 numChunks, then for each chunk: uint64 rawSize, uint64 encodedSize, then the encoded bytes
+	//		Chunks hold up to chunkRows rows each, so a column can be decoded piece by piece
+	//	Floats and ints are byte-shuffled (all first bytes, then all second bytes, etc.) and then run-length encoded (PackBits)
+	//	Action masks are bit-packed first (8 mask values per byte)
+	namespace RolloutDataset {
+		constexpr char MAGIC[8] = { 'G', 'G', 'L', 'R', 'O', 'U', 'T', 'S' };
+		constexpr uint32_t VERSION = 1;
+		constexpr const char* FILE_EXTENSION = ".ggrollout";
+
+		enum Column : uint32_t {
+			STATES, ACTION_MASKS, ACTIONS, LOG_PROBS, REWARDS, TERMINALS, VALUES, TRUNC_VALUES,
+			COLUMN_AMOUNT
+		};
+
+		// Writes a rollout file synchronously, returns the amount of bytes written
+		uint64_t WriteFile(std::filesystem::path path, const RolloutData& data, int chunkRows);
+
+		RolloutData ReadFile(std::filesystem::path path);
+
+		// All rollout files in a folder, in the order they were written
+		std::vector<std::filesystem::path> ListFiles(std::filesystem::path folderPath);
+
+		// Fills the experience buffer from a rollout, re-running GAE from the stored values and rewards
+		// Returns the mean absolute advantage
+		float LoadIntoExperience(
+			const RolloutData& data, ExperienceBuffer& experience,
+			float gaeGamma, float gaeLambda, float returnStd = 1, float rewardClipRange = 10
+		);
+	}
+
+	// Streams each iteration's rollout to its own file in a folder, from a background thread
+	// The training loop only waits if the writer falls more than maxPending iterations behind
+	struct RolloutDatasetWriter {
+		std::filesystem::path folderPath;
+		int chunkRows;
+		int maxPending;
+
+		std::thread thread;
+		std::mutex mutex;
+		std::condition_variable cv;
+		std::deque<std::pair<std::filesystem::path, RolloutData>> pending;
+		bool stopping = false;
+
+		std::atomic<uint64_t> bytesWritten = 0, rawBytesWritten = 0, filesWritten = 0;
+
+		RolloutDatasetWriter(std::filesystem::path folderPath, int chunkRows, int maxPending = 2);
+		~RolloutDatasetWriter();
+
+		RG_NO_COPY(RolloutDatasetWriter);
+
+		// The tensors are copied, so the caller can keep using them (e.g. for Learn()) while they are written
+		// Returns the time spent waiting for the writer to catch up, in seconds
+		double Add(uint64_t iteration, RolloutData data);
+
+	private:
+		void _RunThread();
+	};
+}
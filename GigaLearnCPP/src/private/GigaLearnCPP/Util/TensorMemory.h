@@ -0,0 +1,72 @@
+#pragma once
+#include "Models.h"
+#include <unordered_set>
+
+namespace GGL {
+	// Sums the bytes of CPU tensor storages, counting each storage once
+	// Views and tensors shared between subsystems are only counted by whichever subsystem is counted first
+	// Storages on other devices (GPU) aren't part of process memory, so they're summed into deviceBytes instead
+	struct TensorMemoryCounter {
+		std::unordered_set<const void*> seenStorages;
+		uint64_t deviceBytes = 0;
+
+		uint64_t Count(const torch::Tensor& tensor) {
+			if (!tensor.defined() || !tensor.has_storage())
+				return 0;
+
+			const c10::Storage& storage = tensor.storage();
+			if (!seenStorages.insert(storage.unsafeGetStorageImpl()).second)
+				return 0;
+
+			if (storage.device().is_cpu()) {
+				return storage.nbytes();
+			} else {
+				deviceBytes += storage.nbytes();
+				return 0;
+			}
+		}
+
+		uint64_t Count(const std::vector<torch::Tensor>& tensors) {
+			uint64_t total = 0;
+			for (auto& tensor : tensors)
+				total += Count(tensor);
+			return total;
+		}
+
+		// Parameters, gradients, buffers, and optimizer state
+		uint64_t Count(Model* model) {
+			uint64_t total = 0;
+			for (auto& param : model->parameters()) {
+				total += Count(param);
+				total += Count(param.grad());
+			}
+			total += Count(model->buffers());
+			if (!model->seqHalf.is_empty())
+				total += Count(model->seqHalf->parameters());
+
+			if (model->optim) {
+				for (auto& pair : model->optim->state()) {
+					auto* state = pair.second.get();
+					if (auto adam = dynamic_cast<torch::optim::AdamParamState*>(state)) {
+						total += Count(adam->exp_avg()) + Count(adam->exp_avg_sq()) + Count(adam->max_exp_avg_sq());
+					} else if (auto adamW = dynamic_cast<torch::optim::AdamWParamState*>(state)) {
+						total += Count(adamW->exp_avg()) + Count(adamW->exp_avg_sq()) + Count(adamW->max_exp_avg_sq());
+					} else if (auto adagrad = dynamic_cast<torch::optim::AdagradParamState*>(state)) {
+						total += Count(adagrad->sum());
+					} else if (auto rmsprop = dynamic_cast<torch::optim::RMSpropParamState*>(state)) {
+						total += Count(rmsprop->square_avg()) + Count(rmsprop->momentum_buffer()) + Count(rmsprop->grad_avg());
+					}
+				}
+			}
+
+			return total;
+		}
+
+		uint64_t Count(ModelSet& models) {
+			uint64_t total = 0;
+			for (Model* model : models)
+				total += Count(model);
+			return total;
+		}
+	};
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <GigaLearnCPP/Framework.h>
+
+namespace GGL {
+	// Picks the next iteration's tsPerItr from how long the last iterations spent collecting and consuming (learning) timesteps
+	// Either targets a ratio of collection time to consumption time, or a total iteration duration
+	// Measurements are smoothed since iteration times are noisy, and each adjustment is limited to maxStepScale
+	struct TsPerItrController {
+		float targetCollectRatio;
+		float targetItrTime; // If above 0, this is targeted instead of targetCollectRatio
+		int64_t minTsPerItr, maxTsPerItr;
+		float maxStepScale;
+
+		// Portion of the previous average kept with each new measurement
+		float smoothing = 0.5f;
+
+		double avgCollectRatio = 0;
+		double avgItrTimePerTs = 0;
+		bool hasMeasurement = false;
+
+		// Warn once tsPerItr has wanted to go past a bound this many iterations in a row, as the target probably can't be reached
+		int saturatedWarnItrs = 10;
+		int numItrsSaturated = 0;
+
+		TsPerItrController(float targetCollectRatio, float targetItrTime, int64_t minTsPerItr, int64_t maxTsPerItr, float maxStepScale) :
+			targetCollectRatio(targetCollectRatio), targetItrTime(targetItrTime),
+			minTsPerItr(minTsPerItr), maxTsPerItr(maxTsPerItr), maxStepScale(maxStepScale) {
+
+			RG_ASSERT(minTsPerItr > 0 && minTsPerItr <= maxTsPerItr);
+			RG_ASSERT(maxStepScale > 1);
+		}
+
+		int64_t Clamp(int64_t tsPerItr) const {
+			return RS_CLAMP(tsPerItr, minTsPerItr, maxTsPerItr);
+		}
+
+		// Returns the tsPerItr to use next
+		int64_t Update(int64_t curTsPerItr, int64_t stepsCollected, float collectionTime, float consumptionTime) {
+			if (stepsCollected <= 0 || collectionTime <= 0 || consumptionTime <= 0)
+				return Clamp(curTsPerItr);
+
+			double collectRatio = collectionTime / consumptionTime;
+			double itrTimePerTs = (collectionTime + consumptionTime) / stepsCollected;
+			if (hasMeasurement) {
+				avgCollectRatio = avgCollectRatio * smoothing + collectRatio * (1 - smoothing);
+				avgItrTimePerTs = avgItrTimePerTs * smoothing + itrTimePerTs * (1 - smoothing);
+			} else {
+				avgCollectRatio = collectRatio;
+				avgItrTimePerTs = itrTimePerTs;
+				hasMeasurement = true;
+			}
+
+			double scale;
+			if (targetItrTime > 0) {
+				// Consumption has a fixed part, so this converges to the target over a few iterations rather than hitting it at once
+				scale = (targetItrTime / avgItrTimePerTs) / curTsPerItr;
+			} else {
+				// Only the fixed part of consumption doesn't grow with tsPerItr, so more timesteps means a higher ratio
+				// If there's barely any fixed part, the ratio can't be reached and tsPerItr will settle at a bound
+				scale = targetCollectRatio / avgCollectRatio;
+			}
+
+			scale = RS_CLAMP(scale, 1 / maxStepScale, maxStepScale);
+			int64_t wantedTsPerItr = (int64_t)(curTsPerItr * scale);
+			int64_t newTsPerItr = Clamp(wantedTsPerItr);
+
+			if (newTsPerItr != wantedTsPerItr) {
+				numItrsSaturated++;
+				if (numItrsSaturated == saturatedWarnItrs) {
+					std::string targetStr = (targetItrTime > 0) ?
+						RS_STR("iteration time of " << targetItrTime << "s (currently " << (avgItrTimePerTs * curTsPerItr) << "s)") :
+						RS_STR("collection ratio of " << targetCollectRatio << " (currently " << avgCollectRatio << ")");
+					RG_LOG(
+						"WARNING: Adaptive tsPerItr has been held at its " << (wantedTsPerItr > newTsPerItr ? "maximum" : "minimum") <<
+						" of " << newTsPerItr << " for " << numItrsSaturated << " iterations, the target " << targetStr << " can't be reached"
+					);
+				}
+			} else {
+				numItrsSaturated = 0;
+			}
+
+			return newTsPerItr;
+		}
+	};
+}
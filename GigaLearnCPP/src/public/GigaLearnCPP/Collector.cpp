@@ -0,0 +1,292 @@
+#include "Collector.h"
+#include "Util/Timer.h"
+
+#include <private/GigaLearnCPP/PPO/PPOLearner.h>
+#include <private/GigaLearnCPP/Util/WelfordStat.h>
+
+#include <random>
+
+using namespace RLGC;
+
+GGL::Collector::Collector(EnvCreateFn envCreateFn, LearnerConfig config, std::string learnerAddress, int learnerPort) : config(config) {
+	RG_LOG("Collector::Collector():");
+
+	// Collectors must not share a seed, or they would all collect the same trajectories
+	if (config.randomSeed == -1)
+		this->config.randomSeed = RS_CUR_MS() ^ std::random_device()();
+	sampleRNG = RLGC::RNG(this->config.randomSeed).Fork(1);
+	torch::manual_seed(this->config.randomSeed);
+
+	if (RocketSim::GetStage() != RocketSimStage::INITIALIZED) {
+		RG_LOG("\tInitializing RocketSim...");
+		RocketSim::Init("collision_meshes", true);
+	}
+
+	{
+		RG_LOG("\tCreating envs...");
+		EnvSetConfig envSetConfig = {};
+		envSetConfig.envCreateFn = envCreateFn;
+		envSetConfig.numArenas = config.numGames;
+		envSetConfig.tickSkip = config.tickSkip;
+		envSetConfig.actionDelay = config.actionDelay;
+		envSetConfig.saveRewards = false;
+		envSetConfig.batchedRewards = config.batchedRewards;
+		envSetConfig.ballPredNumStates = config.ballPredNumStates;
+		envSetConfig.ballPredTickInterval = config.ballPredTickInterval;
+		envSetConfig.randomSeed = this->config.randomSeed;
+		envSet = new RLGC::EnvSet(envSetConfig);
+		obsSize = envSet->state.obs.size[1];
+		numActions = envSet->actionParsers[0]->GetActionAmount();
+		RG_LOG("\tCreated " << envSet->arenas.size() << " envs in " << envSet->constructTime << "s");
+	}
+
+	models = new ModelSet();
+	try {
+		PPOLearner::MakeModels(
+			false, obsSize, numActions,
+			config.ppo.sharedHead, config.ppo.policy, {},
+			torch::kCPU,
+			*models
+		);
+	} catch (std::exception& e) {
+		RG_ERR_CLOSE("Collector: Exception when trying to construct models: " << e.what());
+	}
+
+	client = new CollectorClient(learnerAddress, learnerPort, obsSize, numActions, envSet->state.numPlayers);
+}
+
+std::vector<uint8_t> GGL::Collector::MakeWeightsPayload(PPOLearner* ppo, const BatchedWelfordStat* obsStat, const LearnerConfig& config) {
+	RG_NO_GRAD;
+
+	std::vector<torch::Tensor> allParams = {};
+	for (Model* model : ppo->GetPolicyModels())
+		allParams.push_back(model->CopyParams().to(torch::kFloat32));
+	torch::Tensor tParams = torch::cat(allParams).contiguous();
+
+	CollectorWeightsHeader header = {};
+	header.numParams = tParams.numel();
+	header.obsNormSize = (obsStat && obsStat->count >= 2) ? obsStat->width : 0;
+
+	std::vector<uint8_t> payload = std::vector<uint8_t>(sizeof(header) + (header.numParams + header.obsNormSize * 2) * sizeof(float));
+	uint8_t* cur = payload.data();
+	memcpy(cur, &header, sizeof(header));
+	cur += sizeof(header);
+	memcpy(cur, tParams.data_ptr<float>(), header.numParams * sizeof(float));
+	cur += header.numParams * sizeof(float);
+
+	if (header.obsNormSize > 0) {
+		// Clamped the same way as BatchedWelfordStat::NormalizeInPlace()
+		const auto& means = obsStat->GetMean();
+		const auto& stds = obsStat->GetSTD();
+		float* outMeans = (float*)cur;
+		float* outSTDs = outMeans + header.obsNormSize;
+		for (int i = 0; i < header.obsNormSize; i++) {
+			outMeans[i] = (float)RS_CLAMP(means[i], -(double)config.maxObsMeanRange, (double)config.maxObsMeanRange);
+			outSTDs[i] = (float)RS_MAX(stds[i], (double)config.minObsSTD);
+		}
+	}
+
+	return payload;
+}
+
+void GGL::Collector::_ApplyWeights(const std::vector<uint8_t>& payload) {
+	RG_NO_GRAD;
+
+	CollectorWeightsHeader header;
+	if (payload.size() < sizeof(header))
+		RG_ERR_CLOSE("Collector: Received weights that are too small (" << payload.size() << " bytes)");
+	memcpy(&header, payload.data(), sizeof(header));
+
+	if (payload.size() != sizeof(header) + (header.numParams + header.obsNormSize * 2) * sizeof(float))
+		RG_ERR_CLOSE("Collector: Received weights with an invalid size (" << payload.size() << " bytes)");
+
+	uint64_t numModelParams = 0;
+	for (Model* model : *models)
+		for (auto& param : model->parameters())
+			numModelParams += param.numel();
+
+	if (numModelParams != header.numParams)
+		RG_ERR_CLOSE(
+			"Collector: Received weights have " << header.numParams << " parameters, but our policy has " << numModelParams << ".\n" <<
+			"Make sure the collector's model configs match the learner's."
+		);
+
+	const float* paramData = (const float*)(payload.data() + sizeof(header));
+	torch::Tensor tParams = torch::from_blob((void*)paramData, { (int64_t)header.numParams }, torch::kFloat32);
+
+	int64_t offset = 0;
+	for (Model* model : *models) {
+		auto params = model->parameters();
+		int64_t modelParams = 0;
+		for (auto& param : params)
+			modelParams += param.numel();
+
+		torch::nn::utils::vector_to_parameters(tParams.slice(0, offset, offset + modelParams), params);
+		offset += modelParams;
+	}
+
+	if (header.obsNormSize > 0) {
+		if (header.obsNormSize != obsSize)
+			RG_ERR_CLOSE("Collector: Received obs standardization for " << header.obsNormSize << " values, but the obs size is " << obsSize);
+
+		const float* means = paramData + header.numParams;
+		const float* stds = means + header.obsNormSize;
+		obsScales.resize(obsSize);
+		obsOffsets.resize(obsSize);
+		for (int i = 0; i < obsSize; i++) {
+			obsScales[i] = 1.0f / stds[i];
+			obsOffsets[i] = -means[i] * obsScales[i];
+		}
+	} else {
+		obsScales.clear();
+		obsOffsets.clear();
+	}
+}
+
+void GGL::Collector::Run() {
+	RG_LOG("Collector::Run():");
+	RG_LOG("\tObs size: " << obsSize);
+	RG_LOG("\tAction amount: " << numActions);
+
+	int numPlayers = envSet->state.numPlayers;
+	int maxEpisodeLength = (int)(config.ppo.maxEpisodeDuration * (120.f / config.tickSkip));
+
+	// Each trajectory's policyVersion is the version its first step was collected with
+	auto trajectories = std::vector<CollectorTrajBatch>(numPlayers);
+	CollectorTrajBatch batch = {};
+
+	std::vector<uint8_t> weightsPayload = {};
+	RG_LOG("\tWaiting for weights from the learner...");
+	if (!client->TakeWeights(weightsPayload, policyVersion, true)) {
+		RG_LOG("Collector: The learner disconnected before sending weights");
+		return;
+	}
+	_ApplyWeights(weightsPayload);
+	RG_LOG("\tReceived weights (policy version " << policyVersion << "), collecting...");
+
+	std::vector<int> curActions = {};
+	FList curLogProbs = {};
+	std::vector<uint8_t> curTerminals(numPlayers, 0);
+
+	uint64_t stepsSinceLog = 0;
+	double creditWaitTime = 0;
+	Timer logTimer = {};
+
+	while (true) {
+		uint32_t newPolicyVersion;
+		if (client->TakeWeights(weightsPayload, newPolicyVersion, false)) {
+			_ApplyWeights(weightsPayload);
+			policyVersion = newPolicyVersion;
+		}
+
+		envSet->Reset();
+
+		if (!obsScales.empty()) {
+			for (int i = 0; i < numPlayers; i++) {
+				float* row = &envSet->state.obs.At(i, 0);
+				for (int j = 0; j < obsSize; j++)
+					row[j] = row[j] * obsScales[j] + obsOffsets[j];
+			}
+		}
+
+		for (int i = 0; i < numPlayers; i++) {
+			auto& traj = trajectories[i];
+			if (traj.Length() == 0)
+				traj.policyVersion = policyVersion;
+
+			auto obsSpan = envSet->state.obs.GetRowSpan(i);
+			auto maskSpan = envSet->state.actionMasks.GetRowSpan(i);
+			traj.states.insert(traj.states.end(), obsSpan.begin(), obsSpan.end());
+			traj.actionMasks.insert(traj.actionMasks.end(), maskSpan.begin(), maskSpan.end());
+		}
+
+		torch::Tensor tStates = DIMLIST2_TO_TENSOR<float>(envSet->state.obs);
+		torch::Tensor tActionMasks = DIMLIST2_TO_TENSOR<uint8_t>(envSet->state.actionMasks);
+
+		envSet->StepFirstHalf(true);
+
+		{
+			RG_INFERENCE_MODE;
+			torch::Tensor tActions, tLogProbs;
+			PPOLearner::InferActionsFromModels(
+				*models, tStates, tActionMasks,
+				config.ppo.deterministic, config.ppo.policyTemperature, false,
+				&tActions, &tLogProbs, &sampleRNG
+			);
+			TENSOR_TO_VEC_INPLACE<int>(tActions, curActions);
+			TENSOR_TO_VEC_INPLACE<float>(tLogProbs, curLogProbs);
+		}
+
+		envSet->Sync();
+		envSet->StepSecondHalf(curActions, false);
+
+		std::fill(curTerminals.begin(), curTerminals.end(), 0);
+		for (int idx = 0; idx < envSet->arenas.size(); idx++) {
+			uint8_t terminalType = envSet->state.terminals[idx];
+			if (!terminalType)
+				continue;
+
+			auto playerStartIdx = envSet->state.arenaPlayerStartIdx[idx];
+			int playersInArena = envSet->state.gameStates[idx].players.size();
+			for (int i = 0; i < playersInArena; i++)
+				curTerminals[playerStartIdx + i] = terminalType;
+		}
+
+		// Same as the learner, only complete trajectories are sent
+		for (int i = 0; i < numPlayers; i++) {
+			auto& traj = trajectories[i];
+			traj.actions.push_back(curActions[i]);
+			traj.rewards.push_back(envSet->state.rewards[i]);
+			traj.logProbs.push_back(curLogProbs[i]);
+
+			int8_t terminalType = curTerminals[i];
+			if (!terminalType && traj.Length() >= maxEpisodeLength)
+				terminalType = RLGC::TerminalType::TRUNCATED;
+
+			traj.terminals.push_back(terminalType);
+			if (terminalType) {
+				if (terminalType == RLGC::TerminalType::TRUNCATED) {
+					auto obsSpan = envSet->state.obs.GetRowSpan(i);
+					traj.nextStates.insert(traj.nextStates.end(), obsSpan.begin(), obsSpan.end());
+				}
+
+				if (batch.Length() == 0 || traj.policyVersion < batch.policyVersion)
+					batch.policyVersion = traj.policyVersion;
+				batch.Append(traj);
+				traj.Clear();
+			}
+		}
+		stepsSinceLog += numPlayers;
+
+		if (batch.Length() >= (size_t)config.collectorBatchSteps) {
+			double waitTime;
+			if (!client->SendBatch(batch, obsSize, numActions, &waitTime))
+				break;
+			creditWaitTime += waitTime;
+			batch.Clear();
+		}
+
+		double logElapsed = logTimer.Elapsed();
+		if (logElapsed >= 10) {
+			RG_LOG(
+				"Collector: " << (int64_t)(stepsSinceLog / logElapsed) << " steps/s, policy version " << policyVersion << ", " <<
+				(client->bytesSent / (1024 * 1024)) << "MB sent, " <<
+				(int)(creditWaitTime / logElapsed * 100) << "% of the time waiting on the learner"
+			);
+			stepsSinceLog = 0;
+			creditWaitTime = 0;
+			logTimer.Reset();
+		}
+	}
+
+	RG_LOG("Collector: Disconnected from the learner, stopping");
+}
+
+GGL::Collector::~Collector() {
+	delete client;
+	if (models) {
+		models->Free();
+		delete models;
+	}
+	delete envSet;
+}
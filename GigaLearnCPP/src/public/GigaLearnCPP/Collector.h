@@ -0,0 +1,47 @@
+#pragma once
+
+#include <RLGymCPP/EnvSet/EnvSet.h>
+#include "Util/CollectorProtocol.h"
+#include "LearnerConfig.h"
+
+namespace GGL {
+
+	// Runs an env set with CPU policy inference in its own process, and streams complete trajectories to a learner over TCP (see CollectorProtocol.h)
+	// The learner needs LearnerConfig::collectorPort set, and the collector must use the same env create function and model configs as it
+	// Several collectors can connect to the same learner, e.g. one per CPU socket or machine
+	class RG_IMEXPORT Collector {
+	public:
+		LearnerConfig config;
+
+		RLGC::EnvSet* envSet;
+		class ModelSet* models;
+		CollectorClient* client;
+
+		int obsSize;
+		int numActions;
+
+		uint32_t policyVersion = 0;
+
+		// Obs are standardized as (obs * obsScales + obsOffsets), the same way the learner does it
+		// Empty if the learner isn't standardizing obs
+		std::vector<float> obsScales, obsOffsets;
+
+		RLGC::RNG sampleRNG = {};
+
+		// Uses config.numGames arenas
+		Collector(RLGC::EnvCreateFn envCreateFn, LearnerConfig config, std::string learnerAddress, int learnerPort);
+
+		// Collects until the learner disconnects
+		void Run();
+
+		// Makes the payload of a WEIGHTS message from the learner's current policy and obs standardization
+		static std::vector<uint8_t> MakeWeightsPayload(class PPOLearner* ppo, const struct BatchedWelfordStat* obsStat, const LearnerConfig& config);
+
+		RG_NO_COPY(Collector);
+
+		~Collector();
+
+	private:
+		void _ApplyWeights(const std::vector<uint8_t>& payload);
+	};
+}
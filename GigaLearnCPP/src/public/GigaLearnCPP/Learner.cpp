@@ -17,17 +17,34 @@
 
 #include "Util/KeyPressDetector.h"
 #include <private/GigaLearnCPP/Util/WelfordStat.h>
+#include <private/GigaLearnCPP/Util/TensorMemory.h>
+#include <private/GigaLearnCPP/Util/RolloutDataset.h>
+#include <private/GigaLearnCPP/Util/TsPerItrController.h>
 #include "Util/AvgTracker.h"
+#include "Collector.h"
+#include <RLGymCPP/EnvSet/RolloutRecorder.h>
 
 #include <future>
 
 using namespace RLGC;
 
+// Process memory growth since startRSS, used to attribute memory to python
+static uint64_t GetRSSGrowth(uint64_t startRSS) {
+	uint64_t curRSS = GGL::MemoryTracker::GetProcessRSS();
+	return curRSS > startRSS ? curRSS - startRSS : 0;
+}
+
 GGL::Learner::Learner(EnvCreateFn envCreateFn, LearnerConfig config, StepCallbackFn stepCallback) :
 	envCreateFn(envCreateFn), config(config), stepCallback(stepCallback)
 {
-	if (!Py_IsInitialized()) {
+	// Python is only needed for the metrics receiver and rendering (unless rendering to a shared memory ring)
+	bool needsPython = config.sendMetrics || (config.renderMode && config.renderRingName.empty());
+	if (!needsPython) {
+		ownsInterpreter = false;
+	} else if (!Py_IsInitialized()) {
+		uint64_t startRSS = MemoryTracker::GetProcessRSS();
 		pybind11::initialize_interpreter();
+		memTracker.pythonBytes += GetRSSGrowth(startRSS);
 		ownsInterpreter = true;
 	} else {
 		ownsInterpreter = false;
@@ -41,8 +58,36 @@ GGL::Learner::Learner(EnvCreateFn envCreateFn, LearnerConfig config, StepCallbac
 	RG_SLEEP(1000);
 #endif
 
-	if (config.tsPerSave == 0)
+	if (config.tsPerSave == 0) {
+		// Transfer learning still uses this as its save interval
 		config.tsPerSave = config.ppo.tsPerItr;
+		saveEveryIteration = true;
+	}
+
+	if (config.adaptiveTsPerItr) {
+		int64_t minTs = RS_MAX(config.adaptiveTsMin, config.ppo.batchSize);
+		int64_t maxTs = config.adaptiveTsMax;
+
+		// Only half, since an iteration can collect more than tsPerItr (trajectories are finished, and collector batches are added on top)
+		// The save and version checks only act once per iteration, so crossing two boundaries would skip one
+		if (!saveEveryIteration)
+			maxTs = RS_MIN(maxTs, config.tsPerSave / 2);
+		if (config.savePolicyVersions || config.skillTracker.enabled || config.trainAgainstOldVersions)
+			maxTs = RS_MIN(maxTs, config.tsPerVersion / 2);
+
+		if (minTs > maxTs)
+			RG_ERR_CLOSE(
+				"Learner: Adaptive tsPerItr has no valid range, minimum is " << minTs << " (adaptiveTsMin and ppo.batchSize) " <<
+				"but maximum is " << maxTs << " (adaptiveTsMax, and half of tsPerSave and tsPerVersion)"
+			);
+
+		tsPerItrController = new TsPerItrController(
+			config.adaptiveTsCollectRatio, config.adaptiveTsTargetItrTime, minTs, maxTs, config.adaptiveTsMaxStepScale
+		);
+		config.ppo.tsPerItr = tsPerItrController->Clamp(config.ppo.tsPerItr);
+	} else {
+		tsPerItrController = NULL;
+	}
 
 	RG_LOG("Learner::Learner():");
 
@@ -52,6 +97,7 @@ GGL::Learner::Learner(EnvCreateFn envCreateFn, LearnerConfig config, StepCallbac
 	RG_LOG("\tCheckpoint Save/Load Dir: " << config.checkpointFolder);
 
 	torch::manual_seed(config.randomSeed);
+	rng = RLGC::RNG(config.randomSeed).Fork(0);
 
 	at::Device device = at::Device(at::kCPU);
 	if (
@@ -96,9 +142,33 @@ GGL::Learner::Learner(EnvCreateFn envCreateFn, LearnerConfig config, StepCallbac
 		envSetConfig.tickSkip = config.tickSkip;
 		envSetConfig.actionDelay = config.actionDelay;
 		envSetConfig.saveRewards = config.addRewardsToMetrics;
+		envSetConfig.batchedRewards = config.batchedRewards;
+		envSetConfig.ballPredNumStates = config.ballPredNumStates;
+		envSetConfig.ballPredTickInterval = config.ballPredTickInterval;
+		envSetConfig.randomSeed = config.randomSeed;
 		envSet = new RLGC::EnvSet(envSetConfig);
 		obsSize = envSet->state.obs.size[1];
+
+		float maxArenaTime = 0, totalArenaTime = 0;
+		for (float time : envSet->arenaConstructTimes) {
+			maxArenaTime = RS_MAX(maxArenaTime, time);
+			totalArenaTime += time;
+		}
+		RG_LOG(
+			"\tCreated " << envSet->arenas.size() << " envs in " << envSet->constructTime << "s " <<
+			"(avg: " << (totalArenaTime / envSet->arenas.size() * 1000) << "ms, max: " << (maxArenaTime * 1000) << "ms per env)"
+		);
 		numActions = envSet->actionParsers[0]->GetActionAmount();
+
+		if (envSet->state.modeNames.size() > 1) {
+			std::stringstream modesStream;
+			for (int i = 0; i < envSet->state.modeNames.size(); i++) {
+				if (i > 0)
+					modesStream << ", ";
+				modesStream << envSet->state.modeNames[i] << " (" << envSet->state.modeNumArenas[i] << " envs)";
+			}
+			RG_LOG("\tModes: " << modesStream.str());
+		}
 	}
 
 	{
@@ -118,16 +188,25 @@ GGL::Learner::Learner(EnvCreateFn envCreateFn, LearnerConfig config, StepCallbac
 	try {
 		RG_LOG("\tMaking PPO learner...");
 		ppo = new PPOLearner(obsSize, numActions, config.ppo, device);
+		ppo->sampleRNG = RLGC::RNG(config.randomSeed).Fork(1);
 	} catch (std::exception& e) {
 		RG_ERR_CLOSE("Failed to create PPO learner: " << e.what());
 	}
 
-	if (config.renderMode) {
+	if (config.renderMode && config.renderRingName.empty()) {
+		uint64_t startRSS = MemoryTracker::GetProcessRSS();
 		renderSender = new RenderSender(config.renderTimeScale);
+		memTracker.pythonBytes += GetRSSGrowth(startRSS);
 	} else {
 		renderSender = NULL;
 	}
 
+	if (!config.renderRingName.empty()) {
+		renderRing = new RenderRing(config.renderRingName, config.renderRingSlots);
+	} else {
+		renderRing = NULL;
+	}
+
 	if (config.skillTracker.enabled || config.trainAgainstOldVersions)
 		config.savePolicyVersions = true;
 
@@ -155,11 +234,40 @@ GGL::Learner::Learner(EnvCreateFn envCreateFn, LearnerConfig config, StepCallbac
 	if (config.sendMetrics && !config.renderMode) {
 		if (!runID.empty())
 			RG_LOG("\tRun ID: " << runID);
+		uint64_t startRSS = MemoryTracker::GetProcessRSS();
 		metricSender = new MetricSender(config.metricsProjectName, config.metricsGroupName, config.metricsRunName, runID);
+		memTracker.pythonBytes += GetRSSGrowth(startRSS);
 	} else {
 		metricSender = NULL;
 	}
 
+	if (!config.metricsFilePath.empty() && !config.renderMode) {
+		std::filesystem::path metricsFilePath = config.metricsFilePath;
+		if (metricsFilePath.is_relative() && !config.checkpointFolder.empty())
+			metricsFilePath = config.checkpointFolder / metricsFilePath;
+		metricFileWriter = new MetricFileWriter(metricsFilePath);
+	} else {
+		metricFileWriter = NULL;
+	}
+
+	if (!config.rolloutDatasetPath.empty() && !config.renderMode) {
+		std::filesystem::path rolloutDatasetPath = config.rolloutDatasetPath;
+		if (rolloutDatasetPath.is_relative() && !config.checkpointFolder.empty())
+			rolloutDatasetPath = config.checkpointFolder / rolloutDatasetPath;
+		rolloutDatasetWriter = new RolloutDatasetWriter(rolloutDatasetPath, config.rolloutDatasetChunkRows);
+	} else {
+		rolloutDatasetWriter = NULL;
+	}
+
+	if (config.collectorPort > 0 && !config.renderMode) {
+		collectorServer = new CollectorServer(config.collectorAddress, config.collectorPort, obsSize, numActions, config.collectorCredits);
+		collectorServer->SetWeights(totalIterations, Collector::MakeWeightsPayload(ppo, obsStat, config));
+	} else {
+		collectorServer = NULL;
+	}
+
+	memTracker.warningThresholdBytes = (uint64_t)(config.memWarningThresholdMB * 1024 * 1024);
+
 	RG_LOG(RG_DIVIDER);
 }
 
@@ -176,7 +284,10 @@ void GGL::Learner::SaveStats(std::filesystem::path path) {
 	j["total_timesteps"] = totalTimesteps;
 	j["total_iterations"] = totalIterations;
 
-	if (config.sendMetrics)
+	if (tsPerItrController)
+		j["ts_per_itr"] = config.ppo.tsPerItr;
+
+	if (metricSender)
 		j["run_id"] = metricSender->curRunID;
 
 	if (returnStat)
@@ -208,6 +319,9 @@ void GGL::Learner::LoadStats(std::filesystem::path path) {
 	if (j.contains("run_id"))
 		runID = j["run_id"];
 
+	if (tsPerItrController && j.contains("ts_per_itr"))
+		config.ppo.tsPerItr = tsPerItrController->Clamp(j["ts_per_itr"].get<int64_t>());
+
 	// FIX: Vrifier si les cls existent avant de les lire
 	if (returnStat && j.contains("return_stat"))
 		returnStat->ReadFromJSON(j["return_stat"]);
@@ -378,8 +492,9 @@ void GGL::Learner::StartTransferLearn(const TransferLearnConfig& tlConfig) {
 
 					// Run all old obs and old action parser on each player
 					// TODO: Could be multithreaded
+					// The states are now in prevGameStates, as StepFirstHalf() swaps them out
 					for (int arenaIdx = 0; arenaIdx < envSet->arenas.size(); arenaIdx++) {
-						auto& gs = envSet->state.gameStates[arenaIdx];
+						auto& gs = envSet->state.prevGameStates[arenaIdx];
 						for (auto& player : gs.players) {
 							allOldObs += oldObsBuilders[arenaIdx]->BuildObs(player, gs);
 							allOldActionMasks += oldActionParsers[arenaIdx]->GetActionMask(player, gs);
@@ -448,6 +563,8 @@ void GGL::Learner::StartTransferLearn(const TransferLearnConfig& tlConfig) {
 
 			if (metricSender)
 				metricSender->Send(report);
+			if (metricFileWriter)
+				metricFileWriter->Write(report);
 
 			report.Display(
 				{
@@ -482,6 +599,7 @@ void GGL::Learner::StartTransferLearn(const TransferLearnConfig& tlConfig) {
 void GGL::Learner::Start() {
 
 	bool render = config.renderMode;
+	RenderPacer renderPacer = RenderPacer(config.renderTimeScale); // For renderMode when rendering to a ring, which doesn't wait on its own
 
 	RG_LOG("Learner::Start():");
 	RG_LOG("\tObs size: " << obsSize);
@@ -531,7 +649,9 @@ void GGL::Learner::Start() {
 				actions.clear();
 			}
 
-			void Append(const Trajectory& other) {
+			// Also used for batches from collectors (CollectorTrajBatch), which have the same columns
+			template <typename T>
+			void Append(const T& other) {
 				states.insert(states.end(), other.states.begin(), other.states.end());
 				nextStates.insert(nextStates.end(), other.nextStates.begin(), other.nextStates.end());
 				rewards.insert(rewards.end(), other.rewards.begin(), other.rewards.end());
@@ -544,6 +664,12 @@ void GGL::Learner::Start() {
 			size_t Length() const {
 				return actions.size();
 			}
+
+			uint64_t GetMemoryUsage() const {
+				return
+					(states.capacity() + nextStates.capacity() + rewards.capacity() + logProbs.capacity()) * sizeof(float) +
+					actionMasks.capacity() * sizeof(uint8_t) + terminals.capacity() * sizeof(int8_t) + actions.capacity() * sizeof(int32_t);
+			}
 		};
 
 		auto trajectories = std::vector<Trajectory>(numPlayers, Trajectory{});
@@ -557,8 +683,11 @@ void GGL::Learner::Start() {
 		oldPlayerIndicesReusable.reserve(numPlayers);
 		oldVersionPlayerMaskReusable.reserve(numPlayers);
 		
-		Trajectory combinedTrajReusable;
-		combinedTrajReusable.Reserve(config.ppo.tsPerItr * 2);
+		// Complete episodes stay at the front of each player's trajectory until they're consumed at the end of the iteration
+		std::vector<int64_t> trajCompleteSteps(numPlayers, 0);
+
+		// Trajectories from collectors, consumed along with the players' complete episodes
+		Trajectory remoteTraj;
 
 		// OPTIMISATION MAJEURE: Double buffer pour pipeline CPU/GPU
 		// Pendant que le GPU traite le batch N, le CPU prpare le batch N+1
@@ -569,7 +698,43 @@ void GGL::Learner::Start() {
 		// OPTIMISATION: Pr-allouer les tenseurs GPU pour les indices (vite rallocation)
 		torch::Tensor tNewPlayerIndicesGPU, tOldPlayerIndicesGPU;
 
+		RLGC::Profiler::SetThreadName("Learner");
+		int iterationsThisRun = 0;
+		std::unique_ptr<RLGC::RolloutRecorder> rolloutRecorder = NULL;
+
 		while (true) {
+			if (config.profileNumIterations > 0) {
+				if (iterationsThisRun == config.profileStartIteration) {
+					RG_LOG("Profiler: Recording " << config.profileNumIterations << " iterations...");
+					RLGC::Profiler::Start();
+				} else if (iterationsThisRun == config.profileStartIteration + config.profileNumIterations) {
+					RLGC::Profiler::Stop();
+
+					std::filesystem::path tracePath = config.profileTracePath;
+					if (tracePath.is_relative() && !config.checkpointFolder.empty())
+						tracePath = config.checkpointFolder / tracePath;
+					RLGC::Profiler::WriteChromeTrace(tracePath);
+				}
+			}
+
+			if (config.rolloutRecordNumIterations > 0) {
+				// Recording starts from the first step so that the window replays exactly, even when it starts later
+				if (iterationsThisRun == 0) {
+					std::filesystem::path recordPath = config.rolloutRecordPath;
+					if (recordPath.is_relative() && !config.checkpointFolder.empty())
+						recordPath = config.checkpointFolder / recordPath;
+					rolloutRecorder = std::make_unique<RLGC::RolloutRecorder>(recordPath, envSet);
+				}
+
+				if (iterationsThisRun == config.rolloutRecordStartIteration) {
+					rolloutRecorder->StartWindow();
+				} else if (iterationsThisRun == config.rolloutRecordStartIteration + config.rolloutRecordNumIterations) {
+					rolloutRecorder.reset();
+				}
+			}
+			iterationsThisRun++;
+
+			RG_PROFILE_SCOPE("Learner Iteration");
 			Report report = {};
 
 			bool isFirstIteration = (totalTimesteps == 0);
@@ -587,15 +752,15 @@ void GGL::Learner::Start() {
 			if (config.trainAgainstOldVersions) {
 				RG_ASSERT(config.trainAgainstOldChance >= 0 && config.trainAgainstOldChance <= 1);
 				bool shouldTrainAgainstOld =
-					(RocketSim::Math::RandFloat() < config.trainAgainstOldChance)
+					(rng.NextFloat() < config.trainAgainstOldChance)
 					&& !versionMgr->versions.empty()
 					&& !render;
 
 				if (shouldTrainAgainstOld) {
-					int oldVersionIdx = RocketSim::Math::RandInt(0, versionMgr->versions.size());
+					int oldVersionIdx = rng.RandInt(0, versionMgr->versions.size());
 					oldVersion = &versionMgr->versions[oldVersionIdx];
 
-					Team oldVersionTeam = Team(RocketSim::Math::RandInt(0, 2)); 
+					Team oldVersionTeam = Team(rng.RandInt(0, 2)); 
 					
 					newPlayerIndicesReusable.clear();
 					oldVersionPlayerMaskReusable.resize(numPlayers);
@@ -626,11 +791,16 @@ void GGL::Learner::Start() {
 
 			int numRealPlayers = oldVersion ? newPlayerIndicesReusable.size() : envSet->state.numPlayers;
 
+			// Rows collected per step from each mode, for per-mode throughput
+			int numModes = envSet->state.modeNames.size();
+			std::vector<int> modeRealPlayers(numModes, 0);
+			for (int idx : newPlayerIndicesReusable)
+				modeRealPlayers[envSet->state.arenaModeIdx[envSet->state.playerArenaIdx[idx]]]++;
+
 			int stepsCollected = 0;
+			int remoteStepsCollected = 0;
 			{ // Generate experience
-				combinedTrajReusable.Clear();
-				auto& combinedTraj = combinedTrajReusable;
-				combinedTraj.Reserve(config.ppo.tsPerItr * 2);
+				int64_t completeSteps = 0;
 				
 				auto sanitizeActions = [&](std::vector<int>& actsVec) {
 					bool clamped = false;
@@ -645,6 +815,7 @@ void GGL::Learner::Start() {
 
 				Timer collectionTimer = {};
 				{ // Collect timesteps
+					RG_PROFILE_SCOPE("Collect Timesteps");
 					RG_INFERENCE_MODE;
 
 					float inferTime = 0;
@@ -662,13 +833,16 @@ void GGL::Learner::Start() {
 					std::future<void> gpuTransferFuture;
 					bool hasGpuTransferPending = false;
 
-					for (int step = 0; combinedTraj.Length() < config.ppo.tsPerItr || render; step++, stepsCollected += numRealPlayers) {
+					for (int step = 0; completeSteps < config.ppo.tsPerItr || render; step++, stepsCollected += numRealPlayers) {
 						Timer stepTimer = {};
 						
 						// OPTIMISATION: Lancer le reset des environnements en parallle
 						envSet->Reset();
 						envStepTime += stepTimer.Elapsed();
 
+						if (rolloutRecorder)
+							rolloutRecorder->RecordObs(envSet);
+
 #ifndef NDEBUG
 						for (float f : envSet->state.obs.data)
 							if (isnan(f) || isinf(f))
@@ -677,9 +851,10 @@ void GGL::Learner::Start() {
 
 						// OPTIMISATION: Normalisation in-place sur CPU (pendant que GPU fait autre chose)
 						if (!render && obsStat) {
+							RG_PROFILE_SCOPE("Normalize Obs");
 							int numSamples = RS_MIN(envSet->state.numPlayers, config.maxObsSamples);
 							for (int i = 0; i < numSamples; i++) {
-								int idx = Math::RandInt(0, envSet->state.numPlayers);
+								int idx = rng.RandInt(0, envSet->state.numPlayers);
 								obsStat->IncrementRow(&envSet->state.obs.At(idx, 0));
 							}
 
@@ -701,6 +876,7 @@ void GGL::Learner::Start() {
 						std::future<void> trajCopyFuture;
 						if (!render) {
 							trajCopyFuture = std::async(std::launch::async, [&, bufIdx]() {
+								RG_PROFILE_SCOPE("Copy Obs To Trajectories");
 								for (int newPlayerIdx : newPlayerIndices) {
 									auto& traj = trajectories[newPlayerIdx];
 									auto obsSpan = envSet->state.obs.GetRowSpan(newPlayerIdx);
@@ -730,51 +906,54 @@ void GGL::Learner::Start() {
 						Timer inferTimer = {};
 						torch::Tensor tActions, tLogProbs;
 
-						if (oldVersion) {
-							if (ppo->device.is_cuda()) {
-								GGL::GetStreamManager().WaitTransfers();
-							}
+						{ // Infer actions
+							RG_PROFILE_SCOPE("Infer Actions");
+							if (oldVersion) {
+								if (ppo->device.is_cuda()) {
+									GGL::GetStreamManager().WaitTransfers();
+								}
 							
-							torch::Tensor srcStates = ppo->device.is_cuda() ? tdStatesBuffer[bufIdx] : tStatesBuffer[bufIdx];
-							torch::Tensor srcMasks = ppo->device.is_cuda() ? tdActionMasksBuffer[bufIdx] : tActionMasksBuffer[bufIdx];
+								torch::Tensor srcStates = ppo->device.is_cuda() ? tdStatesBuffer[bufIdx] : tStatesBuffer[bufIdx];
+								torch::Tensor srcMasks = ppo->device.is_cuda() ? tdActionMasksBuffer[bufIdx] : tActionMasksBuffer[bufIdx];
 							
-							// Utiliser les indices GPU pr-transfrs
-							torch::Tensor idxNew = ppo->device.is_cuda() ? tNewPlayerIndicesGPU : tNewPlayerIndices;
-							torch::Tensor idxOld = ppo->device.is_cuda() ? tOldPlayerIndicesGPU : tOldPlayerIndices;
+								// Utiliser les indices GPU pr-transfrs
+								torch::Tensor idxNew = ppo->device.is_cuda() ? tNewPlayerIndicesGPU : tNewPlayerIndices;
+								torch::Tensor idxOld = ppo->device.is_cuda() ? tOldPlayerIndicesGPU : tOldPlayerIndices;
 							
-							torch::Tensor tdNewStates = srcStates.index_select(0, idxNew);
-							torch::Tensor tdOldStates = srcStates.index_select(0, idxOld);
-							torch::Tensor tdNewActionMasks = srcMasks.index_select(0, idxNew);
-							torch::Tensor tdOldActionMasks = srcMasks.index_select(0, idxOld);
+								torch::Tensor tdNewStates = srcStates.index_select(0, idxNew);
+								torch::Tensor tdOldStates = srcStates.index_select(0, idxOld);
+								torch::Tensor tdNewActionMasks = srcMasks.index_select(0, idxNew);
+								torch::Tensor tdOldActionMasks = srcMasks.index_select(0, idxOld);
 							
-							if (!ppo->device.is_cuda()) {
-								tdNewStates = tdNewStates.to(ppo->device, true);
-								tdOldStates = tdOldStates.to(ppo->device, true);
-								tdNewActionMasks = tdNewActionMasks.to(ppo->device, true);
-								tdOldActionMasks = tdOldActionMasks.to(ppo->device, true);
-							}
+								if (!ppo->device.is_cuda()) {
+									tdNewStates = tdNewStates.to(ppo->device, true);
+									tdOldStates = tdOldStates.to(ppo->device, true);
+									tdNewActionMasks = tdNewActionMasks.to(ppo->device, true);
+									tdOldActionMasks = tdOldActionMasks.to(ppo->device, true);
+								}
+
+								torch::Tensor tNewActions;
+								torch::Tensor tOldActions;
 
-							torch::Tensor tNewActions;
-							torch::Tensor tOldActions;
-
-							ppo->InferActions(tdNewStates, tdNewActionMasks, &tNewActions, &tLogProbs);
-							ppo->InferActions(tdOldStates, tdOldActionMasks, &tOldActions, NULL, &oldVersion->models);
-
-							auto opts = torch::TensorOptions().dtype(tNewActions.dtype()).device(ppo->device);
-							tActions = torch::zeros({ (int64_t)numPlayers }, opts);
-							tActions.index_copy_(0, idxNew, tNewActions);
-							tActions.index_copy_(0, idxOld, tOldActions);
-							tActions = tActions.cpu();
-						} else {
-							if (ppo->device.is_cuda()) {
-								GGL::GetStreamManager().WaitTransfers();
-								ppo->InferActions(tdStatesBuffer[bufIdx], tdActionMasksBuffer[bufIdx], &tActions, &tLogProbs);
+								ppo->InferActions(tdNewStates, tdNewActionMasks, &tNewActions, &tLogProbs);
+								ppo->InferActions(tdOldStates, tdOldActionMasks, &tOldActions, NULL, &oldVersion->models);
+
+								auto opts = torch::TensorOptions().dtype(tNewActions.dtype()).device(ppo->device);
+								tActions = torch::zeros({ (int64_t)numPlayers }, opts);
+								tActions.index_copy_(0, idxNew, tNewActions);
+								tActions.index_copy_(0, idxOld, tOldActions);
+								tActions = tActions.cpu();
 							} else {
-								auto tdStates = tStatesBuffer[bufIdx].to(ppo->device, true);
-								auto tdActionMasks = tActionMasksBuffer[bufIdx].to(ppo->device, true);
-								ppo->InferActions(tdStates, tdActionMasks, &tActions, &tLogProbs);
+								if (ppo->device.is_cuda()) {
+									GGL::GetStreamManager().WaitTransfers();
+									ppo->InferActions(tdStatesBuffer[bufIdx], tdActionMasksBuffer[bufIdx], &tActions, &tLogProbs);
+								} else {
+									auto tdStates = tStatesBuffer[bufIdx].to(ppo->device, true);
+									auto tdActionMasks = tActionMasksBuffer[bufIdx].to(ppo->device, true);
+									ppo->InferActions(tdStates, tdActionMasks, &tActions, &tLogProbs);
+								}
+								tActions = tActions.cpu();
 							}
-							tActions = tActions.cpu();
 						}
 						inferTime += inferTimer.Elapsed();
 
@@ -793,26 +972,42 @@ void GGL::Learner::Start() {
 						envSet->StepSecondHalf(curActionsVec, false);
 						envStepTime += stepTimer.Elapsed();
 
+						if (rolloutRecorder)
+							rolloutRecorder->RecordStep(envSet, curActionsVec);
+
 						if (stepCallback)
 							stepCallback(this, envSet->state.gameStates, report);
 
+						if (renderRing)
+							renderRing->Write(envSet->state.gameStates[0]);
+
 						if (render) {
-							renderSender->Send(envSet->state.gameStates[0]);
+							if (renderSender) {
+								renderSender->Send(envSet->state.gameStates[0]);
+							} else {
+								renderPacer.Wait(envSet->state.gameStates[0].deltaTime);
+							}
 							continue;
 						}
 
 						// Calc average rewards (moins frquent pour rduire overhead)
-						if (config.addRewardsToMetrics && (Math::RandInt(0, config.rewardSampleRandInterval) == 0)) {
+						if (config.addRewardsToMetrics && (rng.RandInt(0, config.rewardSampleRandInterval) == 0)) {
 							int numSamples = RS_MIN(envSet->arenas.size(), config.maxRewardSamples);
 							std::unordered_map<std::string, AvgTracker> avgRewards = {};
 							for (int i = 0; i < numSamples; i++) {
-								int arenaIdx = Math::RandInt(0, envSet->arenas.size());
-								auto& prevRewards = envSet->state.lastRewards[i];
+								int arenaIdx = rng.RandInt(0, envSet->arenas.size());
+								auto& prevRewards = envSet->state.lastRewards[arenaIdx];
 
 							 for (int j = 0; j < envSet->rewards[arenaIdx].size(); j++) {
 								 std::string rewardName = envSet->rewards[arenaIdx][j].reward->GetName();
 								 avgRewards[rewardName] += prevRewards[j];
 							 }
+
+							 const int numArenaRewards = envSet->rewards[arenaIdx].size();
+							 for (int j = 0; j < envSet->config.batchedRewards.size(); j++) {
+								 std::string rewardName = envSet->config.batchedRewards[j].reward->GetName();
+								 avgRewards[rewardName] += prevRewards[numArenaRewards + j];
+							 }
 						 }
 
 						 for (auto& pair : avgRewards)
@@ -845,7 +1040,7 @@ void GGL::Learner::Start() {
 						 int8_t terminalType = curTerminals[newPlayerIdx];
 						 auto& traj = trajectories[newPlayerIdx];
 
-						 if (!terminalType && traj.Length() >= maxEpisodeLength) {
+						 if (!terminalType && (traj.Length() - trajCompleteSteps[newPlayerIdx]) >= maxEpisodeLength) {
 							 terminalType = RLGC::TerminalType::TRUNCATED;
 						 }
 
@@ -857,10 +1052,23 @@ void GGL::Learner::Start() {
 								 traj.nextStates.insert(traj.nextStates.end(), obsSpan.begin(), obsSpan.end());
 							 }
 
-							 combinedTraj.Append(traj);
-							 traj.Clear();
+							 completeSteps += traj.Length() - trajCompleteSteps[newPlayerIdx];
+							 trajCompleteSteps[newPlayerIdx] = traj.Length();
 						 }
 						}
+
+						if (collectorServer) {
+							RG_PROFILE_SCOPE("Add Collector Batches");
+							uint32_t minPolicyVersion = (uint32_t)RS_MAX((int64_t)totalIterations - config.collectorMaxPolicyLag, (int64_t)0);
+							// Batches were already validated when received (see CollectorTrajBatch::Validate())
+							auto remoteBatches = collectorServer->TakeBatches(minPolicyVersion);
+							for (CollectorTrajBatch* batch : remoteBatches) {
+								remoteTraj.Append(*batch);
+								completeSteps += batch->Length();
+								remoteStepsCollected += batch->Length();
+							}
+							collectorServer->ReleaseBatches(remoteBatches);
+						}
 					}
 
 					report["Inference Time"] = inferTime;
@@ -868,50 +1076,124 @@ void GGL::Learner::Start() {
 				}
 				float collectionTime = collectionTimer.Elapsed();
 
+				if (collectorServer) {
+					report["Collectors/Connected"] = collectorServer->GetNumConnected();
+					report["Collectors/Remote Timesteps"] = remoteStepsCollected;
+					report["Collectors/Stale Batches Dropped"] = collectorServer->staleBatchesDropped.load();
+					report["Collectors/Invalid Batches Dropped"] = collectorServer->invalidBatchesDropped.load();
+					report["Collectors/Received MB"] = collectorServer->bytesReceived / (1024.0 * 1024.0);
+					stepsCollected += remoteStepsCollected;
+				}
+
 				Timer consumptionTimer = {};
 				{ // Process timesteps
+					RG_PROFILE_SCOPE("Process Timesteps");
 					RG_INFERENCE_MODE;
 
-					// OPTIMISATION MAJEURE: Crer tous les tenseurs en parallle sur CPU
-					torch::Tensor tStates, tActionMasks, tActions, tLogProbs, tRewards, tTerminals;
-					
-					std::atomic<int> tensorsCreated{0};
-					
-					// OPTIMISATION: Utiliser le ThreadPool pour crer les tenseurs en parallle
-					RLGC::g_ThreadPool.StartJobAsync([&]() {
-						tActionMasks = GGL::VectorToTensor<uint8_t>(combinedTraj.actionMasks, { (int64_t)combinedTraj.actionMasks.size() / numActions, (int64_t)numActions });
-						tensorsCreated++;
-					});
-					RLGC::g_ThreadPool.StartJobAsync([&]() {
-						tActions = GGL::VectorToTensor<int32_t>(combinedTraj.actions, { (int64_t)combinedTraj.actions.size() });
-						tensorsCreated++;
-					});
-					RLGC::g_ThreadPool.StartJobAsync([&]() {
-						tLogProbs = GGL::VectorToTensor<float>(combinedTraj.logProbs, { (int64_t)combinedTraj.logProbs.size() });
-						tensorsCreated++;
-					});
-					RLGC::g_ThreadPool.StartJobAsync([&]() {
-						tRewards = GGL::VectorToTensor<float>(combinedTraj.rewards, { (int64_t)combinedTraj.rewards.size() });
-						tensorsCreated++;
-					});
-					RLGC::g_ThreadPool.StartJobAsync([&]() {
-						tTerminals = GGL::VectorToTensor<int8_t>(combinedTraj.terminals, { (int64_t)combinedTraj.terminals.size() });
-						tensorsCreated++;
-					});
-					
-					// Le plus gros dans le thread courant
-					tStates = GGL::VectorToTensor<float>(combinedTraj.states, { (int64_t)combinedTraj.states.size() / obsSize, (int64_t)obsSize });
-					tensorsCreated++;
-					
-					while (tensorsCreated.load() < 6) {
-						std::this_thread::yield();
+					// Each source (every player's complete episodes, then row ranges of the collector trajectories) gets its rows from a prefix sum,
+					//	then all sources are copied straight into the final tensors in parallel
+					// Reward and terminal stats are counted in the same pass
+					struct Source {
+						Trajectory* traj;
+						int64_t rowStart, numRows; // Rows of traj
+						int64_t truncStart, numTruncs; // Rows of traj->nextStates
+					};
+					std::vector<Source> sources;
+					for (int i = 0; i < numPlayers; i++) {
+						// Truncated episodes are always complete, so all of a player's next states are consumed
+						sources.push_back({ &trajectories[i], 0, trajCompleteSteps[i], 0, (int64_t)trajectories[i].nextStates.size() / obsSize });
+					}
+
+					// Collector trajectories can be most of the data, so they're split up rather than copied by one thread
+					// Next states are in the same order as the truncated steps, so each range's next states follow from counting them
+					constexpr int64_t REMOTE_ROWS_PER_SOURCE = 16384;
+					for (int64_t rowStart = 0, truncStart = 0; rowStart < (int64_t)remoteTraj.Length(); rowStart += REMOTE_ROWS_PER_SOURCE) {
+						int64_t numRows = RS_MIN(REMOTE_ROWS_PER_SOURCE, (int64_t)remoteTraj.Length() - rowStart);
+						int64_t numTruncs = std::count(
+							remoteTraj.terminals.begin() + rowStart, remoteTraj.terminals.begin() + rowStart + numRows, (int8_t)RLGC::TerminalType::TRUNCATED
+						);
+						sources.push_back({ &remoteTraj, rowStart, numRows, truncStart, numTruncs });
+						truncStart += numTruncs;
 					}
 
+					int numSources = sources.size();
+					std::vector<int64_t> stepOffsets(numSources + 1, 0), truncOffsets(numSources + 1, 0);
+					for (int i = 0; i < numSources; i++) {
+						stepOffsets[i + 1] = stepOffsets[i] + sources[i].numRows;
+						truncOffsets[i + 1] = truncOffsets[i] + sources[i].numTruncs;
+					}
+					int64_t numSteps = stepOffsets[numSources];
+					int64_t numTruncs = truncOffsets[numSources];
+
+					torch::Tensor tStates = torch::empty({ numSteps, (int64_t)obsSize }, GetCachedOptions<float>());
+					torch::Tensor tActionMasks = torch::empty({ numSteps, (int64_t)numActions }, GetCachedOptions<uint8_t>());
+					torch::Tensor tActions = torch::empty({ numSteps }, GetCachedOptions<int32_t>());
+					torch::Tensor tLogProbs = torch::empty({ numSteps }, GetCachedOptions<float>());
+					torch::Tensor tRewards = torch::empty({ numSteps }, GetCachedOptions<float>());
+					torch::Tensor tTerminals = torch::empty({ numSteps }, GetCachedOptions<int8_t>());
 					torch::Tensor tNextTruncStates;
-					if (!combinedTraj.nextStates.empty())
-						tNextTruncStates = GGL::VectorToTensor<float>(combinedTraj.nextStates, { (int64_t)combinedTraj.nextStates.size() / obsSize, (int64_t)obsSize });
+					if (numTruncs > 0)
+						tNextTruncStates = torch::empty({ numTruncs, (int64_t)obsSize }, GetCachedOptions<float>());
+
+					std::vector<double> sourceRewardSums(numSources, 0);
+					std::vector<int64_t> sourceNumDones(numSources, 0);
+
+					RLGC::g_ThreadPool.ParallelFor(0, numSources, [&](int i) {
+						const Source& source = sources[i];
+						Trajectory& traj = *source.traj;
+						int64_t steps = source.numRows;
+						if (steps == 0)
+							return;
+
+						int64_t start = stepOffsets[i], from = source.rowStart;
+						memcpy(tStates.data_ptr<float>() + start * obsSize, traj.states.data() + from * obsSize, steps * obsSize * sizeof(float));
+						memcpy(tActionMasks.data_ptr<uint8_t>() + start * numActions, traj.actionMasks.data() + from * numActions, steps * numActions * sizeof(uint8_t));
+						memcpy(tActions.data_ptr<int32_t>() + start, traj.actions.data() + from, steps * sizeof(int32_t));
+						memcpy(tLogProbs.data_ptr<float>() + start, traj.logProbs.data() + from, steps * sizeof(float));
+						memcpy(tRewards.data_ptr<float>() + start, traj.rewards.data() + from, steps * sizeof(float));
+						memcpy(tTerminals.data_ptr<int8_t>() + start, traj.terminals.data() + from, steps * sizeof(int8_t));
+						if (source.numTruncs > 0)
+							memcpy(
+								tNextTruncStates.data_ptr<float>() + truncOffsets[i] * obsSize,
+								traj.nextStates.data() + source.truncStart * obsSize, source.numTruncs * obsSize * sizeof(float)
+							);
+
+						double rewardSum = 0;
+						int64_t numDones = 0;
+						for (int64_t j = from; j < from + steps; j++) {
+							rewardSum += traj.rewards[j];
+							numDones += (traj.terminals[j] == RLGC::TerminalType::NORMAL);
+						}
+						sourceRewardSums[i] = rewardSum;
+						sourceNumDones[i] = numDones;
+
+						// Collector trajectories are cleared all at once afterwards
+						if (i >= numPlayers)
+							return;
+
+						// Drop what was consumed, an episode still in progress moves to the front
+						auto eraseFront = [](auto& vec, int64_t count) {
+							vec.erase(vec.begin(), vec.begin() + count);
+						};
+						eraseFront(traj.states, steps * obsSize);
+						eraseFront(traj.actionMasks, steps * numActions);
+						eraseFront(traj.actions, steps);
+						eraseFront(traj.logProbs, steps);
+						eraseFront(traj.rewards, steps);
+						eraseFront(traj.terminals, steps);
+						traj.nextStates.clear();
+						trajCompleteSteps[i] = 0;
+					}, false, "Merge Trajectories Job");
+					remoteTraj.Clear();
+
+					double totalRewardSum = 0;
+					int64_t totalNumDones = 0;
+					for (int i = 0; i < numSources; i++) {
+						totalRewardSum += sourceRewardSums[i];
+						totalNumDones += sourceNumDones[i];
+					}
 
-					report["Average Step Reward"] = tRewards.mean().item<float>();
+					report["Average Step Reward"] = totalRewardSum / numSteps;
 					report["Collected Timesteps"] = stepsCollected;
 					
 					// OPTIMISATION MAJEURE: Lancer le transfert GPU ET le calcul GAE en parallle
@@ -969,7 +1251,15 @@ void GGL::Learner::Start() {
 					report["GAE/Avg Advantage"] = tAdvantages.abs().mean().item<float>();
 					report["GAE/Avg Val Target"] = tTargetVals.abs().mean().item<float>();
 
-					report["Episode Length"] = 1.f / (tTerminals == 1).to(torch::kFloat32).mean().item<float>();
+					report["Episode Length"] = (double)numSteps / totalNumDones;
+
+					if (rolloutDatasetWriter) {
+						RolloutData rolloutData = { tStates, tActionMasks, tActions, tLogProbs, tRewards, tTerminals, tValPreds, tTruncValPreds };
+						report["Rollout Dataset/Wait Time"] = rolloutDatasetWriter->Add(totalIterations, rolloutData);
+						report["Rollout Dataset/Written MB"] = rolloutDatasetWriter->bytesWritten / (1024.0 * 1024.0);
+						if (rolloutDatasetWriter->bytesWritten > 0)
+							report["Rollout Dataset/Compression Ratio"] = (double)rolloutDatasetWriter->rawBytesWritten / rolloutDatasetWriter->bytesWritten;
+					}
 
 					// Set experience buffer
 					experience.data.actions = tActions;
@@ -985,6 +1275,12 @@ void GGL::Learner::Start() {
 				ppo->Learn(experience, report, isFirstIteration);
 				report["PPO Learn Time"] = learnTimer.Elapsed();
 
+				if (collectorServer) {
+					Timer broadcastTimer = {};
+					collectorServer->SetWeights(totalIterations + 1, Collector::MakeWeightsPayload(ppo, obsStat, config));
+					report["Collectors/Weights Broadcast Time"] = broadcastTimer.Elapsed();
+				}
+
 				// Set metrics
 				float consumptionTime = consumptionTimer.Elapsed();
 				report["Collection Time"] = collectionTime;
@@ -993,12 +1289,25 @@ void GGL::Learner::Start() {
 			 report["Consumption Steps/Second"] = stepsCollected / consumptionTime;
 			 report["Overall Steps/Second"] = stepsCollected / (collectionTime + consumptionTime);
 
+				if (numModes > 1) {
+					int numSteps = (stepsCollected - remoteStepsCollected) / RS_MAX(numRealPlayers, 1);
+					for (int i = 0; i < numModes; i++) {
+						const std::string& modeName = envSet->state.modeNames[i];
+						int modeSteps = modeRealPlayers[i] * numSteps;
+						report["Modes/" + modeName + " Timesteps"] = modeSteps;
+						report["Modes/" + modeName + " Steps/Second"] = modeSteps / (collectionTime + consumptionTime);
+					}
+				}
+
 				uint64_t prevTimesteps = totalTimesteps;
 				totalTimesteps += stepsCollected;
 				report["Total Timesteps"] = totalTimesteps;
 				totalIterations++;
 				report["Total Iterations"] = totalIterations;
 
+				if (renderRing)
+					report["Render Ring Dropped Frames"] = renderRing->GetDroppedCount();
+
 				if (versionMgr)
 					versionMgr->OnIteration(ppo, report, totalTimesteps, prevTimesteps);
 
@@ -1009,17 +1318,72 @@ void GGL::Learner::Start() {
 				}
 
 				if (!config.checkpointFolder.empty()) {
-					if (totalTimesteps / config.tsPerSave > prevTimesteps / config.tsPerSave) {
+					if (saveEveryIteration || totalTimesteps / config.tsPerSave > prevTimesteps / config.tsPerSave) {
 						Save();
 					}
 				}
 
+				if (tsPerItrController) {
+					// Takes effect next iteration, after this one's bookkeeping used the timesteps it actually collected
+					report["Timesteps Per Iteration"] = config.ppo.tsPerItr;
+					config.ppo.tsPerItr = tsPerItrController->Update(config.ppo.tsPerItr, stepsCollected, collectionTime, consumptionTime);
+				}
+
+				{ // Memory accounting
+					uint64_t arenaBytes = 0;
+					for (Arena* arena : envSet->arenas)
+						arenaBytes += arena->GetMemoryUsage();
+					memTracker.Add("Arenas", arenaBytes);
+					memTracker.Add("Env State",
+						envSet->state.obs.data.capacity() * sizeof(float) + envSet->state.actionMasks.data.capacity() * sizeof(uint8_t));
+
+					uint64_t trajBytes = 0;
+					for (auto& traj : trajectories)
+						trajBytes += traj.GetMemoryUsage();
+					memTracker.Add("Trajectories", trajBytes);
+					memTracker.Add("Collector Trajectory", remoteTraj.GetMemoryUsage());
+
+					// Tensors by category, each storage is only counted in the first category that has it
+					TensorMemoryCounter tensorCounter = {};
+					uint64_t expBytes = experience.shuffledIndices.capacity() * sizeof(int64_t) + tensorCounter.Count(experience.scratchIndices);
+					for (auto& tensor : experience.data)
+						expBytes += tensorCounter.Count(tensor);
+					for (auto& batch : experience.cachedBatches)
+						for (auto& tensor : batch)
+							expBytes += tensorCounter.Count(tensor);
+					memTracker.Add("Experience Buffer", expBytes);
+
+					memTracker.Add("Model Tensors", tensorCounter.Count(ppo->models) + tensorCounter.Count(ppo->guidingPolicyModels));
+
+					uint64_t inferBufferBytes = 0;
+					for (int i = 0; i < 2; i++) {
+						inferBufferBytes += tensorCounter.Count(tStatesBuffer[i]) + tensorCounter.Count(tActionMasksBuffer[i]);
+						inferBufferBytes += tensorCounter.Count(tdStatesBuffer[i]) + tensorCounter.Count(tdActionMasksBuffer[i]);
+					}
+					memTracker.Add("Inference Buffer Tensors", inferBufferBytes);
+
+					if (versionMgr) {
+						uint64_t versionBytes = versionMgr->versions.capacity() * sizeof(PolicyVersion);
+						for (auto& version : versionMgr->versions)
+							versionBytes += tensorCounter.Count(version.models);
+						memTracker.Add("Policy Versions", versionBytes);
+						report["Memory/Policy Version Count"] = versionMgr->versions.size();
+					}
+
+					if (tensorCounter.deviceBytes > 0)
+						report["Memory/GPU Tensors MB"] = tensorCounter.deviceBytes / (1024.0 * 1024.0);
+
+					memTracker.Finish(report);
+				}
+
 				report.Finish();
 
 				if (metricSender)
 					metricSender->Send(report);
+				if (metricFileWriter)
+					metricFileWriter->Write(report);
 
-				report.Display(
+				std::vector<std::string> displayRows =
 					{
 						"Average Step Reward",
 						"Policy Entropy",
@@ -1042,10 +1406,24 @@ void GGL::Learner::Start() {
 						"-PPO Learn Time",
 						"",
 						"Collected Timesteps",
+						"-Timesteps Per Iteration",
 						"Total Timesteps",
-						"Total Iterations"
-					}
-				);
+						"Total Iterations",
+						"",
+						"Memory/Process RSS MB",
+						"-Memory/Tracked MB",
+						"-Memory/Peak Process RSS MB"
+					};
+
+				if (numModes > 1) {
+					std::vector<std::string> modeRows = {};
+					for (auto& modeName : envSet->state.modeNames)
+						modeRows.push_back("-Modes/" + modeName + " Steps/Second");
+					auto overallItr = std::find(displayRows.begin(), displayRows.end(), "Overall Steps/Second");
+					displayRows.insert(overallItr + 1, modeRows.begin(), modeRows.end());
+				}
+
+				report.Display(displayRows);
 			}
 		}
 
@@ -1059,7 +1437,12 @@ GGL::Learner::~Learner() {
 	delete ppo;
 	delete versionMgr;
 	delete metricSender;
+	delete metricFileWriter;
+	delete rolloutDatasetWriter;
 	delete renderSender;
+	delete renderRing;
+	delete collectorServer;
+	delete tsPerItrController;
 	delete envSet;       // FIX: Librer envSet
 	delete returnStat;   // FIX: Librer returnStat
 	delete obsStat;      // FIX: Librer obsStat
@@ -2,7 +2,11 @@
 
 #include <RLGymCPP/EnvSet/EnvSet.h>
 #include "Util/MetricSender.h"
+#include "Util/MetricFileWriter.h"
+#include "Util/MemoryTracker.h"
 #include "Util/RenderSender.h"
+#include "Util/RenderRing.h"
+#include "Util/CollectorProtocol.h"
 #include "LearnerConfig.h"
 #include "PPO/TransferLearnConfig.h"
 
@@ -22,7 +26,12 @@ namespace GGL {
 
 		RLGC::EnvCreateFn envCreateFn;
 		MetricSender* metricSender;
+		MetricFileWriter* metricFileWriter;
+		struct RolloutDatasetWriter* rolloutDatasetWriter;
 		RenderSender* renderSender;
+		RenderRing* renderRing;
+		CollectorServer* collectorServer;
+		MemoryTracker memTracker = {};
 
 		int obsSize;
 		int numActions;
@@ -30,8 +39,15 @@ namespace GGL {
 		struct WelfordStat* returnStat;
 		struct BatchedWelfordStat* obsStat;
 
+		// NULL if config.adaptiveTsPerItr is off
+		struct TsPerItrController* tsPerItrController;
+		bool saveEveryIteration = false;
+
 		std::string runID = {};
 
+		// For randomness on the learner thread (sampling obs/rewards for stats), seeded from config.randomSeed
+		RLGC::RNG rng = {};
+
 		uint64_t
 			totalTimesteps = 0,
 			totalIterations = 0;
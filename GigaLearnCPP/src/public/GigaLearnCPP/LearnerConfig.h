@@ -1,5 +1,6 @@
 #pragma once
 #include <RLGymCPP/BasicTypes/Lists.h>
+#include <RLGymCPP/Rewards/BatchedReward.h>
 #include "PPO/PPOLearnerConfig.h"
 #include "SkillTrackerConfig.h"
 
@@ -23,6 +24,13 @@ namespace GGL {
 		// 2.0 = Run the game twice as fast as real time
 		float renderTimeScale = 1.0f; 
 
+		// Also write arena 0's state to a shared memory ring every step (see RenderRing), for an external viewer like python_scripts/render_ring_reader.py
+		// Writing never waits on the viewer, so this can be used to watch while training
+		// In renderMode, this replaces the python render receiver
+		// Set empty to disable
+		std::string renderRingName = {};
+		int renderRingSlots = 64;
+
 		PPOLearnerConfig ppo = {};
 
 		// Checkpoints are saved here as timestep-numbered subfolders
@@ -31,9 +39,23 @@ namespace GGL {
 		std::filesystem::path checkpointFolder = "C:\\Giga\\GigaLearnCPP-Leak\\checkpoints"; 
 
 		// Save every timestep
-		// Set to zero to just use timestepsPerIteration
+		// Set to zero to save every iteration
 		int64_t tsPerSave = 10'000'000;
 
+		// Adjust ppo.tsPerItr between iterations to balance collection time against consumption (learning) time (see TsPerItrController)
+		// Targets adaptiveTsCollectRatio (collection time / consumption time), or adaptiveTsTargetItrTime seconds per iteration if that's above 0
+		// ppo.tsPerItr is the starting value, and is kept within [adaptiveTsMin, adaptiveTsMax]
+		// The bounds are tightened so there's always at least ppo.batchSize timesteps,
+		//	and no more than half of tsPerSave or tsPerVersion (so no checkpoint or policy version is skipped)
+		// NOTE: The collection ratio often barely changes with tsPerItr, since most of consumption grows with it too,
+		//	so adaptiveTsCollectRatio tends to push tsPerItr to a bound (this is logged), adaptiveTsTargetItrTime is the more reliable target
+		bool adaptiveTsPerItr = false;
+		float adaptiveTsCollectRatio = 1;
+		float adaptiveTsTargetItrTime = 0;
+		int64_t adaptiveTsMin = 25'000;
+		int64_t adaptiveTsMax = 500'000;
+		float adaptiveTsMaxStepScale = 1.25f; // Max change per iteration, as a factor
+
 		int64_t randomSeed = -1; // Set to -1 to use the current time
 		int checkpointsToKeep = 8; // Checkpoint storage limit before old checkpoints are deleted, set to -1 to disable
 		LearnerDeviceType deviceType = LearnerDeviceType::AUTO; // Auto will use your CUDA GPU if available
@@ -53,6 +75,14 @@ namespace GGL {
 		int maxRewardSamples = 50; // Maximum reward samples per step for reward metrics
 		int rewardSampleRandInterval = 8; // Randomized interval range between sampling rewards (per step)
 
+		// Rewards evaluated for all games at once, on top of the rewards from each env (see RLGC::BatchedReward)
+		std::vector<RLGC::WeightedBatchedReward> batchedRewards = {};
+
+		// Ball prediction available to obs builders and rewards through GameState::GetBallPred()
+		// Set ballPredNumStates to 0 to disable
+		int ballPredNumStates = 0;
+		int ballPredTickInterval = 8; // Ticks between predicted states, reuse works best if this divides tickSkip
+
 		// Send metrics to the python metrics receiver
 		// The receiver can then log them to wandb or whatever
 		bool sendMetrics = true;
@@ -60,6 +90,47 @@ namespace GGL {
 		std::string metricsGroupName = "Rocket League"; // Group name for the python metrics receiver
 		std::string metricsRunName = "gigalearncpp-run"; // Run name for the python metrics receiver
 
+		// Also write metrics to a local binary file (see MetricFileWriter), this doesn't need python
+		// Relative paths are relative to checkpointFolder, set empty to disable
+		// If sendMetrics and renderMode are both off, the python interpreter is never initialized
+		std::filesystem::path metricsFilePath = {};
+
+		// Save every iteration's rollout (obs, masks, actions, log probs, rewards, terminals, values) to compressed files in this folder,
+		//	for offline use like behavior cloning or benchmarking PPOLearner::Learn() (see RolloutDatasetWriter and RolloutDataset::LoadIntoExperience())
+		// Files are written from a background thread, relative paths are relative to checkpointFolder, set empty to disable
+		// NOTE: Uncompressed, an iteration is about (obsSize * 4 + numActions) bytes per timestep, so this fills a disk quickly
+		std::filesystem::path rolloutDatasetPath = {};
+		int rolloutDatasetChunkRows = 16384; // Rows per independently-compressed chunk
+
+		// Record a Chrome trace of the training loop (see RLGC::Profiler), open it in chrome://tracing or https://ui.perfetto.dev
+		// Records profileNumIterations iterations, starting after profileStartIteration iterations of this run (to skip warmup)
+		// Set profileNumIterations to 0 to disable
+		int profileNumIterations = 0;
+		int profileStartIteration = 3;
+		std::filesystem::path profileTracePath = "profile_trace.json"; // Relative paths are relative to checkpointFolder
+
+		// Record the env side of collection (every step's actions) for replaying without a policy (see RLGC::RolloutRecorder)
+		// The replay times rolloutRecordNumIterations iterations, starting after rolloutRecordStartIteration iterations of this run
+		// Steps before the window are recorded too, since the replay re-steps them to reach it exactly
+		// Set rolloutRecordNumIterations to 0 to disable
+		int rolloutRecordNumIterations = 0;
+		int rolloutRecordStartIteration = 0;
+		std::filesystem::path rolloutRecordPath = "rollout.ggr"; // Relative paths are relative to checkpointFolder
+
+		// Accept trajectories from external collector processes (see Collector) on this port, set to 0 to disable
+		// Collectors run their own envs with CPU inference, and their complete trajectories are added to each iteration's experience
+		// The policy (and obs standardization) is sent to every collector after each update
+		// NOTE: Obs from collectors don't update the obs standardization stats
+		int collectorPort = 0;
+		std::string collectorAddress = "127.0.0.1"; // Address to listen on, use "0.0.0.0" to accept collectors from other machines
+		int collectorCredits = 4; // Max batches a collector can have sent that the learner hasn't used yet
+		int collectorMaxPolicyLag = 1; // Batches collected with a policy more than this many updates old are dropped
+		int collectorBatchSteps = 10'000; // On the collector, timesteps per batch sent to the learner
+
+		// Memory usage per subsystem is always reported under "Memory/" (see MemoryTracker)
+		// If process memory goes above this many MB, a warning with the breakdown is logged, set to 0 to disable
+		float memWarningThresholdMB = 0;
+
 		bool savePolicyVersions = false;
 		int64_t tsPerVersion = 25'000'000;
 		int maxOldVersions = 32;
@@ -0,0 +1,174 @@
+#include "CollectorLoopbackTest.h"
+
+constexpr int TEST_OBS_SIZE = 8, TEST_NUM_ACTIONS = 5;
+
+// Every INVALID_INTERVAL'th batch is made invalid
+constexpr uint32_t INVALID_INTERVAL = 5;
+
+static bool IsInvalidTestBatch(uint32_t batchIdx) {
+	return (batchIdx % INVALID_INTERVAL) == INVALID_INTERVAL - 1;
+}
+
+// Batch contents only depend on the collector and batch index, so the learner side can rebuild what was sent
+// The first two state values hold those indices
+static void MakeTestBatch(GGL::CollectorTrajBatch& batch, uint32_t collectorIdx, uint32_t batchIdx) {
+	using namespace RLGC;
+	RNG rng = RNG(collectorIdx, batchIdx);
+
+	batch.Clear();
+	batch.policyVersion = 0;
+
+	int numTrajs = rng.RandInt(1, 4);
+	for (int trajIdx = 0; trajIdx < numTrajs; trajIdx++) {
+		int trajLength = rng.RandInt(1, 20);
+		bool truncated = rng.RandInt(0, 2);
+
+		for (int i = 0; i < trajLength; i++) {
+			for (int j = 0; j < TEST_OBS_SIZE; j++)
+				batch.states.push_back(rng.RandFloat(-1, 1));
+			for (int j = 0; j < TEST_NUM_ACTIONS; j++)
+				batch.actionMasks.push_back(rng.RandInt(0, 2));
+
+			batch.rewards.push_back(rng.RandFloat(-1, 1));
+			batch.logProbs.push_back(rng.RandFloat(-5, 0));
+			batch.actions.push_back(rng.RandInt(0, TEST_NUM_ACTIONS));
+
+			if (i < trajLength - 1) {
+				batch.terminals.push_back(TerminalType::NOT_TERMINAL);
+			} else {
+				batch.terminals.push_back(truncated ? TerminalType::TRUNCATED : TerminalType::NORMAL);
+			}
+		}
+
+		if (truncated)
+			for (int j = 0; j < TEST_OBS_SIZE; j++)
+				batch.nextStates.push_back(rng.RandFloat(-1, 1));
+	}
+
+	batch.states[0] = collectorIdx;
+	batch.states[1] = batchIdx;
+
+	if (IsInvalidTestBatch(batchIdx)) {
+		// Cycle through the ways a batch can be broken that still make it through the header checks
+		switch ((batchIdx / INVALID_INTERVAL) % 4) {
+		case 0:
+			batch.actions.back() = TEST_NUM_ACTIONS;
+			break;
+		case 1:
+			batch.terminals.front() = 7;
+			break;
+		case 2:
+			batch.nextStates.resize(batch.nextStates.size() + TEST_OBS_SIZE);
+			break;
+		default:
+			batch.terminals.back() = TerminalType::NOT_TERMINAL;
+			break;
+		}
+	}
+}
+
+static bool TestBatchesMatch(const GGL::CollectorTrajBatch& a, const GGL::CollectorTrajBatch& b) {
+	return
+		a.states == b.states && a.nextStates == b.nextStates && a.rewards == b.rewards && a.logProbs == b.logProbs &&
+		a.actionMasks == b.actionMasks && a.terminals == b.terminals && a.actions == b.actions;
+}
+
+GGL::CollectorLoopbackTestResult GGL::RunCollectorLoopbackTest(int numCollectors, int batchesPerCollector, int numCredits) {
+	RG_ASSERT(numCollectors > 0 && batchesPerCollector > 0);
+
+	CollectorLoopbackTestResult result = {};
+	result.numCollectors = numCollectors;
+	result.batchesPerCollector = batchesPerCollector;
+
+	auto startTime = std::chrono::steady_clock::now();
+
+	CollectorServer server("127.0.0.1", 0, TEST_OBS_SIZE, TEST_NUM_ACTIONS, numCredits);
+
+	std::atomic<uint64_t> validBatchesSent = 0, invalidBatchesSent = 0;
+	std::atomic<int> numFinished = 0;
+	std::vector<std::thread> threads;
+	for (int collectorIdx = 0; collectorIdx < numCollectors; collectorIdx++) {
+		threads.emplace_back(
+			[&, collectorIdx] {
+				CollectorClient client("127.0.0.1", server.port, TEST_OBS_SIZE, TEST_NUM_ACTIONS, 1, 10);
+
+				CollectorTrajBatch batch = {};
+				for (int batchIdx = 0; batchIdx < batchesPerCollector; batchIdx++) {
+					MakeTestBatch(batch, collectorIdx, batchIdx);
+					if (!client.SendBatch(batch, TEST_OBS_SIZE, TEST_NUM_ACTIONS))
+						break;
+
+					if (IsInvalidTestBatch(batchIdx)) {
+						invalidBatchesSent++;
+					} else {
+						validBatchesSent++;
+					}
+				}
+
+				// Wait for every credit to come back, so nothing is still in flight when we say BYE
+				{
+					std::unique_lock<std::mutex> lock(client.mutex);
+					client.cv.wait_for(lock, std::chrono::seconds(30), [&] { return client.credits == numCredits || !client.connected; });
+				}
+
+				client.Close();
+				numFinished++;
+			}
+		);
+	}
+
+	// Learner side
+	std::vector<std::vector<bool>> received(numCollectors, std::vector<bool>(batchesPerCollector));
+	CollectorTrajBatch expected = {};
+	while (true) {
+		auto batches = server.TakeBatches(0);
+		for (CollectorTrajBatch* batch : batches) {
+			result.batchesReceived++;
+
+			int collectorIdx = -1, batchIdx = -1;
+			if (batch->states.size() >= 2) {
+				collectorIdx = (int)batch->states[0];
+				batchIdx = (int)batch->states[1];
+			}
+
+			if (collectorIdx < 0 || collectorIdx >= numCollectors || batchIdx < 0 || batchIdx >= batchesPerCollector) {
+				result.batchesMismatched++;
+				continue;
+			}
+
+			MakeTestBatch(expected, collectorIdx, batchIdx);
+			if (IsInvalidTestBatch(batchIdx) || received[collectorIdx][batchIdx] || !TestBatchesMatch(*batch, expected))
+				result.batchesMismatched++;
+			received[collectorIdx][batchIdx] = true;
+		}
+		server.ReleaseBatches(batches);
+
+		// Collectors only finish once all their credits are back, so there's nothing left to take
+		if (numFinished == numCollectors)
+			break;
+
+		if (batches.empty())
+			THREAD_WAIT();
+	}
+
+	for (auto& thread : threads)
+		thread.join();
+
+	result.validBatchesSent = validBatchesSent;
+	result.invalidBatchesSent = invalidBatchesSent;
+	result.invalidBatchesDropped = server.invalidBatchesDropped;
+	result.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	return result;
+}
+
+std::string GGL::CollectorLoopbackTestResult::ToString() const {
+	std::stringstream stream;
+	stream << "Collector loopback test (" << numCollectors << " collectors, " << batchesPerCollector << " batches each, " << time << "s):\n";
+	stream << "\tValid batches: " << batchesReceived << " received of " << validBatchesSent << " sent";
+	if (batchesMismatched > 0)
+		stream << ", " << batchesMismatched << " MISMATCHED";
+	stream << "\n";
+	stream << "\tInvalid batches: " << invalidBatchesDropped << " rejected of " << invalidBatchesSent << " sent\n";
+	stream << "\t" << (Passed() ? "Passed" : "FAILED") << "\n";
+	return stream.str();
+}
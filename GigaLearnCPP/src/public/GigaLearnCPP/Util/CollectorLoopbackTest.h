@@ -0,0 +1,27 @@
+#pragma once
+#include "CollectorProtocol.h"
+
+namespace GGL {
+	struct CollectorLoopbackTestResult {
+		int numCollectors = 0, batchesPerCollector = 0;
+
+		uint64_t validBatchesSent = 0, invalidBatchesSent = 0;
+		uint64_t batchesReceived = 0; // Taken from the server
+		uint64_t batchesMismatched = 0; // Taken batches that weren't a valid batch exactly as sent, or were taken more than once
+		uint64_t invalidBatchesDropped = 0; // By the server
+		double time = 0; // Seconds
+
+		bool Passed() const {
+			return
+				batchesReceived == validBatchesSent && batchesMismatched == 0 &&
+				invalidBatchesDropped == invalidBatchesSent;
+		}
+
+		std::string ToString() const;
+	};
+
+	// Runs a CollectorServer and several CollectorClients over 127.0.0.1 in this process, each client on its own thread
+	// Every client sends a mix of valid batches and batches that the server should reject, and the learner side checks
+	//	that exactly the valid ones arrive, once each and intact
+	RG_IMEXPORT CollectorLoopbackTestResult RunCollectorLoopbackTest(int numCollectors = 4, int batchesPerCollector = 40, int numCredits = 2);
+}
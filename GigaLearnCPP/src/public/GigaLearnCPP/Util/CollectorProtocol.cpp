@@ -0,0 +1,564 @@
+#include "CollectorProtocol.h"
+
+// Sanity limit on incoming batches, so a bad header can't make us allocate everything
+constexpr uint32_t MAX_BATCH_STEPS = 1 << 24;
+
+static bool SendMsg(GGL::TCPSocket& socket, GGL::CollectorMsgType type, uint32_t policyVersion, const void* payload, uint64_t payloadSize) {
+	GGL::CollectorMsgHeader header = {};
+	header.magic = GGL::CollectorMsgHeader::MAGIC;
+	header.type = type;
+	header.policyVersion = policyVersion;
+	header.payloadSize = payloadSize;
+	return socket.SendVal(header) && (payloadSize == 0 || socket.SendAll(payload, payloadSize));
+}
+
+///////////////////////////////////////////////////////
+
+void GGL::CollectorTrajBatch::Clear() {
+	states.clear();
+	nextStates.clear();
+	rewards.clear();
+	logProbs.clear();
+	actionMasks.clear();
+	terminals.clear();
+	actions.clear();
+}
+
+void GGL::CollectorTrajBatch::Append(const CollectorTrajBatch& other) {
+	states.insert(states.end(), other.states.begin(), other.states.end());
+	nextStates.insert(nextStates.end(), other.nextStates.begin(), other.nextStates.end());
+	rewards.insert(rewards.end(), other.rewards.begin(), other.rewards.end());
+	logProbs.insert(logProbs.end(), other.logProbs.begin(), other.logProbs.end());
+	actionMasks.insert(actionMasks.end(), other.actionMasks.begin(), other.actionMasks.end());
+	terminals.insert(terminals.end(), other.terminals.begin(), other.terminals.end());
+	actions.insert(actions.end(), other.actions.begin(), other.actions.end());
+}
+
+GGL::CollectorBatchHeader GGL::CollectorTrajBatch::MakeHeader(int obsSize, int numActions) const {
+	CollectorBatchHeader header = {};
+	header.numSteps = Length();
+	header.numTruncated = nextStates.size() / obsSize;
+	header.obsSize = obsSize;
+	header.numActions = numActions;
+	return header;
+}
+
+void GGL::CollectorTrajBatch::Resize(const CollectorBatchHeader& header) {
+	states.resize((size_t)header.numSteps * header.obsSize);
+	nextStates.resize((size_t)header.numTruncated * header.obsSize);
+	rewards.resize(header.numSteps);
+	logProbs.resize(header.numSteps);
+	actionMasks.resize((size_t)header.numSteps * header.numActions);
+	terminals.resize(header.numSteps);
+	actions.resize(header.numSteps);
+}
+
+uint64_t GGL::CollectorTrajBatch::GetPayloadSize(const CollectorBatchHeader& header) {
+	uint64_t bytesPerStep =
+		(uint64_t)header.obsSize * sizeof(float) // State
+		+ sizeof(float) * 2 // Reward, log prob
+		+ header.numActions * sizeof(uint8_t) // Action mask
+		+ sizeof(int8_t) + sizeof(int32_t); // Terminal, action
+
+	return sizeof(CollectorBatchHeader) + header.numSteps * bytesPerStep + (uint64_t)header.numTruncated * header.obsSize * sizeof(float);
+}
+
+bool GGL::CollectorTrajBatch::Validate(int obsSize, int numActions, std::string& outError) const {
+	size_t numSteps = Length();
+	if (
+		states.size() != numSteps * obsSize || rewards.size() != numSteps || logProbs.size() != numSteps ||
+		actionMasks.size() != numSteps * numActions || terminals.size() != numSteps || nextStates.size() % obsSize != 0
+		) {
+		outError = "Column lengths don't match";
+		return false;
+	}
+
+	size_t numTruncated = 0;
+	for (size_t i = 0; i < numSteps; i++) {
+		if (actions[i] < 0 || actions[i] >= numActions) {
+			outError = RS_STR("Action " << actions[i] << " at step " << i << " is out of range");
+			return false;
+		}
+
+		int8_t terminal = terminals[i];
+		if (terminal != RLGC::TerminalType::NOT_TERMINAL && terminal != RLGC::TerminalType::NORMAL && terminal != RLGC::TerminalType::TRUNCATED) {
+			outError = RS_STR("Invalid terminal " << (int)terminal << " at step " << i);
+			return false;
+		}
+
+		if (terminal == RLGC::TerminalType::TRUNCATED)
+			numTruncated++;
+	}
+
+	if (numTruncated != nextStates.size() / obsSize) {
+		outError = RS_STR(numTruncated << " truncated steps, but " << (nextStates.size() / obsSize) << " next states");
+		return false;
+	}
+
+	if (numSteps > 0 && terminals.back() == RLGC::TerminalType::NOT_TERMINAL) {
+		outError = "Last step isn't terminal";
+		return false;
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////
+
+bool GGL::CollectorConnection::Send(CollectorMsgType type, uint32_t policyVersion, const void* payload, uint64_t payloadSize) {
+	std::lock_guard<std::mutex> lock(sendMutex);
+	return SendMsg(socket, type, policyVersion, payload, payloadSize);
+}
+
+GGL::CollectorServer::CollectorServer(std::string address, int port, int obsSize, int numActions, int numCredits) :
+	obsSize(obsSize), numActions(numActions), numCredits(numCredits), address(address) {
+
+	RG_LOG("Initializing CollectorServer...");
+
+	if (numCredits < 1)
+		RG_ERR_CLOSE("CollectorServer: Need at least 1 credit per collector, got " << numCredits);
+
+	listenSocket = TCPSocket::Listen(address, port);
+	this->port = listenSocket.GetLocalPort();
+
+	acceptThread = std::thread(&CollectorServer::_RunAcceptThread, this);
+
+	RG_LOG(" > Listening for collectors on " << address << ":" << this->port);
+}
+
+GGL::CollectorServer::~CollectorServer() {
+	stopping = true;
+
+	// Wake up the accept thread by connecting to ourselves
+	// (closing or shutting down a listening socket doesn't reliably wake accept() on every platform)
+	bool anyAddress = address.empty() || address == "0.0.0.0";
+	TCPSocket wakeSocket = TCPSocket::Connect(anyAddress ? "127.0.0.1" : address, port);
+	if (acceptThread.joinable())
+		acceptThread.join();
+	wakeSocket.Close();
+	listenSocket.Close();
+
+	std::vector<std::shared_ptr<CollectorConnection>> conns;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		conns = connections;
+
+		// Break the batch -> connection references of anything not taken
+		for (CollectorTrajBatch* batch : readyBatches)
+			batch->owner = NULL;
+		readyBatches.clear();
+	}
+
+	for (auto& conn : conns) {
+		conn->socket.Shutdown();
+		if (conn->thread.joinable())
+			conn->thread.join();
+	}
+}
+
+void GGL::CollectorServer::SetWeights(uint32_t policyVersion, std::vector<uint8_t> payload) {
+	std::lock_guard<std::mutex> weightsLock(weightsMutex);
+	weightsPayload = std::move(payload);
+	weightsVersion = policyVersion;
+
+	std::vector<std::shared_ptr<CollectorConnection>> conns;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		conns = connections;
+	}
+
+	for (auto& conn : conns) {
+		if (!conn->ready || !conn->alive)
+			continue;
+
+		// If this fails, the connection's thread will notice and clean up
+		if (!conn->Send(CollectorMsgType::WEIGHTS, weightsVersion, weightsPayload.data(), weightsPayload.size()))
+			conn->socket.Shutdown();
+	}
+}
+
+std::vector<GGL::CollectorTrajBatch*> GGL::CollectorServer::TakeBatches(uint32_t minPolicyVersion) {
+	std::vector<CollectorTrajBatch*> result = {};
+	std::vector<CollectorTrajBatch*> staleBatches = {};
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (CollectorTrajBatch* batch : readyBatches) {
+			if (batch->policyVersion < minPolicyVersion) {
+				staleBatches.push_back(batch);
+			} else {
+				result.push_back(batch);
+			}
+		}
+		readyBatches.clear();
+	}
+
+	if (!staleBatches.empty()) {
+		staleBatchesDropped += staleBatches.size();
+		ReleaseBatches(staleBatches);
+	}
+
+	return result;
+}
+
+void GGL::CollectorServer::ReleaseBatches(const std::vector<CollectorTrajBatch*>& batches) {
+	// Credits to give back, sent once we're out of the lock
+	std::vector<std::pair<std::shared_ptr<CollectorConnection>, uint32_t>> credits = {};
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (CollectorTrajBatch* batch : batches) {
+			std::shared_ptr<CollectorConnection> conn = std::move(batch->owner);
+			batch->owner = NULL;
+			conn->freeSlots.push_back(batch);
+
+			bool found = false;
+			for (auto& pair : credits) {
+				if (pair.first == conn) {
+					pair.second++;
+					found = true;
+					break;
+				}
+			}
+			if (!found)
+				credits.push_back({ conn, 1 });
+		}
+	}
+
+	for (auto& pair : credits)
+		if (pair.first->alive && !pair.first->Send(CollectorMsgType::CREDIT, 0, &pair.second, sizeof(uint32_t)))
+			pair.first->socket.Shutdown();
+}
+
+int GGL::CollectorServer::GetNumConnected() {
+	std::lock_guard<std::mutex> lock(mutex);
+	int count = 0;
+	for (auto& conn : connections)
+		if (conn->alive)
+			count++;
+	return count;
+}
+
+void GGL::CollectorServer::_RunAcceptThread() {
+	while (true) {
+		TCPSocket clientSocket = listenSocket.Accept();
+		if (stopping)
+			break;
+
+		if (!clientSocket.IsValid()) {
+			RG_SLEEP(100);
+			continue;
+		}
+
+		clientSocket.SetNoDelay(true);
+
+		auto conn = std::make_shared<CollectorConnection>();
+		conn->socket = std::move(clientSocket);
+
+		// Forget collectors that have disconnected
+		std::vector<std::shared_ptr<CollectorConnection>> deadConns = {};
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			conn->id = nextCollectorID++;
+			for (int i = 0; i < connections.size(); i++) {
+				if (!connections[i]->alive) {
+					deadConns.push_back(connections[i]);
+					connections.erase(connections.begin() + i);
+					i--;
+				}
+			}
+			connections.push_back(conn);
+		}
+
+		for (auto& deadConn : deadConns)
+			if (deadConn->thread.joinable())
+				deadConn->thread.join();
+
+		conn->thread = std::thread(&CollectorServer::_RunConnectionThread, this, conn);
+	}
+}
+
+void GGL::CollectorServer::_RunConnectionThread(std::shared_ptr<CollectorConnection> conn) {
+	TCPSocket& socket = conn->socket;
+
+	CollectorMsgHeader header;
+	CollectorHello hello;
+	bool ok =
+		socket.RecvVal(header) && header.magic == CollectorMsgHeader::MAGIC &&
+		header.type == CollectorMsgType::HELLO && header.payloadSize == sizeof(CollectorHello) &&
+		socket.RecvVal(hello);
+
+	if (!ok) {
+		RG_LOG("CollectorServer: Dropped a connection that didn't start with a valid HELLO");
+	} else if (hello.protocolVersion != CollectorHello::PROTOCOL_VERSION || hello.obsSize != obsSize || hello.numActions != numActions) {
+		RG_LOG(
+			"CollectorServer: Rejected collector " << conn->id << ", its protocol version, obs size, or action amount doesn't match " <<
+			"(got " << hello.protocolVersion << "/" << hello.obsSize << "/" << hello.numActions << ", " <<
+			"expected " << CollectorHello::PROTOCOL_VERSION << "/" << obsSize << "/" << numActions << ")"
+		);
+		conn->Send(CollectorMsgType::BYE, 0, NULL, 0);
+		ok = false;
+	}
+
+	if (ok) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			for (int i = 0; i < numCredits; i++) {
+				conn->slots.push_back(std::make_unique<CollectorTrajBatch>());
+				conn->freeSlots.push_back(conn->slots.back().get());
+			}
+		}
+
+		// Hold the weights lock so that no update is missed or sent twice
+		std::lock_guard<std::mutex> weightsLock(weightsMutex);
+		CollectorWelcome welcome = { conn->id, (uint32_t)numCredits };
+		ok = conn->Send(CollectorMsgType::WELCOME, weightsVersion, &welcome, sizeof(welcome));
+		if (ok && !weightsPayload.empty())
+			ok = conn->Send(CollectorMsgType::WEIGHTS, weightsVersion, weightsPayload.data(), weightsPayload.size());
+		conn->ready = ok;
+	}
+
+	if (ok)
+		RG_LOG("CollectorServer: Collector " << conn->id << " connected (" << hello.numPlayers << " players)");
+
+	while (ok) {
+		if (!socket.RecvVal(header) || header.magic != CollectorMsgHeader::MAGIC)
+			break;
+
+		if (header.type == CollectorMsgType::TRAJ_BATCH) {
+			CollectorBatchHeader batchHeader;
+			if (header.payloadSize < sizeof(CollectorBatchHeader) || !socket.RecvVal(batchHeader))
+				break;
+
+			if (
+				batchHeader.obsSize != obsSize || batchHeader.numActions != numActions ||
+				batchHeader.numSteps > MAX_BATCH_STEPS || batchHeader.numTruncated > batchHeader.numSteps ||
+				CollectorTrajBatch::GetPayloadSize(batchHeader) != header.payloadSize
+				) {
+				RG_LOG("CollectorServer: Collector " << conn->id << " sent an invalid batch, disconnecting");
+				break;
+			}
+
+			CollectorTrajBatch* batch;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (conn->freeSlots.empty()) {
+					RG_LOG("CollectorServer: Collector " << conn->id << " sent a batch without a credit, disconnecting");
+					break;
+				}
+				batch = conn->freeSlots.back();
+				conn->freeSlots.pop_back();
+			}
+
+			// Receive each column straight into the slot's storage
+			batch->Resize(batchHeader);
+			bool received = true;
+			batch->ForEachColumn(
+				[&](void* data, size_t size) {
+					if (received && size > 0)
+						received = socket.RecvAll(data, size);
+				}
+			);
+
+			// Reject bad batches here, so the learner never appends them
+			std::string batchError;
+			bool valid = received && batch->Validate(obsSize, numActions, batchError);
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (!received || !valid) {
+					conn->freeSlots.push_back(batch);
+				} else {
+					batch->policyVersion = header.policyVersion;
+					batch->owner = conn;
+					readyBatches.push_back(batch);
+					batchesReceived++;
+				}
+			}
+
+			if (!received)
+				break;
+			bytesReceived += sizeof(CollectorMsgHeader) + header.payloadSize;
+
+			if (!valid) {
+				RG_LOG("CollectorServer: Rejected a batch from collector " << conn->id << ": " << batchError);
+				invalidBatchesDropped++;
+
+				uint32_t amount = 1;
+				if (!conn->Send(CollectorMsgType::CREDIT, 0, &amount, sizeof(amount)))
+					break;
+			}
+
+		} else if (header.type == CollectorMsgType::BYE) {
+			break;
+		} else {
+			RG_LOG("CollectorServer: Collector " << conn->id << " sent an unexpected message (type " << (uint32_t)header.type << "), disconnecting");
+			break;
+		}
+	}
+
+	conn->alive = false;
+	conn->socket.Shutdown();
+
+	if (conn->ready)
+		RG_LOG("CollectorServer: Collector " << conn->id << " disconnected");
+}
+
+///////////////////////////////////////////////////////
+
+GGL::CollectorClient::CollectorClient(std::string address, int port, int obsSize, int numActions, int numPlayers, float connectTimeout) {
+	RG_LOG("Connecting to learner at " << address << ":" << port << "...");
+
+	auto startTime = std::chrono::steady_clock::now();
+	while (true) {
+		socket = TCPSocket::Connect(address, port);
+		if (socket.IsValid())
+			break;
+
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+		if (elapsed.count() > connectTimeout)
+			RG_ERR_CLOSE("CollectorClient: Failed to connect to the learner at " << address << ":" << port << " after " << connectTimeout << "s");
+		RG_SLEEP(500);
+	}
+	socket.SetNoDelay(true);
+
+	CollectorHello hello = {};
+	hello.protocolVersion = CollectorHello::PROTOCOL_VERSION;
+	hello.obsSize = obsSize;
+	hello.numActions = numActions;
+	hello.numPlayers = numPlayers;
+	if (!SendMsg(socket, CollectorMsgType::HELLO, 0, &hello, sizeof(hello)))
+		RG_ERR_CLOSE("CollectorClient: Lost connection to the learner while sending HELLO");
+
+	CollectorMsgHeader header;
+	if (!socket.RecvVal(header) || header.magic != CollectorMsgHeader::MAGIC)
+		RG_ERR_CLOSE("CollectorClient: Lost connection to the learner while waiting for WELCOME");
+
+	if (header.type == CollectorMsgType::BYE)
+		RG_ERR_CLOSE("CollectorClient: The learner rejected this collector, make sure the obs builder and action parser match the learner's");
+
+	CollectorWelcome welcome;
+	if (header.type != CollectorMsgType::WELCOME || header.payloadSize != sizeof(welcome) || !socket.RecvVal(welcome))
+		RG_ERR_CLOSE("CollectorClient: Invalid response to HELLO from the learner");
+
+	collectorID = welcome.collectorID;
+	credits = welcome.numCredits;
+	connected = true;
+
+	recvThread = std::thread(&CollectorClient::_RunRecvThread, this);
+
+	RG_LOG(" > Connected as collector " << collectorID << " (" << credits << " credits)");
+}
+
+GGL::CollectorClient::~CollectorClient() {
+	Close();
+}
+
+bool GGL::CollectorClient::IsConnected() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return connected;
+}
+
+bool GGL::CollectorClient::TakeWeights(std::vector<uint8_t>& outPayload, uint32_t& outPolicyVersion, bool wait) {
+	std::unique_lock<std::mutex> lock(mutex);
+	if (wait)
+		cv.wait(lock, [&] { return hasNewWeights || !connected; });
+
+	if (!hasNewWeights)
+		return false;
+
+	std::swap(outPayload, latestWeights);
+	outPolicyVersion = latestWeightsVersion;
+	hasNewWeights = false;
+	return true;
+}
+
+bool GGL::CollectorClient::SendBatch(CollectorTrajBatch& batch, int obsSize, int numActions, double* outWaitTime) {
+	{
+		auto startTime = std::chrono::steady_clock::now();
+		std::unique_lock<std::mutex> lock(mutex);
+		cv.wait(lock, [&] { return credits > 0 || !connected; });
+
+		if (outWaitTime) {
+			std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+			*outWaitTime = elapsed.count();
+		}
+
+		if (!connected)
+			return false;
+		credits--;
+	}
+
+	CollectorBatchHeader batchHeader = batch.MakeHeader(obsSize, numActions);
+	uint64_t payloadSize = CollectorTrajBatch::GetPayloadSize(batchHeader);
+
+	CollectorMsgHeader header = {};
+	header.magic = CollectorMsgHeader::MAGIC;
+	header.type = CollectorMsgType::TRAJ_BATCH;
+	header.policyVersion = batch.policyVersion;
+	header.payloadSize = payloadSize;
+
+	// Send each column straight from the batch
+	bool sent = socket.SendVal(header) && socket.SendVal(batchHeader);
+	batch.ForEachColumn(
+		[&](void* data, size_t size) {
+			if (sent && size > 0)
+				sent = socket.SendAll(data, size);
+		}
+	);
+
+	if (!sent) {
+		socket.Shutdown();
+		return false;
+	}
+
+	bytesSent += sizeof(CollectorMsgHeader) + payloadSize;
+	return true;
+}
+
+void GGL::CollectorClient::Close() {
+	if (recvThread.joinable()) {
+		if (IsConnected())
+			SendMsg(socket, CollectorMsgType::BYE, 0, NULL, 0);
+		socket.Shutdown();
+		recvThread.join();
+	}
+	socket.Close();
+}
+
+void GGL::CollectorClient::_RunRecvThread() {
+	std::vector<uint8_t> recvBuffer = {};
+
+	while (true) {
+		CollectorMsgHeader header;
+		if (!socket.RecvVal(header) || header.magic != CollectorMsgHeader::MAGIC)
+			break;
+
+		if (header.type == CollectorMsgType::WEIGHTS) {
+			recvBuffer.resize(header.payloadSize);
+			if (!socket.RecvAll(recvBuffer.data(), recvBuffer.size()))
+				break;
+
+			std::lock_guard<std::mutex> lock(mutex);
+			std::swap(latestWeights, recvBuffer);
+			latestWeightsVersion = header.policyVersion;
+			hasNewWeights = true;
+			cv.notify_all();
+
+		} else if (header.type == CollectorMsgType::CREDIT) {
+			uint32_t amount;
+			if (header.payloadSize != sizeof(amount) || !socket.RecvVal(amount))
+				break;
+
+			std::lock_guard<std::mutex> lock(mutex);
+			credits += amount;
+			cv.notify_all();
+
+		} else {
+			// BYE, or something we don't understand
+			break;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	connected = false;
+	cv.notify_all();
+}
@@ -0,0 +1,233 @@
+#pragma once
+#include "TCPSocket.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+
+namespace GGL {
+	// Protocol between the learner and external collector processes (see Collector), over TCP
+	//
+	// Every message is a CollectorMsgHeader followed by payloadSize bytes (native endianness, so both ends must be the same platform)
+	// Collector -> learner:
+	//	HELLO: CollectorHello, must be the first message
+	//	TRAJ_BATCH: CollectorBatchHeader, then the columns of CollectorTrajBatch as raw arrays, in the order of CollectorTrajBatch::ForEachColumn()
+	//		The message's policyVersion is the oldest policy version any step in the batch was collected with
+	//	BYE: Empty
+	// Learner -> collector:
+	//	WELCOME: CollectorWelcome, the response to HELLO
+	//	WEIGHTS: CollectorWeightsHeader, then numParams floats of policy parameters (every policy model's parameters in ModelSet order),
+	//		then obsNormSize floats of obs means and obsNormSize floats of obs STDs (already clamped, see Collector::MakeWeightsPayload())
+	//		The message's policyVersion is the version of these weights
+	//		Sent right after WELCOME, then again after every update
+	//	CREDIT: uint32 amount
+	//	BYE: Empty, e.g. if HELLO didn't match the learner
+	//
+	// Backpressure is credit-based: a collector can only have CollectorWelcome::numCredits batches sent that the learner hasn't consumed yet,
+	//	and each batch the learner consumes (or drops) gives one credit back
+	// So the learner never holds more than numCredits batches per collector, and collectors stop collecting when the learner falls behind
+	enum class CollectorMsgType : uint32_t {
+		HELLO = 1,
+		WELCOME,
+		WEIGHTS,
+		TRAJ_BATCH,
+		CREDIT,
+		BYE
+	};
+
+	struct CollectorMsgHeader {
+		static constexpr uint32_t MAGIC = 0x4C434747; // "GGCL"
+
+		uint32_t magic;
+		CollectorMsgType type;
+		uint32_t policyVersion;
+		uint32_t _pad;
+		uint64_t payloadSize;
+	};
+	static_assert(sizeof(CollectorMsgHeader) == 24);
+
+	struct CollectorHello {
+		static constexpr uint32_t PROTOCOL_VERSION = 1;
+
+		uint32_t protocolVersion;
+		uint32_t obsSize;
+		uint32_t numActions;
+		uint32_t numPlayers;
+	};
+
+	struct CollectorWelcome {
+		uint32_t collectorID;
+		uint32_t numCredits;
+	};
+
+	struct CollectorWeightsHeader {
+		uint64_t numParams;
+		uint32_t obsNormSize; // 0 if obs aren't standardized (yet)
+		uint32_t _pad;
+	};
+
+	struct CollectorBatchHeader {
+		uint32_t numSteps;
+		uint32_t numTruncated; // Rows of nextStates
+		uint32_t obsSize;
+		uint32_t numActions;
+	};
+
+	struct CollectorConnection;
+
+	// Complete trajectories from a collector, laid out like the learner's combined trajectory
+	// Every trajectory ends with a nonzero terminal, and truncated trajectories have their next state in nextStates
+	struct RG_IMEXPORT CollectorTrajBatch {
+		uint32_t policyVersion = 0;
+
+		FList states, nextStates, rewards, logProbs;
+		std::vector<uint8_t> actionMasks;
+		std::vector<int8_t> terminals;
+		std::vector<int32_t> actions;
+
+		// Set by CollectorServer while the batch is queued or taken, so the slot can go back to its collector
+		std::shared_ptr<CollectorConnection> owner = {};
+
+		size_t Length() const {
+			return actions.size();
+		}
+
+		void Clear();
+		void Append(const CollectorTrajBatch& other);
+
+		CollectorBatchHeader MakeHeader(int obsSize, int numActions) const;
+
+		// Resizes every column for this header
+		// Capacity is kept, so once a slot has seen a batch this size, receiving into it doesn't allocate
+		void Resize(const CollectorBatchHeader& header);
+
+		// Size of a TRAJ_BATCH payload with this header
+		static uint64_t GetPayloadSize(const CollectorBatchHeader& header);
+
+		// Checks that the columns agree in length, actions and terminals are in range, every truncated step has a next state,
+		//	and the last trajectory is complete
+		// Returns false and sets outError if not
+		bool Validate(int obsSize, int numActions, std::string& outError) const;
+
+		// Calls fn(data, size) for each column's raw bytes, in wire order
+		template <typename FN>
+		void ForEachColumn(FN fn) {
+			fn(states.data(), states.size() * sizeof(float));
+			fn(nextStates.data(), nextStates.size() * sizeof(float));
+			fn(rewards.data(), rewards.size() * sizeof(float));
+			fn(logProbs.data(), logProbs.size() * sizeof(float));
+			fn(actionMasks.data(), actionMasks.size() * sizeof(uint8_t));
+			fn(terminals.data(), terminals.size() * sizeof(int8_t));
+			fn(actions.data(), actions.size() * sizeof(int32_t));
+		}
+	};
+
+	// Learner side of a connected collector
+	struct CollectorConnection {
+		uint32_t id;
+		TCPSocket socket;
+		std::mutex sendMutex;
+		std::thread thread;
+		std::atomic<bool> alive = true;
+		bool ready = false; // Welcomed and sent the current weights, guarded by CollectorServer::weightsMutex
+
+		// One slot per credit, received batches are written straight into them
+		std::vector<std::unique_ptr<CollectorTrajBatch>> slots;
+		std::vector<CollectorTrajBatch*> freeSlots; // Guarded by CollectorServer::mutex
+
+		bool Send(CollectorMsgType type, uint32_t policyVersion, const void* payload, uint64_t payloadSize);
+	};
+
+	// Accepts collector connections and receives their batches on a thread per collector
+	class RG_IMEXPORT CollectorServer {
+	public:
+		int obsSize, numActions;
+		int numCredits; // Max batches in flight per collector
+
+		TCPSocket listenSocket;
+		std::string address;
+		int port;
+		std::thread acceptThread;
+		std::atomic<bool> stopping = false;
+
+		std::mutex mutex;
+		std::vector<std::shared_ptr<CollectorConnection>> connections;
+		std::deque<CollectorTrajBatch*> readyBatches;
+		uint32_t nextCollectorID = 0;
+
+		// The latest weights, also sent to collectors that connect later
+		std::mutex weightsMutex;
+		std::vector<uint8_t> weightsPayload;
+		uint32_t weightsVersion = 0;
+
+		std::atomic<uint64_t>
+			bytesReceived = 0,
+			batchesReceived = 0,
+			staleBatchesDropped = 0,
+			invalidBatchesDropped = 0; // Batches that failed CollectorTrajBatch::Validate(), their credits are returned right away
+
+		// Port 0 picks a free port, see the port member afterwards
+		CollectorServer(std::string address, int port, int obsSize, int numActions, int numCredits);
+		~CollectorServer();
+
+		RG_NO_COPY(CollectorServer);
+
+		// Stores the new weights and sends them to every connected collector
+		// Blocks until they've been handed to each collector's socket
+		void SetWeights(uint32_t policyVersion, std::vector<uint8_t> payload);
+
+		// Takes every batch received so far
+		// Batches whose policy version is older than minPolicyVersion are dropped (and their credits returned) instead
+		std::vector<CollectorTrajBatch*> TakeBatches(uint32_t minPolicyVersion);
+
+		// Gives batches from TakeBatches() back to their collectors, once you're done reading them
+		void ReleaseBatches(const std::vector<CollectorTrajBatch*>& batches);
+
+		int GetNumConnected();
+
+	private:
+		void _RunAcceptThread();
+		void _RunConnectionThread(std::shared_ptr<CollectorConnection> conn);
+	};
+
+	// Collector side of the connection
+	class RG_IMEXPORT CollectorClient {
+	public:
+		TCPSocket socket;
+		uint32_t collectorID = 0;
+
+		std::thread recvThread;
+		std::mutex mutex;
+		std::condition_variable cv;
+		bool connected = false;
+		int credits = 0;
+
+		std::vector<uint8_t> latestWeights;
+		uint32_t latestWeightsVersion = 0;
+		bool hasNewWeights = false;
+
+		std::atomic<uint64_t> bytesSent = 0;
+
+		// Connects and sends HELLO, retrying for up to connectTimeout seconds (e.g. while the learner is still starting)
+		CollectorClient(std::string address, int port, int obsSize, int numActions, int numPlayers, float connectTimeout = 60);
+		~CollectorClient();
+
+		RG_NO_COPY(CollectorClient);
+
+		bool IsConnected();
+
+		// Swaps out the newest weights, if any arrived since the last call
+		// If wait is set, blocks until they do (or the connection closes)
+		bool TakeWeights(std::vector<uint8_t>& outPayload, uint32_t& outPolicyVersion, bool wait);
+
+		// Blocks until there's a credit, then sends the batch
+		// Returns false if the connection closed
+		bool SendBatch(CollectorTrajBatch& batch, int obsSize, int numActions, double* outWaitTime = NULL);
+
+		void Close();
+
+	private:
+		void _RunRecvThread();
+	};
+}
@@ -0,0 +1,199 @@
+#include "InferBroker.h"
+
+GGL::InferBroker::InferBroker(InferUnit* inferUnit, float batchWindow, bool deterministic) :
+	inferUnit(inferUnit), batchWindow(batchWindow), deterministic(deterministic) {
+
+	RG_ASSERT(inferUnit);
+	thread = std::thread(&InferBroker::_RunThread, this);
+}
+
+GGL::InferBroker::~InferBroker() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	requestCV.notify_all();
+	resultCV.notify_all();
+	if (thread.joinable())
+		thread.join();
+}
+
+int GGL::InferBroker::AddClient() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	int clientID = -1;
+	for (int i = 0; i < clients.size(); i++) {
+		if (!clients[i].active) {
+			clientID = i;
+			break;
+		}
+	}
+
+	if (clientID == -1) {
+		clientID = clients.size();
+		clients.push_back({});
+	}
+
+	uint64_t generation = clients[clientID].generation + 1;
+	clients[clientID] = {};
+	clients[clientID].active = true;
+	clients[clientID].generation = generation;
+	numActiveClients++;
+	return clientID;
+}
+
+void GGL::InferBroker::RemoveClient(int clientID) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		Client& client = clients[clientID];
+		if (!client.active)
+			return;
+
+		client.active = false;
+		client.hasRequest = false;
+		numActiveClients--;
+	}
+
+	// The worker may be waiting on this client for its batch
+	requestCV.notify_all();
+}
+
+uint64_t GGL::InferBroker::Submit(int clientID, const RLGC::Player& player, RLGC::GameState state) {
+	uint64_t requestSeq;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		Client& client = clients[clientID];
+		RG_ASSERT(client.active);
+
+		client.player = player;
+		client.state = std::move(state);
+
+		// The caller's previous state can be overwritten while this request is being inferred, so keep our own copy
+		client.hasPrev = client.state.prev != NULL;
+		if (client.hasPrev) {
+			client.prevState = *client.state.prev;
+			client.prevState.prev = NULL;
+			for (auto& prevPlayer : client.prevState.players)
+				prevPlayer.prev = NULL;
+		}
+
+		client.hasRequest = true;
+		requestSeq = ++client.requestSeq;
+	}
+	requestCV.notify_all();
+	return requestSeq;
+}
+
+bool GGL::InferBroker::WaitResult(int clientID, uint64_t requestSeq, RLGC::Action& outAction, float timeout) {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	// Clients can be added while we wait, so don't hold a reference into the client list
+	auto isDone = [&] { return clients[clientID].resultSeq >= requestSeq; };
+	if (!isDone()) {
+		if (timeout <= 0)
+			return false;
+
+		if (!resultCV.wait_for(lock, std::chrono::duration<float>(timeout), [&] { return isDone() || stopping; }) || !isDone())
+			return false;
+	}
+
+	outAction = clients[clientID].result;
+	return true;
+}
+
+void GGL::InferBroker::_LinkPrev(RLGC::GameState& state, RLGC::Player& player, RLGC::GameState* prevState) {
+	state.prev = prevState;
+
+	// Players line up by index if the player count didn't change, like in GameState::UpdateFromArena()
+	bool playersMatch = prevState && prevState->players.size() == state.players.size();
+	for (int i = 0; i < state.players.size(); i++)
+		state.players[i].prev = playersMatch ? &prevState->players[i] : NULL;
+
+	player.prev = NULL;
+	if (prevState) {
+		for (auto& prevPlayer : prevState->players) {
+			if (prevPlayer.carId == player.carId) {
+				player.prev = &prevPlayer;
+				break;
+			}
+		}
+	}
+}
+
+void GGL::InferBroker::_RunThread() {
+	std::vector<int> batchClientIDs = {};
+	std::vector<uint64_t> batchGenerations = {};
+	std::vector<uint64_t> batchSeqs = {};
+	std::vector<RLGC::Player> batchPlayers = {};
+	std::vector<RLGC::GameState> batchStates = {};
+	std::vector<RLGC::GameState> batchPrevStates = {};
+	std::vector<uint8_t> batchHasPrev = {};
+
+	auto countRequests = [&] {
+		int count = 0;
+		for (auto& client : clients)
+			count += client.hasRequest;
+		return count;
+	};
+
+	while (true) {
+		std::unique_lock<std::mutex> lock(mutex);
+		requestCV.wait(lock, [&] { return stopping || countRequests() > 0; });
+		if (stopping)
+			break;
+
+		// Give the other clients until the end of the window to submit their requests for this tick
+		auto windowEnd = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(batchWindow));
+		requestCV.wait_until(lock, windowEnd, [&] { return stopping || countRequests() >= numActiveClients; });
+		if (stopping)
+			break;
+
+		batchClientIDs.clear();
+		batchGenerations.clear();
+		batchSeqs.clear();
+		batchPlayers.clear();
+		batchStates.clear();
+		batchHasPrev.clear();
+		for (int i = 0; i < clients.size(); i++) {
+			Client& client = clients[i];
+			if (!client.hasRequest)
+				continue;
+
+			client.hasRequest = false;
+			batchClientIDs.push_back(i);
+			batchGenerations.push_back(client.generation);
+			batchSeqs.push_back(client.requestSeq);
+			batchPlayers.push_back(client.player);
+			batchStates.push_back(std::move(client.state));
+			batchHasPrev.push_back(client.hasPrev);
+
+			// Swap rather than move, so both keep their allocations for the next requests
+			if (batchPrevStates.size() < batchStates.size())
+				batchPrevStates.emplace_back();
+			if (client.hasPrev)
+				std::swap(batchPrevStates[batchStates.size() - 1], client.prevState);
+		}
+		lock.unlock();
+
+		// The prevs still point into the submitter's buffers, so point them at our copies instead
+		for (int i = 0; i < batchStates.size(); i++)
+			_LinkPrev(batchStates[i], batchPlayers[i], batchHasPrev[i] ? &batchPrevStates[i] : NULL);
+
+		std::vector<RLGC::Action> actions = inferUnit->BatchInferActions(batchPlayers, batchStates, deterministic);
+
+		lock.lock();
+		for (int i = 0; i < batchClientIDs.size(); i++) {
+			Client& client = clients[batchClientIDs[i]];
+			// The slot may have been given to a new client during inference, whose sequence numbers started over
+			if (client.active && client.generation == batchGenerations[i] && batchSeqs[i] > client.resultSeq) {
+				client.result = actions[i];
+				client.resultSeq = batchSeqs[i];
+			}
+		}
+		numBatches++;
+		numRequests += batchClientIDs.size();
+		lock.unlock();
+
+		resultCV.notify_all();
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "InferUnit.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace GGL {
+	// Shares one InferUnit between several bots in the same process (e.g. every bot of an RLBot BotManager)
+	// Each bot submits its request for the tick, and a worker thread runs them all through one batched forward
+	// A batch runs as soon as every client has a request, or batchWindow seconds after the first request came in,
+	//	so a bot that is late for a tick never holds up the others (its request just goes in the next batch)
+	class RG_IMEXPORT InferBroker {
+	public:
+		InferUnit* inferUnit;
+		float batchWindow;
+		bool deterministic;
+
+		std::atomic<uint64_t>
+			numBatches = 0,
+			numRequests = 0;
+
+		// Does not take ownership of the InferUnit
+		InferBroker(InferUnit* inferUnit, float batchWindow = 0.002f, bool deterministic = true);
+		~InferBroker();
+
+		RG_NO_COPY(InferBroker);
+
+		int AddClient();
+		void RemoveClient(int clientID);
+
+		// Queues a request for this client, replacing any request it still has pending
+		// The state's prev (and its players' prevs) can point into the caller's buffers, since the previous state is copied here,
+		//	so they only need to stay valid until this returns
+		// Returns the request's sequence number, for WaitResult()
+		uint64_t Submit(int clientID, const RLGC::Player& player, RLGC::GameState state);
+
+		// Waits up to timeout seconds for the result of this request (or a newer one)
+		// Returns false if it isn't done by then, it can be checked again later with a timeout of 0
+		bool WaitResult(int clientID, uint64_t requestSeq, RLGC::Action& outAction, float timeout);
+
+		float GetAvgBatchSize() const {
+			return numBatches ? (float)numRequests / numBatches : 0;
+		}
+
+	private:
+		struct Client {
+			bool active = false;
+			bool hasRequest = false;
+			uint64_t generation = 0; // Incremented each time the slot is given to a new client, so a batch can't return results to the wrong one
+			uint64_t requestSeq = 0, resultSeq = 0;
+			RLGC::Player player;
+			RLGC::GameState state;
+			RLGC::GameState prevState; // Copy of *state.prev, only used if hasPrev
+			bool hasPrev = false;
+			RLGC::Action result = {};
+		};
+
+		std::vector<Client> clients;
+		int numActiveClients = 0;
+
+		std::thread thread;
+		std::mutex mutex;
+		std::condition_variable requestCV, resultCV;
+		bool stopping = false;
+
+		void _RunThread();
+
+		// Points the state's and player's prevs at prevState (or NULL if there is none)
+		static void _LinkPrev(RLGC::GameState& state, RLGC::Player& player, RLGC::GameState* prevState);
+	};
+}
@@ -0,0 +1,81 @@
+#include "MemoryTracker.h"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
+using namespace GGL;
+
+constexpr double BYTES_TO_MB = 1.0 / (1024 * 1024);
+
+uint64_t GGL::MemoryTracker::GetTrackedBytes() const {
+	uint64_t total = pythonBytes;
+	for (auto& entry : entries)
+		total += entry.bytes;
+	return total;
+}
+
+void GGL::MemoryTracker::Finish(Report& report) {
+	uint64_t trackedBytes = GetTrackedBytes();
+	uint64_t rssBytes = GetProcessRSS();
+	peakTrackedBytes = RS_MAX(peakTrackedBytes, trackedBytes);
+	peakRSSBytes = RS_MAX(peakRSSBytes, rssBytes);
+
+	for (auto& entry : entries)
+		report["Memory/" + entry.name + " MB"] = entry.bytes * BYTES_TO_MB;
+	if (pythonBytes > 0)
+		report["Memory/Python MB"] = pythonBytes * BYTES_TO_MB;
+
+	report["Memory/Tracked MB"] = trackedBytes * BYTES_TO_MB;
+	report["Memory/Peak Tracked MB"] = peakTrackedBytes * BYTES_TO_MB;
+	if (rssBytes > 0) {
+		report["Memory/Process RSS MB"] = rssBytes * BYTES_TO_MB;
+		report["Memory/Peak Process RSS MB"] = peakRSSBytes * BYTES_TO_MB;
+		report["Memory/Untracked MB"] = (rssBytes > trackedBytes ? rssBytes - trackedBytes : 0) * BYTES_TO_MB;
+	}
+
+	if (warningThresholdBytes > 0) {
+		uint64_t usedBytes = rssBytes > 0 ? rssBytes : trackedBytes;
+		if (usedBytes > warningThresholdBytes) {
+			if (!overThreshold) {
+				std::stringstream breakdown;
+				for (auto& entry : entries)
+					breakdown << "\n\t" << entry.name << ": " << (int)(entry.bytes * BYTES_TO_MB) << "MB";
+				if (pythonBytes > 0)
+					breakdown << "\n\tPython: " << (int)(pythonBytes * BYTES_TO_MB) << "MB";
+
+				RG_LOG(
+					"WARNING: Memory usage (" << (int)(usedBytes * BYTES_TO_MB) << "MB) " <<
+					"is above the warning threshold (" << (int)(warningThresholdBytes * BYTES_TO_MB) << "MB), tracked usage:" << breakdown.str()
+				);
+			}
+			overThreshold = true;
+		} else {
+			overThreshold = false;
+		}
+	}
+
+	entries.clear();
+}
+
+uint64_t GGL::MemoryTracker::GetProcessRSS() {
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.WorkingSetSize;
+	return 0;
+#elif defined(__linux__)
+	// Second field of statm is the resident page count
+	std::ifstream statmIn("/proc/self/statm");
+	uint64_t totalPages = 0, residentPages = 0;
+	if (!(statmIn >> totalPages >> residentPages))
+		return 0;
+	return residentPages * (uint64_t)sysconf(_SC_PAGESIZE);
+#else
+	return 0;
+#endif
+}
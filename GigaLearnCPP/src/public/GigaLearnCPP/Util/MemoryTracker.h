@@ -0,0 +1,39 @@
+#pragma once
+#include "Report.h"
+
+namespace GGL {
+	// Per-subsystem memory accounting, reported every iteration under "Memory/"
+	// Subsystem sizes are estimates from container capacities and tensor storages (see Add())
+	// Process RSS is measured, whatever it has beyond the tracked subsystems is reported as untracked (allocator slack, libraries, etc.)
+	struct RG_IMEXPORT MemoryTracker {
+		struct Entry {
+			std::string name;
+			uint64_t bytes;
+		};
+
+		// Entries added this iteration, in the order they were added
+		std::vector<Entry> entries;
+
+		// Measured RSS growth from initializing python and its modules, added as its own entry every iteration
+		uint64_t pythonBytes = 0;
+
+		uint64_t peakTrackedBytes = 0, peakRSSBytes = 0;
+
+		// Log a warning when process RSS goes above this, 0 to disable
+		uint64_t warningThresholdBytes = 0;
+		bool overThreshold = false;
+
+		void Add(const std::string& name, uint64_t bytes) {
+			entries.push_back({ name, bytes });
+		}
+
+		uint64_t GetTrackedBytes() const;
+
+		// Writes every entry, the totals and the peaks to the report, then clears the entries
+		// Also warns (once per crossing) if RSS is above warningThresholdBytes
+		void Finish(Report& report);
+
+		// Current resident set size of this process in bytes, 0 if unavailable
+		static uint64_t GetProcessRSS();
+	};
+}
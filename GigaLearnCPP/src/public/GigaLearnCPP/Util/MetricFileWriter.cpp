@@ -0,0 +1,138 @@
+#include "MetricFileWriter.h"
+
+using namespace GGL;
+
+template <typename T>
+static void WriteVal(std::ostream& out, const T& val) {
+	out.write((const char*)&val, sizeof(T));
+}
+
+template <typename T>
+static bool ReadVal(std::istream& in, T& val) {
+	in.read((char*)&val, sizeof(T));
+	return in.good();
+}
+
+GGL::MetricFileWriter::MetricFileWriter(std::filesystem::path path) : path(path) {
+	RG_LOG("Initializing MetricFileWriter...");
+
+	if (path.has_parent_path())
+		std::filesystem::create_directories(path.parent_path());
+
+	bool exists = std::filesystem::exists(path);
+	if (exists) {
+		uint64_t validSize = ReadExisting();
+		if (validSize < std::filesystem::file_size(path)) {
+			RG_LOG(" > Discarding " << (std::filesystem::file_size(path) - validSize) << " bytes of incomplete data at the end of the file");
+			std::filesystem::resize_file(path, validSize);
+		}
+	}
+
+	fileOut = std::ofstream(path, std::ios::binary | std::ios::app);
+	if (!fileOut.good())
+		RG_ERR_CLOSE("MetricFileWriter: Failed to open " << path << " for writing");
+
+	if (!exists) {
+		fileOut.write(MAGIC, sizeof(MAGIC));
+		WriteVal(fileOut, VERSION);
+		fileOut.flush();
+	}
+
+	RG_LOG(" > " << (exists ? "Continuing" : "Writing") << " metrics file " << path << " (" << columns.size() << " existing columns)");
+}
+
+uint64_t GGL::MetricFileWriter::ReadExisting() {
+	std::ifstream fileIn(path, std::ios::binary);
+	if (!fileIn.good())
+		RG_ERR_CLOSE("MetricFileWriter: Failed to open existing file " << path);
+
+	char magic[sizeof(MAGIC)];
+	uint32_t version;
+	fileIn.read(magic, sizeof(magic));
+	if (!fileIn.good() || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !ReadVal(fileIn, version))
+		RG_ERR_CLOSE("MetricFileWriter: Existing file " << path << " is not a metrics file");
+	if (version != VERSION)
+		RG_ERR_CLOSE("MetricFileWriter: Existing file " << path << " has version " << version << ", expected " << VERSION);
+
+	uint64_t fileSize = std::filesystem::file_size(path);
+	uint64_t validSize = fileIn.tellg();
+	while (true) {
+		uint8_t type;
+		uint32_t count;
+		if (!ReadVal(fileIn, type) || !ReadVal(fileIn, count))
+			break;
+
+		if (type == 'C') {
+			std::vector<std::string> newColumns;
+			for (uint32_t i = 0; i < count; i++) {
+				uint16_t len;
+				if (!ReadVal(fileIn, len))
+					break;
+				std::string name(len, '\0');
+				fileIn.read(name.data(), len);
+				if (!fileIn.good())
+					break;
+				newColumns.push_back(name);
+			}
+
+			if (newColumns.size() != count)
+				break;
+
+			for (auto& name : newColumns) {
+				columnIndices[name] = columns.size();
+				columns.push_back(name);
+			}
+		} else if (type == 'R') {
+			if (count > columns.size())
+				RG_ERR_CLOSE("MetricFileWriter: Existing file " << path << " has a row with more values than columns");
+			uint64_t rowEnd = (uint64_t)fileIn.tellg() + count * sizeof(double);
+			if (rowEnd > fileSize)
+				break;
+			fileIn.seekg(rowEnd);
+		} else {
+			RG_ERR_CLOSE("MetricFileWriter: Existing file " << path << " has an invalid record type (" << (int)type << ")");
+		}
+
+		int64_t pos = fileIn.tellg();
+		if (pos < 0)
+			break;
+		validSize = pos;
+	}
+
+	return validSize;
+}
+
+void GGL::MetricFileWriter::Write(const Report& report) {
+	std::vector<std::string> newColumns = {};
+	for (auto& pair : report.data)
+		if (columnIndices.find(pair.first) == columnIndices.end())
+			newColumns.push_back(pair.first);
+
+	if (!newColumns.empty()) {
+		// Sort so the column order doesn't depend on hash map order
+		std::sort(newColumns.begin(), newColumns.end());
+
+		fileOut.put('C');
+		WriteVal(fileOut, (uint32_t)newColumns.size());
+		for (auto& name : newColumns) {
+			uint16_t len = (uint16_t)std::min<size_t>(name.size(), UINT16_MAX);
+			WriteVal(fileOut, len);
+			fileOut.write(name.data(), len);
+
+			columnIndices[name] = columns.size();
+			columns.push_back(name);
+		}
+	}
+
+	std::vector<double> row(columns.size(), NAN);
+	for (auto& pair : report.data)
+		row[columnIndices[pair.first]] = pair.second;
+
+	fileOut.put('R');
+	WriteVal(fileOut, (uint32_t)row.size());
+	fileOut.write((const char*)row.data(), row.size() * sizeof(double));
+	fileOut.flush();
+
+	if (!fileOut.good())
+		RG_LOG("MetricFileWriter: Failed to write metrics to " << path);
+}
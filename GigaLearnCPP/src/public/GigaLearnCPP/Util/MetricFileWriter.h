@@ -0,0 +1,39 @@
+#pragma once
+#include "Report.h"
+#include <fstream>
+
+namespace GGL {
+	// Native metrics sink, appends every report to a local binary file (no python needed)
+	//
+	// File layout (little-endian):
+	//	Header: "GGLMETRC" magic, uint32 version
+	//	Then a sequence of records, each starting with a uint8 type:
+	//		'C' (columns): uint32 count, then count names as (uint16 length, chars)
+	//			New columns are appended to the schema, existing columns never move
+	//		'R' (row): uint32 numColumns, then numColumns doubles (NAN where the report didn't have that metric)
+	//			A row only contains the columns that existed when it was written
+	//
+	// Appending to an existing file continues its schema, so resumed runs keep writing to the same file
+	// See python_scripts/metric_file_reader.py to load it
+	struct RG_IMEXPORT MetricFileWriter {
+		static constexpr char MAGIC[8] = { 'G', 'G', 'L', 'M', 'E', 'T', 'R', 'C' };
+		static constexpr uint32_t VERSION = 1;
+
+		std::filesystem::path path;
+		std::ofstream fileOut;
+
+		std::vector<std::string> columns;
+		std::unordered_map<std::string, uint32_t> columnIndices;
+
+		MetricFileWriter(std::filesystem::path path);
+
+		RG_NO_COPY(MetricFileWriter);
+
+		void Write(const Report& report);
+
+	private:
+		// Reads the schema of an existing file, returns the size of its valid portion
+		// Anything after that (e.g. a row cut off by a crash) is discarded
+		uint64_t ReadExisting();
+	};
+}
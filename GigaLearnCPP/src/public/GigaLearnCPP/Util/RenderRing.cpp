@@ -0,0 +1,118 @@
+#include "RenderRing.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+using namespace RLGC;
+
+GGL::RenderRing::RenderRing(std::string name, int numSlots) : name(name), numSlots(numSlots) {
+	RG_LOG("Initializing RenderRing...");
+
+	if (numSlots < 2)
+		RG_ERR_CLOSE("RenderRing: Need at least 2 slots, got " << numSlots);
+
+#ifdef _WIN32
+	RG_ERR_CLOSE("RenderRing: Shared memory rendering is only supported on POSIX platforms");
+#else
+	std::string shmName = "/" + name;
+	fd = shm_open(shmName.c_str(), O_CREAT | O_RDWR, 0600);
+	if (fd < 0)
+		RG_ERR_CLOSE("RenderRing: Failed to open shared memory \"" << shmName << "\": " << strerror(errno));
+
+	mappingSize = sizeof(Header) + sizeof(Slot) * numSlots;
+	if (ftruncate(fd, mappingSize) != 0)
+		RG_ERR_CLOSE("RenderRing: Failed to resize shared memory to " << mappingSize << " bytes: " << strerror(errno));
+
+	mapping = mmap(NULL, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (mapping == MAP_FAILED)
+		RG_ERR_CLOSE("RenderRing: Failed to map shared memory: " << strerror(errno));
+
+	// Start from a clean ring, a viewer attached to a previous run sees the magic disappear and re-attaches
+	memset(mapping, 0, mappingSize);
+	header = (Header*)mapping;
+	slots = (Slot*)((uint8_t*)mapping + sizeof(Header));
+
+	header->version = VERSION;
+	header->numSlots = numSlots;
+	header->slotSize = sizeof(Slot);
+	header->maxPlayers = MAX_PLAYERS;
+	std::atomic_thread_fence(std::memory_order_release);
+	memcpy(header->magic, MAGIC, sizeof(MAGIC));
+
+	RG_LOG(" > Writing frames to shared memory \"" << shmName << "\" (" << numSlots << " slots, " << (mappingSize / 1024) << "KB)");
+#endif
+}
+
+GGL::RenderRing::~RenderRing() {
+#ifndef _WIN32
+	if (mapping && mapping != MAP_FAILED)
+		munmap(mapping, mappingSize);
+	if (fd >= 0) {
+		close(fd);
+		shm_unlink(("/" + name).c_str());
+	}
+#endif
+}
+
+static_assert(CommonValues::BOOST_LOCATIONS_AMOUNT <= GGL::RenderRing::MAX_BOOST_PADS);
+
+static void WritePhys(GGL::RenderRing::PhysFrame& out, const PhysState& phys) {
+	const Vec* vecs[] = { &phys.pos, &phys.rotMat.forward, &phys.rotMat.right, &phys.rotMat.up, &phys.vel, &phys.angVel };
+	float* outVecs[] = { out.pos, out.forward, out.right, out.up, out.vel, out.angVel };
+	for (int i = 0; i < 6; i++) {
+		outVecs[i][0] = vecs[i]->x;
+		outVecs[i][1] = vecs[i]->y;
+		outVecs[i][2] = vecs[i]->z;
+	}
+}
+
+void GGL::RenderRing::Write(const GameState& state) {
+	uint64_t frameIdx = framesWritten;
+
+	// Overwriting a frame the reader hasn't gotten to yet
+	if (frameIdx >= numSlots && header->readerAttached.load(std::memory_order_relaxed)) {
+		uint64_t readCount = header->readCount.load(std::memory_order_relaxed);
+		if (readCount <= frameIdx - numSlots)
+			header->droppedCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	Slot& slot = slots[frameIdx % numSlots];
+	slot.seq.store(frameIdx * 2 + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Frame& frame = slot.frame;
+	frame.frameIdx = frameIdx;
+	frame.deltaTime = state.deltaTime;
+	frame.gameMode = state.lastArena ? (uint8_t)state.lastArena->gameMode : (uint8_t)GameMode::SOCCAR;
+
+	WritePhys(frame.ball, state.ball);
+
+	frame.numBoostPads = state.boostPads.size();
+	for (int i = 0; i < state.boostPads.size(); i++)
+		frame.boostPads[i] = state.boostPads[i];
+
+	frame.numPlayers = RS_MIN(state.players.size(), MAX_PLAYERS);
+	for (int i = 0; i < frame.numPlayers; i++) {
+		const Player& player = state.players[i];
+		PlayerFrame& playerFrame = frame.players[i];
+		playerFrame.carId = player.carId;
+		playerFrame.team = (uint8_t)player.team;
+		playerFrame.isDemoed = player.isDemoed;
+		playerFrame.isOnGround = player.isOnGround;
+		playerFrame.ballTouchedStep = player.ballTouchedStep;
+		playerFrame.hasFlipOrJump = player.HasFlipOrJump();
+		playerFrame.boost = player.boost / 100;
+		WritePhys(playerFrame.phys, player);
+		for (int j = 0; j < Action::ELEM_AMOUNT; j++)
+			playerFrame.action[j] = player.prevAction[j];
+	}
+
+	slot.seq.store(frameIdx * 2 + 2, std::memory_order_release);
+	framesWritten++;
+	header->writeCount.store(framesWritten, std::memory_order_release);
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "../Framework.h"
+#include <RLGymCPP/Gamestates/GameState.h>
+#include <atomic>
+
+namespace GGL {
+	// Render transport that writes fixed-layout binary frames into a POSIX shared memory ring
+	// An external viewer process maps the ring and reads frames at its own pace (see python_scripts/render_ring_reader.py)
+	// Writing never blocks or waits on the reader, if the reader falls behind its oldest unread frames are overwritten
+	//
+	// Shared memory layout (native endianness, naturally aligned):
+	//	RenderRingHeader, then numSlots RenderRingSlots
+	//	Frame N (starting at 0) is written to slot (N % numSlots)
+	//	Each slot has a sequence number (seqlock): (2N + 1) while frame N is being written, (2N + 2) once it's complete
+	//	A reader wanting frame N checks the sequence number before and after copying the slot, and discards the copy if it isn't (2N + 2) both times
+	struct RenderRing {
+		static constexpr char MAGIC[8] = { 'G', 'G', 'L', 'R', 'E', 'N', 'D', 'R' };
+		static constexpr uint32_t VERSION = 1;
+		static constexpr int MAX_PLAYERS = 8;
+		static constexpr int MAX_BOOST_PADS = 36; // Only numBoostPads are used, padded for alignment
+
+		struct PhysFrame {
+			float pos[3], forward[3], right[3], up[3], vel[3], angVel[3];
+		};
+
+		struct PlayerFrame {
+			uint32_t carId;
+			uint8_t team, isDemoed, isOnGround, ballTouchedStep, hasFlipOrJump, _pad[3];
+			float boost; // From 0 to 1
+			PhysFrame phys;
+			float action[RLGC::Action::ELEM_AMOUNT]; // The action the player took this step
+		};
+
+		struct Frame {
+			uint64_t frameIdx;
+			float deltaTime;
+			uint8_t gameMode; // RocketSim::GameMode
+			uint8_t numPlayers;
+			uint8_t numBoostPads;
+			uint8_t _pad;
+			PhysFrame ball;
+			uint8_t boostPads[MAX_BOOST_PADS]; // 1 if active
+			PlayerFrame players[MAX_PLAYERS];
+			uint32_t _pad2;
+		};
+
+		struct Header {
+			char magic[8];
+			uint32_t version;
+			uint32_t numSlots;
+			uint32_t slotSize; // Bytes per slot
+			uint32_t maxPlayers;
+
+			std::atomic<uint64_t> writeCount; // Frames completely written, the newest frame is (writeCount - 1)
+			std::atomic<uint64_t> droppedCount; // Frames overwritten before an attached reader read them
+
+			// Written by the reader
+			std::atomic<uint64_t> readCount; // Next frame the reader wants, frames before this are done with
+			std::atomic<uint32_t> readerAttached; // Nonzero while a reader is attached, drops are only counted then
+			uint32_t _pad;
+		};
+
+		struct Slot {
+			std::atomic<uint64_t> seq;
+			Frame frame;
+		};
+
+		static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free);
+		// The reader relies on this exact layout
+		static_assert(sizeof(PhysFrame) == 72 && sizeof(PlayerFrame) == 120);
+		static_assert(sizeof(Frame) == 1088 && sizeof(Header) == 56 && sizeof(Slot) == 1096);
+
+		std::string name;
+		int numSlots;
+
+		int fd = -1;
+		void* mapping = NULL;
+		size_t mappingSize = 0;
+
+		Header* header = NULL;
+		Slot* slots = NULL;
+
+		uint64_t framesWritten = 0;
+
+		// Creates (or takes over) the shared memory object with this name, e.g. "gigalearn_render"
+		RenderRing(std::string name, int numSlots = 64);
+		~RenderRing();
+
+		RG_NO_COPY(RenderRing);
+
+		// Never blocks
+		// Players beyond MAX_PLAYERS are left out
+		void Write(const RLGC::GameState& state);
+
+		uint64_t GetDroppedCount() const {
+			return header->droppedCount.load(std::memory_order_relaxed);
+		}
+	};
+}
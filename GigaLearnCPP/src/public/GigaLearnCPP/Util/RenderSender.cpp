@@ -5,7 +5,7 @@
 using namespace nlohmann;
 using namespace RLGC;
 
-GGL::RenderSender::RenderSender(float timeScale) : timeScale(timeScale) {
+GGL::RenderSender::RenderSender(float timeScale) : pacer(timeScale) {
 	RG_LOG("Initializing RenderSender...");
 
 	try {
@@ -96,30 +96,7 @@ void GGL::RenderSender::Send(const GameState& state) {
 		RG_ERR_CLOSE("RenderSender: Failed to send gamestate, exception: " << e.what());
 	}
 
-	// Delay
-	{
-		namespace chr = std::chrono;
-
-		// Determine the desired delay and the actual delay (in seconds)
-		double targetDelay = state.deltaTime / timeScale;
-		double realDelay = renderTimer.Elapsed();
-		renderTimer.Reset();
-
-		constexpr double CORRECTION_SCALE = 0.3f; // Portion of the error we wil compensate for each step
-		double error = targetDelay - realDelay;
-
-		if (adaptiveRenderDelay == -1) {
-			// Just initialize render delay as target delay
-			adaptiveRenderDelay = targetDelay;
-		} else {
-			adaptiveRenderDelay += error * CORRECTION_SCALE;
-		}
-		adaptiveRenderDelay = RS_CLAMP(adaptiveRenderDelay, 0, targetDelay);
-
-		// Sleep for the new adaptive delay
-		int64_t sleepMics = (int64_t)(adaptiveRenderDelay * 1'000'000);
-		std::this_thread::sleep_for(chr::microseconds(sleepMics));
-	}
+	pacer.Wait(state.deltaTime);
 }
 
 GGL::RenderSender::~RenderSender() {}
\ No newline at end of file
@@ -9,9 +9,7 @@ namespace GGL {
 	struct RG_IMEXPORT RenderSender {
 		pybind11::module pyMod;
 
-		float timeScale;
-		double adaptiveRenderDelay = -1;
-		Timer renderTimer = {};
+		RenderPacer pacer;
 
 		RenderSender(float timeScale);
 
@@ -0,0 +1,135 @@
+#include "RolloutDatasetTest.h"
+
+#include <private/GigaLearnCPP/Util/RolloutDataset.h>
+#include <private/GigaLearnCPP/PPO/ExperienceBuffer.h>
+
+constexpr int TEST_OBS_SIZE = 24, TEST_NUM_ACTIONS = 90;
+constexpr float TEST_GAE_GAMMA = 0.99f, TEST_GAE_LAMBDA = 0.95f;
+
+// Episodes of random length, values that only change every few rows (so some columns compress), and random masks
+static GGL::RolloutData MakeTestRollout(int numRows) {
+	using namespace RLGC;
+	RNG rng = RNG(numRows);
+
+	GGL::RolloutData data = {};
+	data.states = torch::empty({ numRows, TEST_OBS_SIZE }, torch::kFloat32);
+	data.actionMasks = torch::empty({ numRows, TEST_NUM_ACTIONS }, torch::kUInt8);
+	data.actions = torch::empty({ numRows }, torch::kInt32);
+	data.logProbs = torch::empty({ numRows }, torch::kFloat32);
+	data.rewards = torch::empty({ numRows }, torch::kFloat32);
+	data.terminals = torch::empty({ numRows }, torch::kInt8);
+	data.values = torch::empty({ numRows }, torch::kFloat32);
+
+	float* states = data.states.data_ptr<float>();
+	uint8_t* masks = data.actionMasks.data_ptr<uint8_t>();
+	int32_t* actions = data.actions.data_ptr<int32_t>();
+	float* logProbs = data.logProbs.data_ptr<float>();
+	float* rewards = data.rewards.data_ptr<float>();
+	int8_t* terminals = data.terminals.data_ptr<int8_t>();
+	float* values = data.values.data_ptr<float>();
+
+	std::vector<float> truncValues = {};
+	int episodeRowsLeft = 0;
+	for (int i = 0; i < numRows; i++) {
+		for (int j = 0; j < TEST_OBS_SIZE; j++)
+			states[i * TEST_OBS_SIZE + j] = (j % 3 == 0 && i > 0) ? states[(i - 1) * TEST_OBS_SIZE + j] : rng.RandFloat(-1, 1);
+		for (int j = 0; j < TEST_NUM_ACTIONS; j++)
+			masks[i * TEST_NUM_ACTIONS + j] = rng.RandInt(0, 4) != 0;
+
+		actions[i] = rng.RandInt(0, TEST_NUM_ACTIONS);
+		logProbs[i] = -rng.RandFloat(0, 5);
+		rewards[i] = (rng.RandInt(0, 8) == 0) ? rng.RandFloat(-1, 1) : 0;
+		values[i] = rng.RandFloat(-2, 2);
+
+		if (episodeRowsLeft == 0)
+			episodeRowsLeft = rng.RandInt(1, 300);
+		episodeRowsLeft--;
+
+		// The last row always ends an episode, like the end of a collection
+		if (episodeRowsLeft == 0 || i == numRows - 1) {
+			episodeRowsLeft = 0;
+			if (rng.RandInt(0, 2) || i == numRows - 1) {
+				terminals[i] = TerminalType::TRUNCATED;
+				truncValues.push_back(rng.RandFloat(-2, 2));
+			} else {
+				terminals[i] = TerminalType::NORMAL;
+			}
+		} else {
+			terminals[i] = TerminalType::NOT_TERMINAL;
+		}
+	}
+
+	data.truncValues = torch::tensor(truncValues, torch::kFloat32);
+	return data;
+}
+
+static bool TestTensorsMatch(const torch::Tensor& a, const torch::Tensor& b) {
+	if (a.defined() != b.defined())
+		return false;
+	return !a.defined() || (a.dtype() == b.dtype() && a.sizes() == b.sizes() && torch::equal(a, b));
+}
+
+GGL::RolloutDatasetRoundTripResult GGL::RunRolloutDatasetRoundTripTest(std::filesystem::path folderPath, int numRows, int chunkRows) {
+	RG_ASSERT(numRows > 0 && chunkRows > 0);
+
+	RolloutDatasetRoundTripResult result = {};
+	auto startTime = std::chrono::steady_clock::now();
+
+	// Only our own files are removed, so a leftover rollout can't be read back instead
+	for (auto& path : RolloutDataset::ListFiles(folderPath))
+		std::filesystem::remove(path);
+
+	RolloutData added = MakeTestRollout(numRows);
+	RolloutData expected = MakeTestRollout(numRows);
+	result.numRows = expected.Length();
+	result.numTruncRows = expected.truncValues.numel();
+
+	{
+		RolloutDatasetWriter writer(folderPath, chunkRows);
+		writer.Add(0, added);
+
+		// Like the experience buffer after Add(), the caller's tensors get modified while the file is still being written
+		for (torch::Tensor* tensor : { &added.states, &added.actionMasks, &added.actions, &added.logProbs, &added.rewards, &added.terminals, &added.values, &added.truncValues })
+			tensor->zero_();
+
+		// Finishes writing on destruction
+	}
+
+	auto paths = RolloutDataset::ListFiles(folderPath);
+	if (paths.size() != 1)
+		RG_ERR_CLOSE("RunRolloutDatasetRoundTripTest(): Expected 1 rollout file in " << folderPath << ", found " << paths.size());
+	result.fileBytes = std::filesystem::file_size(paths[0]);
+
+	RolloutData read = RolloutDataset::ReadFile(paths[0]);
+	result.columnsMatch =
+		TestTensorsMatch(read.states, expected.states) && TestTensorsMatch(read.actionMasks, expected.actionMasks) &&
+		TestTensorsMatch(read.actions, expected.actions) && TestTensorsMatch(read.logProbs, expected.logProbs) &&
+		TestTensorsMatch(read.rewards, expected.rewards) && TestTensorsMatch(read.terminals, expected.terminals) &&
+		TestTensorsMatch(read.values, expected.values) && TestTensorsMatch(read.truncValues, expected.truncValues);
+
+	ExperienceBuffer readExperience = ExperienceBuffer(0, torch::kCPU);
+	ExperienceBuffer expectedExperience = ExperienceBuffer(0, torch::kCPU);
+	float readAdvMean = RolloutDataset::LoadIntoExperience(read, readExperience, TEST_GAE_GAMMA, TEST_GAE_LAMBDA);
+	float expectedAdvMean = RolloutDataset::LoadIntoExperience(expected, expectedExperience, TEST_GAE_GAMMA, TEST_GAE_LAMBDA);
+
+	result.experienceMatches = readAdvMean == expectedAdvMean && readExperience.data.states.size(0) == numRows;
+	const torch::Tensor* readItr = readExperience.data.begin();
+	for (const torch::Tensor& expectedTensor : expectedExperience.data)
+		result.experienceMatches &= TestTensorsMatch(*(readItr++), expectedTensor);
+
+	for (auto& path : paths)
+		std::filesystem::remove(path);
+
+	result.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	return result;
+}
+
+std::string GGL::RolloutDatasetRoundTripResult::ToString() const {
+	std::stringstream stream;
+	stream << "Rollout dataset round trip (" << numRows << " rows, " << numTruncRows << " truncated, " << time << "s):\n";
+	stream << "\tFile size: " << fileBytes << " bytes\n";
+	stream << "\tColumns read back: " << (columnsMatch ? "match" : "MISMATCHED") << "\n";
+	stream << "\tLoaded experience: " << (experienceMatches ? "matches" : "MISMATCHED") << "\n";
+	stream << "\t" << (Passed() ? "Passed" : "FAILED") << "\n";
+	return stream.str();
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "../Framework.h"
+
+namespace GGL {
+	struct RolloutDatasetRoundTripResult {
+		int64_t numRows = 0, numTruncRows = 0;
+		uint64_t fileBytes = 0;
+
+		// Every column read back is bit-exact with the rollout as it was when it was added,
+		//	even though the added tensors were modified in-place right after (like the experience buffer can be)
+		bool columnsMatch = false;
+
+		// LoadIntoExperience() on the read rollout gives the same experience as on the original one
+		bool experienceMatches = false;
+
+		double time = 0; // Seconds
+
+		bool Passed() const {
+			return columnsMatch && experienceMatches;
+		}
+
+		std::string ToString() const;
+	};
+
+	// Writes a made-up rollout with RolloutDatasetWriter into folderPath, reads it back with RolloutDataset::ReadFile(),
+	//	and loads both into an experience buffer with RolloutDataset::LoadIntoExperience() to check that they match
+	// Rows are split into episodes ending in normal and truncated terminals, so truncValues and GAE across episodes are covered
+	RG_IMEXPORT RolloutDatasetRoundTripResult RunRolloutDatasetRoundTripTest(std::filesystem::path folderPath, int numRows = 10000, int chunkRows = 4096);
+}
@@ -0,0 +1,184 @@
+#ifdef _WIN32
+// Before anything that could include windows.h
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#endif
+
+#include "TCPSocket.h"
+
+#ifdef _WIN32
+#pragma comment(lib, "Ws2_32.lib")
+#define RG_SOCKET_ERR_STR() ("WSA error " + std::to_string(WSAGetLastError()))
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <cstring>
+#define RG_SOCKET_ERR_STR() std::string(strerror(errno))
+#endif
+
+static void InitSockets() {
+#ifdef _WIN32
+	static bool initialized = [] {
+		WSADATA wsaData;
+		if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+			RG_ERR_CLOSE("TCPSocket: WSAStartup() failed");
+		return true;
+	}();
+#endif
+}
+
+static bool ResolveAddress(const std::string& address, int port, sockaddr_in& outAddr) {
+	outAddr = {};
+	outAddr.sin_family = AF_INET;
+	outAddr.sin_port = htons((uint16_t)port);
+
+	if (address.empty()) {
+		outAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+		return true;
+	}
+
+	if (inet_pton(AF_INET, address.c_str(), &outAddr.sin_addr) == 1)
+		return true;
+
+	// Not a numeric address, look up the host name
+	addrinfo hints = {};
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	addrinfo* result = NULL;
+	if (getaddrinfo(address.c_str(), NULL, &hints, &result) != 0 || !result)
+		return false;
+	outAddr.sin_addr = ((sockaddr_in*)result->ai_addr)->sin_addr;
+	freeaddrinfo(result);
+	return true;
+}
+
+GGL::TCPSocket& GGL::TCPSocket::operator=(TCPSocket&& other) noexcept {
+	if (this != &other) {
+		Close();
+		handle = other.handle;
+		other.handle = INVALID_HANDLE;
+	}
+	return *this;
+}
+
+GGL::TCPSocket GGL::TCPSocket::Listen(const std::string& address, int port, int backlog) {
+	InitSockets();
+
+	sockaddr_in addr;
+	if (!ResolveAddress(address, port, addr))
+		RG_ERR_CLOSE("TCPSocket: Failed to resolve address \"" << address << "\"");
+
+	TCPSocket result = TCPSocket((Handle)socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+	if (!result.IsValid())
+		RG_ERR_CLOSE("TCPSocket: Failed to create socket: " << RG_SOCKET_ERR_STR());
+
+	// So a restarted learner can listen again right away
+	int reuse = 1;
+	setsockopt(result.handle, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+	if (bind(result.handle, (sockaddr*)&addr, sizeof(addr)) != 0)
+		RG_ERR_CLOSE("TCPSocket: Failed to bind to " << address << ":" << port << ": " << RG_SOCKET_ERR_STR());
+
+	if (listen(result.handle, backlog) != 0)
+		RG_ERR_CLOSE("TCPSocket: Failed to listen on " << address << ":" << port << ": " << RG_SOCKET_ERR_STR());
+
+	return result;
+}
+
+GGL::TCPSocket GGL::TCPSocket::Connect(const std::string& address, int port) {
+	InitSockets();
+
+	sockaddr_in addr;
+	if (!ResolveAddress(address, port, addr))
+		return TCPSocket();
+
+	TCPSocket result = TCPSocket((Handle)socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+	if (!result.IsValid())
+		RG_ERR_CLOSE("TCPSocket: Failed to create socket: " << RG_SOCKET_ERR_STR());
+
+	if (connect(result.handle, (sockaddr*)&addr, sizeof(addr)) != 0)
+		return TCPSocket();
+
+	return result;
+}
+
+GGL::TCPSocket GGL::TCPSocket::Accept() {
+	Handle clientHandle = (Handle)accept(handle, NULL, NULL);
+	if (clientHandle == INVALID_HANDLE)
+		return TCPSocket();
+	return TCPSocket(clientHandle);
+}
+
+int GGL::TCPSocket::GetLocalPort() const {
+	sockaddr_in addr = {};
+	socklen_t addrLen = sizeof(addr);
+	if (getsockname(handle, (sockaddr*)&addr, &addrLen) != 0)
+		return -1;
+	return ntohs(addr.sin_port);
+}
+
+void GGL::TCPSocket::SetNoDelay(bool noDelay) {
+	int val = noDelay;
+	setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, (const char*)&val, sizeof(val));
+}
+
+bool GGL::TCPSocket::SendAll(const void* data, size_t size) {
+	const char* cur = (const char*)data;
+	while (size > 0) {
+		int toSend = (int)RS_MIN(size, (size_t)(1 << 30));
+#ifdef _WIN32
+		int sent = send(handle, cur, toSend, 0);
+#else
+		int sent = (int)send(handle, cur, toSend, MSG_NOSIGNAL);
+		if (sent < 0 && errno == EINTR)
+			continue;
+#endif
+		if (sent <= 0)
+			return false;
+		cur += sent;
+		size -= sent;
+	}
+	return true;
+}
+
+bool GGL::TCPSocket::RecvAll(void* data, size_t size) {
+	char* cur = (char*)data;
+	while (size > 0) {
+		int toRecv = (int)RS_MIN(size, (size_t)(1 << 30));
+		int received = (int)recv(handle, cur, toRecv, 0);
+#ifndef _WIN32
+		if (received < 0 && errno == EINTR)
+			continue;
+#endif
+		if (received <= 0)
+			return false;
+		cur += received;
+		size -= received;
+	}
+	return true;
+}
+
+void GGL::TCPSocket::Shutdown() {
+	if (!IsValid())
+		return;
+#ifdef _WIN32
+	shutdown(handle, SD_BOTH);
+#else
+	shutdown(handle, SHUT_RDWR);
+#endif
+}
+
+void GGL::TCPSocket::Close() {
+	if (!IsValid())
+		return;
+#ifdef _WIN32
+	closesocket(handle);
+#else
+	close(handle);
+#endif
+	handle = INVALID_HANDLE;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "../Framework.h"
+
+namespace GGL {
+	// Minimal blocking TCP socket, owns its handle
+	// Send/receive functions return false once the connection is closed or broken, instead of erroring
+	struct RG_IMEXPORT TCPSocket {
+#ifdef _WIN32
+		typedef uintptr_t Handle; // SOCKET
+#else
+		typedef int Handle;
+#endif
+		static constexpr Handle INVALID_HANDLE = (Handle)-1;
+
+		Handle handle = INVALID_HANDLE;
+
+		TCPSocket() = default;
+		explicit TCPSocket(Handle handle) : handle(handle) {}
+		~TCPSocket() { Close(); }
+
+		TCPSocket(TCPSocket&& other) noexcept : handle(other.handle) { other.handle = INVALID_HANDLE; }
+		TCPSocket& operator=(TCPSocket&& other) noexcept;
+
+		RG_NO_COPY(TCPSocket);
+
+		bool IsValid() const { return handle != INVALID_HANDLE; }
+
+		// Binds and listens on this address and port (port 0 picks a free port, see GetLocalPort())
+		static TCPSocket Listen(const std::string& address, int port, int backlog = 16);
+		static TCPSocket Connect(const std::string& address, int port);
+
+		// Blocks until a connection comes in, the returned socket is invalid if this socket was shut down
+		TCPSocket Accept();
+
+		int GetLocalPort() const;
+
+		// Disables Nagle's algorithm, so small messages (like credits) aren't held back
+		void SetNoDelay(bool noDelay);
+
+		bool SendAll(const void* data, size_t size);
+		bool RecvAll(void* data, size_t size);
+
+		template <typename T>
+		bool SendVal(const T& val) { return SendAll(&val, sizeof(T)); }
+		template <typename T>
+		bool RecvVal(T& val) { return RecvAll(&val, sizeof(T)); }
+
+		// Wakes up any thread blocked on this socket, without freeing the handle
+		void Shutdown();
+		void Close();
+	};
+}
@@ -20,4 +20,36 @@ namespace GGL {
 			startTime = std::chrono::high_resolution_clock::now();
 		}
 	};
+
+	// Sleeps between rendered steps so the game plays at timeScale times real time
+	// The delay adapts to however long the rest of the step took
+	struct RenderPacer {
+		float timeScale;
+		double adaptiveRenderDelay = -1;
+		Timer renderTimer = {};
+
+		RenderPacer(float timeScale) : timeScale(timeScale) {}
+
+		void Wait(float deltaTime) {
+			// Determine the desired delay and the actual delay (in seconds)
+			double targetDelay = deltaTime / timeScale;
+			double realDelay = renderTimer.Elapsed();
+			renderTimer.Reset();
+
+			constexpr double CORRECTION_SCALE = 0.3f; // Portion of the error we wil compensate for each step
+			double error = targetDelay - realDelay;
+
+			if (adaptiveRenderDelay == -1) {
+				// Just initialize render delay as target delay
+				adaptiveRenderDelay = targetDelay;
+			} else {
+				adaptiveRenderDelay += error * CORRECTION_SCALE;
+			}
+			adaptiveRenderDelay = RS_CLAMP(adaptiveRenderDelay, 0, targetDelay);
+
+			// Sleep for the new adaptive delay
+			int64_t sleepMics = (int64_t)(adaptiveRenderDelay * 1'000'000);
+			std::this_thread::sleep_for(std::chrono::microseconds(sleepMics));
+		}
+	};
 }
\ No newline at end of file
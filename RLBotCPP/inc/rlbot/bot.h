@@ -3,6 +3,7 @@
 #include "rlbot/packets.h"
 #include "rlbot/rlbot_generated.h"
 
+#include <memory>
 #include <string>
 
 namespace rlbot {
@@ -10,11 +11,26 @@ class Bot {
 private:
   int lastMessageIndex = -1;
 
+  // The fieldinfo once the framework has it, and the ball prediction of the
+  // current tick if wantsBallPrediction is set.
+  std::unique_ptr<FieldInfo> fieldInfo;
+  std::unique_ptr<BallPrediction> tickBallPrediction;
+
+  bool UpdateFieldInfo();
+  bool UpdateTickBallPrediction();
+  friend class BotProcess;
+
 public:
   int index;
   int team;
   std::string name;
 
+  // Set this if the bot uses the ball prediction every tick. It's then fetched
+  // once per tick before GetOutput(), which only gets called once the ball
+  // prediction is available. Otherwise it's only fetched when
+  // GetBallPrediction() is called.
+  bool wantsBallPrediction = false;
+
   Bot(int index, int team, std::string name);
   virtual ~Bot() {}
   virtual Controller GetOutput(GameTickPacket gametickpacket) = 0;
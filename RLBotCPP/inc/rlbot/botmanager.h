@@ -2,6 +2,7 @@
 
 #include "rlbot/bot.h"
 #include "rlbot/botprocess.h"
+#include "rlbot/packetpoller.h"
 #include "rlbot/platform.h"
 #include "rlbot/server.h"
 
@@ -18,6 +19,7 @@
 namespace rlbot {
 class BotManager {
 private:
+  PacketPoller poller;
   std::map<int, std::unique_ptr<BotProcess>> bots;
   std::mutex bots_mutex;
 
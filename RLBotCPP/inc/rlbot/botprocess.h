@@ -1,14 +1,17 @@
 #pragma once
 
 #include "rlbot/bot.h"
+#include "rlbot/packetpoller.h"
 
+#include <atomic>
 #include <thread>
 
 namespace rlbot {
 class BotProcess {
 private:
   Bot *bot;
-  bool running = false;
+  PacketPoller *poller;
+  std::atomic<bool> running = false;
   std::thread thread;
 
   void BotThread() const;
@@ -20,8 +23,12 @@ public:
   /**
    * Instantiates a bot process.
    * @param b the bot instance for this process.
+   * @param p the poller to get packets from, shared by all bot processes.
    */
-  BotProcess(Bot *b) { bot = b; }
+  BotProcess(Bot *b, PacketPoller *p) {
+    bot = b;
+    poller = p;
+  }
   ~BotProcess() { delete bot; }
 
   /**
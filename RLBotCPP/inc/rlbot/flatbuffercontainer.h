@@ -61,6 +61,8 @@ public:
   }
 
   const type *getRoot() const { return flatbuffer; }
+  const char *getData() const { return data; }
+  size_t getSize() const { return size; }
   const type *operator->() const { return flatbuffer; }
 };
 } // namespace rlbot
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "rlbot/packets.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace rlbot {
+/**
+ * Polls the interface for game tick packets on a single thread, and wakes
+ * every bot thread waiting in WaitForPacket() when a new one arrives.
+ * The interface has no way to notify us of new packets, so this is the only
+ * thread that polls it, and it sleeps until shortly before the next packet is
+ * due instead of polling every millisecond.
+ */
+class PacketPoller {
+private:
+  std::shared_ptr<const GameTickPacket> packet;
+  uint64_t packetindex = 0;
+
+  std::mutex mutex;
+  std::condition_variable packetcv;
+
+  std::mutex usersmutex;
+  int users = 0;
+  std::atomic<bool> running = false;
+  std::thread thread;
+
+  void PollThread();
+
+public:
+  PacketPoller() = default;
+  PacketPoller(PacketPoller const &) = delete;
+  PacketPoller &operator=(PacketPoller const &) = delete;
+  ~PacketPoller();
+
+  /**
+   * Registers a bot thread, the poll thread runs while there are any.
+   * The interface must be loaded before the first one is added.
+   */
+  void AddUser();
+  void RemoveUser();
+
+  /**
+   * Blocks until there is a packet newer than lastindex, or the timeout has
+   * passed.
+   * @param lastindex the index of the last packet received, updated to the
+   * returned packet's index.
+   * @return the new packet, or null on timeout.
+   */
+  std::shared_ptr<const GameTickPacket>
+  WaitForPacket(uint64_t &lastindex, std::chrono::milliseconds timeout);
+};
+} // namespace rlbot
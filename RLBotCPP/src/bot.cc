@@ -13,6 +13,9 @@ Bot::Bot(int _index, int _team, std::string _name) {
 }
 
 BallPrediction Bot::GetBallPrediction() {
+  if (tickBallPrediction)
+    return *tickBallPrediction;
+
   ByteBuffer buffer = Interface::GetBallPrediction();
   BallPrediction ballprediction(buffer);
   Interface::Free(buffer.ptr);
@@ -20,12 +23,37 @@ BallPrediction Bot::GetBallPrediction() {
 }
 
 FieldInfo Bot::GetFieldInfo() {
+  if (fieldInfo)
+    return *fieldInfo;
+
   ByteBuffer buffer = Interface::UpdateFieldInfoFlatbuffer();
   FieldInfo fieldinfo(buffer);
   Interface::Free(buffer.ptr);
   return fieldinfo;
 }
 
+bool Bot::UpdateFieldInfo() {
+  if (fieldInfo)
+    return true;
+
+  ByteBuffer buffer = Interface::UpdateFieldInfoFlatbuffer();
+  if (buffer.size > 4)
+    fieldInfo = std::make_unique<FieldInfo>(buffer);
+  Interface::Free(buffer.ptr);
+  return fieldInfo != nullptr;
+}
+
+bool Bot::UpdateTickBallPrediction() {
+  ByteBuffer buffer = Interface::GetBallPrediction();
+  if (buffer.size > 4) {
+    tickBallPrediction = std::make_unique<BallPrediction>(buffer);
+  } else {
+    tickBallPrediction = nullptr;
+  }
+  Interface::Free(buffer.ptr);
+  return tickBallPrediction != nullptr;
+}
+
 MatchInfo Bot::GetMatchInfo() {
   ByteBuffer buffer = Interface::GetMatchSettings();
   MatchInfo matchinfo(buffer);
@@ -39,7 +39,7 @@ void BotManager::AddBot(int index, int team, std::string name) {
 
   if (bots.find(index) == bots.end()) {
     bots.insert(std::make_pair(
-        index, std::make_unique<BotProcess>(botfactory(index, team, name))));
+        index, std::make_unique<BotProcess>(botfactory(index, team, name), &poller)));
 
     bots[index]->Start();
 
@@ -6,54 +6,47 @@
 namespace rlbot {
 void BotProcess::Start() {
   running = true;
+  poller->AddUser();
   thread = std::thread(&BotProcess::BotThread, this);
 }
 
 void BotProcess::Stop() {
   running = false;
   thread.join();
+  poller->RemoveUser();
 }
 
 void BotProcess::BotThread() const {
-  float lasttime = 0;
+  using namespace std::chrono_literals;
 
   // Don't start before the interface is ready.
-  while (!Interface::IsInitialized()) {
+  while (running && !Interface::IsInitialized()) {
     platform::SleepMilliseconds(1);
   }
 
+  uint64_t packetindex = 0;
+
   while (running) {
-    ByteBuffer flatbufferData = Interface::UpdateLiveDataPacketFlatbuffer();
-
-    // Don't try to read the packets when they are very small.
-    if (flatbufferData.size > 4) {
-		GameTickPacket gametickpacket = GameTickPacket(flatbufferData);
-
-      // Only run the bot when we recieve a new packet.
-      if (lasttime != gametickpacket->gameInfo()->secondsElapsed()) {
-        ByteBuffer fieldInfoData = Interface::UpdateFieldInfoFlatbuffer();
-        ByteBuffer ballPredictionData = Interface::GetBallPrediction();
-
-        // The fieldinfo or ball prediction might not have been set up by the
-        // framework yet.
-        if (fieldInfoData.size > 4 && ballPredictionData.size > 4) {
-          int status = Interface::SetBotInput(
-              bot->GetOutput(gametickpacket),
-              bot->index); /// TODO: Report status to user.
-
-          Interface::Free(fieldInfoData.ptr);
-          Interface::Free(ballPredictionData.ptr);
-        }
-
-        lasttime = gametickpacket->gameInfo()->secondsElapsed();
-      } else {
-        platform::SleepMilliseconds(1);
-      }
-    } else {
-      platform::SleepMilliseconds(100);
-    }
-
-	Interface::Free(flatbufferData.ptr);
+    // Wakes up when the poller has a new packet, or to check if we were
+    // stopped.
+    std::shared_ptr<const GameTickPacket> gametickpacket =
+        poller->WaitForPacket(packetindex, 100ms);
+    if (!gametickpacket)
+      continue;
+
+    // The fieldinfo or ball prediction might not have been set up by the
+    // framework yet. The fieldinfo doesn't change during a match, so the bot
+    // keeps it once it's there, and the ball prediction is only fetched for
+    // bots that want it.
+    if (!bot->UpdateFieldInfo())
+      continue;
+
+    if (bot->wantsBallPrediction && !bot->UpdateTickBallPrediction())
+      continue;
+
+    int status = Interface::SetBotInput(
+        bot->GetOutput(*gametickpacket),
+        bot->index); /// TODO: Report status to user.
   }
 }
 } // namespace rlbot
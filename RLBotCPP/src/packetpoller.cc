@@ -0,0 +1,86 @@
+#include "rlbot/packetpoller.h"
+
+#include "rlbot/interface.h"
+#include "rlbot/platform.h"
+
+namespace rlbot {
+// Packets come at 120Hz, we start polling for the next one a bit before that.
+constexpr std::chrono::microseconds kPacketInterval(1000000 / 120);
+constexpr std::chrono::microseconds kWakeEarly(1500);
+constexpr std::chrono::microseconds kPollInterval(250);
+
+PacketPoller::~PacketPoller() {
+  running = false;
+  if (thread.joinable())
+    thread.join();
+}
+
+void PacketPoller::AddUser() {
+  std::lock_guard<std::mutex> lock(usersmutex);
+  if (users++ == 0) {
+    running = true;
+    thread = std::thread(&PacketPoller::PollThread, this);
+  }
+}
+
+void PacketPoller::RemoveUser() {
+  std::lock_guard<std::mutex> lock(usersmutex);
+  if (--users == 0) {
+    running = false;
+    thread.join();
+  }
+}
+
+std::shared_ptr<const GameTickPacket>
+PacketPoller::WaitForPacket(uint64_t &lastindex,
+                            std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (!packetcv.wait_for(lock, timeout,
+                         [&] { return packetindex != lastindex; }))
+    return nullptr;
+
+  lastindex = packetindex;
+  return packet;
+}
+
+void PacketPoller::PollThread() {
+  // Don't start before the interface is ready.
+  while (running && !Interface::IsInitialized()) {
+    platform::SleepMilliseconds(1);
+  }
+
+  float lasttime = 0;
+
+  while (running) {
+    ByteBuffer flatbufferData = Interface::UpdateLiveDataPacketFlatbuffer();
+
+    // Don't try to read the packets when they are very small.
+    if (flatbufferData.size <= 4) {
+      Interface::Free(flatbufferData.ptr);
+      platform::SleepMilliseconds(100);
+      continue;
+    }
+
+    auto receivetime = std::chrono::steady_clock::now();
+    auto newpacket = std::make_shared<const GameTickPacket>(flatbufferData);
+    Interface::Free(flatbufferData.ptr);
+
+    // Only wake the bots when we recieve a new packet.
+    float time = (*newpacket)->gameInfo()->secondsElapsed();
+    if (time != lasttime) {
+      lasttime = time;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        packet = std::move(newpacket);
+        packetindex++;
+      }
+      packetcv.notify_all();
+
+      std::this_thread::sleep_until(receivetime + kPacketInterval -
+                                    kWakeEarly);
+    } else {
+      std::this_thread::sleep_for(kPollInterval);
+    }
+  }
+}
+} // namespace rlbot
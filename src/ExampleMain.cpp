@@ -3,6 +3,9 @@
 
 
 #include <GigaLearnCPP/Learner.h>
+#include <GigaLearnCPP/Collector.h>
+#include <GigaLearnCPP/Util/CollectorLoopbackTest.h>
+#include <GigaLearnCPP/Util/RolloutDatasetTest.h>
 
 
 #include <RLGymCPP/Rewards/KickoffProximityReward2v2Enhanced.h>
@@ -25,6 +28,9 @@
 
 #include <RLGymCPP/ActionParsers/DefaultAction.h>
 
+#include <RLGymCPP/EnvSet/EnvSetBenchmark.h>
+#include <RLGymCPP/EnvSet/RolloutRecorder.h>
+
 
 
 #include <iostream>
@@ -254,9 +260,11 @@ void StepCallback(Learner* learner, const std::vector<GameState>& states, Report
 
 
 
-				report.AddAvg("Player/Speed", player.vel.Length());
+				const PlayerFeatures& features = state.GetFeatures().players[player.index];
+
+				report.AddAvg("Player/Speed", features.speed);
 
-				Vec dirToBall = (state.ball.pos - player.pos).Normalized();
+				const Vec& dirToBall = features.dirToBall;
 
 				report.AddAvg("Player/Speed Towards Ball", RS_MAX(0, player.vel.Dot(dirToBall)));
 
@@ -303,6 +311,35 @@ int main(int argc, char* argv[]) try {
 
 	float scaleFactor = -1.0f; // if left negative, we'll auto-decide
 
+	// --bench=<path> benchmarks env stepping (with hardware counters on Linux) and writes the results as JSON
+	std::string benchOutputPath = {};
+
+	// --bench-features times the obs builder and rewards with and without the GameState feature cache
+	bool benchFeatures = false;
+
+	// --bench-framestack times FrameStackObs around the obs builder against a naive frame stack
+	bool benchFrameStack = false;
+
+	// --bench-clones times arena creation, Clone(), and ArenaClonePool, and checks that pooled clones simulate like fresh ones
+	bool benchClones = false;
+
+	// --bench-narrowphase compares the custom arena narrowphases against Bullet's, contact by contact, and times both
+	bool benchNarrowphase = false;
+
+	// --replay=<path> re-steps a rollout recorded with LearnerConfig::rolloutRecordNumIterations, without a policy, and checks it reproduced the obs and rewards
+	std::string replayPath = {};
+
+	// --collector-port=<port> makes the learner accept trajectories from collector processes on 127.0.0.1:<port>
+	// --collector=<address>:<port> runs this process as a collector for that learner instead of training
+	int collectorPort = 0;
+	std::string collectorTarget = {};
+
+	// --test-collectors runs several collectors against a learner-side server over 127.0.0.1, and checks what arrives
+	bool testCollectors = false;
+
+	// --test-rollout-dataset writes a rollout with RolloutDatasetWriter, reads it back, and checks it loads into the same experience
+	bool testRolloutDataset = false;
+
 	for (int i = 1; i < argc; ++i) {
 
 		std::string arg = argv[i];
@@ -327,10 +364,49 @@ int main(int argc, char* argv[]) try {
 
 		}
 
+		if (arg == "--bench") {
+			benchOutputPath = "env_benchmark.json";
+		} else if (arg.rfind("--bench=", 0) == 0) {
+			benchOutputPath = arg.substr(8);
+		} else if (arg == "--bench-features") {
+			benchFeatures = true;
+		} else if (arg == "--bench-framestack") {
+			benchFrameStack = true;
+		} else if (arg == "--bench-clones") {
+			benchClones = true;
+		} else if (arg == "--bench-narrowphase") {
+			benchNarrowphase = true;
+		}
+
+		if (arg.rfind("--replay=", 0) == 0)
+			replayPath = arg.substr(9);
+
+		if (arg.rfind("--collector-port=", 0) == 0) {
+			try { collectorPort = std::stoi(arg.substr(17)); } catch(...) {}
+		} else if (arg.rfind("--collector=", 0) == 0) {
+			collectorTarget = arg.substr(12);
+		} else if (arg == "--test-collectors") {
+			testCollectors = true;
+		} else if (arg == "--test-rollout-dataset") {
+			testRolloutDataset = true;
+		}
+
 	}
 
 
 
+	if (testCollectors) {
+		CollectorLoopbackTestResult testResult = RunCollectorLoopbackTest();
+		std::cout << testResult.ToString();
+		return testResult.Passed() ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (testRolloutDataset) {
+		RolloutDatasetRoundTripResult testResult = RunRolloutDatasetRoundTripTest(std::filesystem::temp_directory_path() / "gigalearn_rollout_dataset_test");
+		std::cout << testResult.ToString();
+		return testResult.Passed() ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
 	if (renderMode)
 
 		std::cout << "GigaLearn: démarrage en mode rendu (--render)\n";
@@ -347,6 +423,63 @@ int main(int argc, char* argv[]) try {
 
 	RocketSim::Init("C:\\Giga\\GigaLearnCPP-Leak\\collision_meshes");
 
+	if (!benchOutputPath.empty() || benchFeatures || benchFrameStack || benchClones || benchNarrowphase) {
+		EnvSetConfig benchEnvConfig = {};
+		benchEnvConfig.envCreateFn = EnvCreateFunc;
+		benchEnvConfig.numArenas = 32;
+		benchEnvConfig.tickSkip = 8;
+		benchEnvConfig.actionDelay = 7;
+		benchEnvConfig.saveRewards = false;
+		benchEnvConfig.randomSeed = 123;
+		EnvSet benchEnvSet(benchEnvConfig);
+
+		if (benchFeatures) {
+			std::cout << RunFeatureCacheBenchmark(&benchEnvSet).ToString();
+			return EXIT_SUCCESS;
+		}
+
+		if (benchFrameStack) {
+			std::cout << RunFrameStackBenchmark(&benchEnvSet, [] { return new AdvancedObs(); }).ToString();
+			return EXIT_SUCCESS;
+		}
+
+		if (benchClones) {
+			std::cout << RunArenaCloneBenchmark(&benchEnvSet).ToString();
+			return EXIT_SUCCESS;
+		}
+
+		if (benchNarrowphase) {
+			NarrowphaseBenchmarkResult narrowphaseResult = RunNarrowphaseBenchmark(&benchEnvSet);
+			std::cout << narrowphaseResult.ToString();
+			return narrowphaseResult.Passed() ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+
+		EnvSetBenchmarkResult benchResult = RunEnvSetBenchmark(&benchEnvSet);
+		std::cout << benchResult.ToJSON();
+		benchResult.WriteJSON(benchOutputPath);
+		std::cout << "Wrote benchmark results to " << benchOutputPath << std::endl;
+		return EXIT_SUCCESS;
+	}
+
+	if (!replayPath.empty()) {
+		EnvSetConfig replayEnvConfig = MakeRolloutEnvSetConfig(replayPath, EnvCreateFunc);
+		EnvSet replayEnvSet(replayEnvConfig);
+
+		RolloutReplayResult replayResult = ReplayRollout(&replayEnvSet, replayPath);
+		std::cout << "Replayed " << replayResult.numSteps << " steps in " << replayResult.stepTime << "s (" << replayResult.StepsPerSecond() << " steps/s)";
+		if (replayResult.numPrefixSteps > 0)
+			std::cout << ", after re-stepping " << replayResult.numPrefixSteps << " steps before the window";
+		std::cout << std::endl;
+		if (replayResult.firstMismatchStep == -1) {
+			std::cout << "Obs and rewards matched the recording" << std::endl;
+		} else {
+			std::cout << 
+				"Mismatched the recording starting at step " << replayResult.firstMismatchStep << 
+				" (obs: " << replayResult.numObsMismatches << " steps, rewards: " << replayResult.numResultMismatches << " steps)" << std::endl;
+		}
+		return EXIT_SUCCESS;
+	}
+
 
 
 	// Make configuration for the learner
@@ -585,6 +718,24 @@ int main(int argc, char* argv[]) try {
 
 	cfg.renderMode = renderMode; // <-- Use the flag parsed from the command line
 
+	cfg.collectorPort = collectorPort;
+
+	if (!collectorTarget.empty()) {
+		size_t colonPos = collectorTarget.rfind(':');
+		if (colonPos == std::string::npos) {
+			std::cerr << "--collector needs an address and port, e.g. --collector=127.0.0.1:7777" << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		// Each collector picks its own random seed, so they don't collect the same trajectories
+		cfg.randomSeed = -1;
+		cfg.numGames = 128;
+
+		Collector collector(EnvCreateFunc, cfg, collectorTarget.substr(0, colonPos), std::stoi(collectorTarget.substr(colonPos + 1)));
+		collector.Run();
+		return EXIT_SUCCESS;
+	}
+
 
 
 	// Make the learner with the environment creation function and the config we just made
@@ -9,6 +9,7 @@ using namespace GGL;
 // Global variable so that we can pass params to the bot factory
 // TODO: This is a lame solution
 RLBotParams g_RLBotParams = {};
+InferBroker* g_InferBroker = NULL;
 
 rlbot::Bot* BotFactory(int index, int team, std::string name) {
 	return new RLBotBot(index, team, name, g_RLBotParams);
@@ -18,107 +19,134 @@ RLBotBot::RLBotBot(int _index, int _team, std::string _name, const RLBotParams&
 	: rlbot::Bot(_index, _team, _name), params(params) {
 
 	RG_LOG("Created RLBot bot: index " << _index << ", name: " << name << "...");
+	brokerClientID = g_InferBroker->AddClient();
+	lastLatencyLogTime = std::chrono::steady_clock::now();
+
+	if (!params.packetRecordPath.empty()) {
+		std::string recordPath = params.packetRecordPath + "." + std::to_string(_index);
+		packetRecordFile.open(recordPath, std::ios::binary);
+		if (!packetRecordFile.good())
+			RG_ERR_CLOSE("RLBotBot: Failed to open packet record file \"" << recordPath << "\"");
+		RG_LOG(" > Recording packets to \"" << recordPath << "\"");
+	}
 }
 
 RLBotBot::~RLBotBot() {
-	delete g_RLBotParams.inferUnit;
+	// The InferUnit is shared by every bot, so it isn't ours to delete
+	g_InferBroker->RemoveClient(brokerClientID);
 }
 
-Vec ToVec(const rlbot::flat::Vector3* rlbotVec) {
-	return Vec(rlbotVec->x(), rlbotVec->y(), rlbotVec->z());
+static float SecondsSince(std::chrono::steady_clock::time_point time) {
+	return std::chrono::duration<float>(std::chrono::steady_clock::now() - time).count();
 }
 
-PhysState ToPhysObj(const rlbot::flat::Physics* phys) {
-	PhysState obj = {};
-	obj.pos = ToVec(phys->location());
-
-	Angle ang = Angle(phys->rotation()->yaw(), phys->rotation()->pitch(), phys->rotation()->roll());
-	obj.rotMat = ang.ToRotMat();
-
-	obj.vel = ToVec(phys->velocity());
-	obj.angVel = ToVec(phys->angularVelocity());
+void RLBotLatencyHistogram::Add(float seconds) {
+	int bucket = 0;
+	float bucketMax = FIRST_BUCKET_MAX;
+	while (bucket < NUM_BUCKETS - 1 && seconds >= bucketMax) {
+		bucket++;
+		bucketMax *= 2;
+	}
 
-	return obj;
+	counts[bucket]++;
+	total++;
+	sum += seconds;
+	max = RS_MAX(max, seconds);
 }
 
-Player ToPlayer(const rlbot::flat::PlayerInfo* playerInfo) {
-	Player pd = {};
-	
-	static_cast<PhysState&>(pd) = ToPhysObj(playerInfo->physics());
-
-	pd.carId = playerInfo->spawnId();
-
-	pd.team = (Team)playerInfo->team();
-
-	pd.boost = playerInfo->boost();
-	pd.isOnGround = playerInfo->hasWheelContact();
-	pd.hasJumped = playerInfo->jumped();
-	pd.hasDoubleJumped = playerInfo->doubleJumped();
-	pd.isDemoed = playerInfo->isDemolished();
-
-	return pd;
+float RLBotLatencyHistogram::GetPercentile(float frac) const {
+	uint64_t target = (uint64_t)ceil(total * frac);
+	uint64_t cumulative = 0;
+	float bucketMax = FIRST_BUCKET_MAX;
+	for (int i = 0; i < NUM_BUCKETS - 1; i++) {
+		cumulative += counts[i];
+		if (cumulative >= target)
+			return RS_MIN(bucketMax, max);
+		bucketMax *= 2;
+	}
+	return max;
 }
 
-GameState ToGameState(rlbot::GameTickPacket& gameTickPacket) {
-	GameState gs = {};
-
-	auto players = gameTickPacket->players();
-	for (int i = 0; i < players->size(); i++)
-		gs.players.push_back(ToPlayer(players->Get(i)));
-
-	static_cast<PhysState&>(gs.ball) = ToPhysObj(gameTickPacket->ball()->physics());
-
-	auto boostPadStates = gameTickPacket->boostPadStates();
-	if (boostPadStates->size() != CommonValues::BOOST_LOCATIONS_AMOUNT) {
-		if (rand() % 20 == 0) { // Don't spam-log as that will lag the bot
-			RG_LOG(
-				"RLBotClient ToGameState(): Bad boost pad amount, expected " << CommonValues::BOOST_LOCATIONS_AMOUNT << " but got " << boostPadStates->size()
-			);
+std::string RLBotLatencyHistogram::ToString() const {
+	std::stringstream stream;
+	stream << std::fixed << std::setprecision(2);
+	stream << "mean: " << (GetMean() * 1000) << "ms, p50: <" << (GetPercentile(0.5f) * 1000) << "ms, p99: <" << (GetPercentile(0.99f) * 1000) << "ms, max: " << (max * 1000) << "ms [";
+
+	float bucketMax = FIRST_BUCKET_MAX;
+	for (int i = 0; i < NUM_BUCKETS; i++) {
+		if (i > 0)
+			stream << ", ";
+		if (i < NUM_BUCKETS - 1) {
+			stream << "<" << (bucketMax * 1000) << "ms: " << counts[i];
+		} else {
+			stream << ">=" << (bucketMax * 1000 / 2) << "ms: " << counts[i];
 		}
+		bucketMax *= 2;
+	}
+	stream << "]";
+	return stream.str();
+}
 
-		// Just set all boost pads to on
-		std::fill(gs.boostPads.begin(), gs.boostPads.end(), 1);
-	} else {
-		for (int i = 0; i < CommonValues::BOOST_LOCATIONS_AMOUNT; i++) {
-			gs.boostPads[i] = boostPadStates->Get(i)->isActive();
-			gs.boostPadsInv[CommonValues::BOOST_LOCATIONS_AMOUNT - i - 1] = gs.boostPads[i];
+void RLBotBot::_UpdateAction() {
+	bool due = ticks >= params.actionDelay;
 
-			gs.boostPadTimers[i] = boostPadStates->Get(i)->timer();
-			gs.boostPadTimersInv[CommonValues::BOOST_LOCATIONS_AMOUNT - i - 1] = gs.boostPadTimers[i];
+	if (pendingRequest) {
+		// Only wait on the action the first time it's due
+		float timeout = (due && !missedDeadline) ? params.inferDeadline : 0;
+		if (g_InferBroker->WaitResult(brokerClientID, pendingRequest, action, timeout)) {
+			inferLatency.Add(SecondsSince(requestTime));
+			pendingRequest = 0;
+			actionReady = true;
 		}
 	}
 
-	return gs;
+	if (!due)
+		return;
+
+	if (actionReady) {
+		// Apply new action
+		controls = action;
+		actionReady = false;
+	} else if (pendingRequest && !missedDeadline) {
+		missedDeadline = true;
+		numMissedDeadlines++;
+	}
 }
 
 rlbot::Controller RLBotBot::GetOutput(rlbot::GameTickPacket gameTickPacket) {
+	auto tickStartTime = std::chrono::steady_clock::now();
+
+	if (packetRecordFile.is_open())
+		RLBotStateConverter::WritePacket(packetRecordFile, gameTickPacket.getData(), gameTickPacket.getSize());
 
 	float curTime = gameTickPacket->gameInfo()->secondsElapsed();
 	float deltaTime = curTime - prevTime;
 	prevTime = curTime;
 
-	int ticksElapsed = roundf(deltaTime * 120);
-	ticks += ticksElapsed;
-
-	GameState gs = ToGameState(gameTickPacket);
-	auto& localPlayer = gs.players[index];
-	localPlayer.prevAction = controls;
+	if (ticks != -1) {
+		int ticksElapsed = roundf(deltaTime * 120);
+		ticks += ticksElapsed;
 
-	if (updateAction) {
-		updateAction = false;
-		action = params.inferUnit->InferAction(localPlayer, gs, true);
-	}
-
-	if (ticks >= (params.actionDelay - 1) || ticks == -1) {
-		// Apply new action
-		controls = action;
+		// The current step's action may have finished or become due
+		_UpdateAction();
 	}
 
 	if (ticks >= params.tickSkip || ticks == -1) {
-		
-		// Trigger action update next tick
+		// Start the next step, request its action from this obs
 		ticks = 0;
-		updateAction = true;
+
+		// The prevs point into the converter's other buffer, which the broker copies, so they stay valid during inference
+		GameState& gs = stateConverter.Update(gameTickPacket.getRoot(), index, controls);
+
+		// This replaces the previous step's request if it still hasn't run
+		Player localPlayer = gs.players[index];
+		pendingRequest = g_InferBroker->Submit(brokerClientID, localPlayer, gs);
+		requestTime = tickStartTime;
+		actionReady = false;
+		missedDeadline = false;
+
+		// With no action delay, the action is due right away
+		_UpdateAction();
 	}
 
 	auto rc = rlbot::Controller();
@@ -135,11 +163,25 @@ rlbot::Controller RLBotBot::GetOutput(rlbot::GameTickPacket gameTickPacket) {
 		rc.handbrake = controls.handbrake;
 	}
 
+	tickLatency.Add(SecondsSince(tickStartTime));
+	if (params.latencyLogInterval > 0 && SecondsSince(lastLatencyLogTime) >= params.latencyLogInterval) {
+		RG_LOG(
+			"RLBot bot " << index << " (" << name << "):\n" <<
+			"\tInference latency: " << inferLatency.ToString() << "\n" <<
+			"\tTick latency: " << tickLatency.ToString() << "\n" <<
+			"\tMissed deadlines: " << numMissedDeadlines << ", avg inference batch size: " << g_InferBroker->GetAvgBatchSize()
+		);
+		inferLatency.Reset();
+		tickLatency.Reset();
+		lastLatencyLogTime = std::chrono::steady_clock::now();
+	}
+
 	return rc;
 }
 
 void RLBotClient::Run(const RLBotParams& params) {
 	g_RLBotParams = params;
+	g_InferBroker = new InferBroker(params.inferUnit, params.inferBatchWindow, true);
 
 	rlbot::platform::SetWorkingDirectory(
 		rlbot::platform::GetExecutableDirectory()
@@ -147,4 +189,54 @@ void RLBotClient::Run(const RLBotParams& params) {
 
 	rlbot::BotManager botManager(BotFactory);
 	botManager.StartBotServer(params.port);
-}
\ No newline at end of file
+
+	delete g_InferBroker;
+	g_InferBroker = NULL;
+}
+
+void RLBotClient::BenchmarkStateConversion(const std::string& packetsPath) {
+	RG_LOG("RLBotClient::BenchmarkStateConversion():");
+
+	auto packets = RLBotStateConverter::ReadPackets(packetsPath);
+	if (packets.empty())
+		RG_ERR_CLOSE("RLBotClient::BenchmarkStateConversion(): No packets in \"" << packetsPath << "\"");
+	RG_LOG("\tLoaded " << packets.size() << " packets from \"" << packetsPath << "\"");
+
+	std::vector<const rlbot::flat::GameTickPacket*> roots = {};
+	for (auto& packet : packets)
+		roots.push_back(flatbuffers::GetRoot<rlbot::flat::GameTickPacket>(packet.data()));
+
+	// Replay the packets enough times to get a stable measurement
+	constexpr uint64_t MIN_TICKS = 1'000'000;
+	int numPasses = (int)((MIN_TICKS + roots.size() - 1) / roots.size());
+	uint64_t numTicks = (uint64_t)numPasses * roots.size();
+
+	auto fnMeasureNSPerTick = [&](auto&& fnConvert) {
+		auto startTime = std::chrono::steady_clock::now();
+		for (int pass = 0; pass < numPasses; pass++)
+			for (auto root : roots)
+				fnConvert(root);
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count() / numTicks;
+	};
+
+	// Persistent converter, updated in place every tick
+	RLBotStateConverter converter = {};
+	uint64_t checksum = 0;
+	double persistentNS = fnMeasureNSPerTick(
+		[&](const rlbot::flat::GameTickPacket* root) {
+			checksum += converter.Update(root, 0, {}).players.size();
+		}
+	);
+
+	// New converter every tick, like building each state from scratch
+	double scratchNS = fnMeasureNSPerTick(
+		[&](const rlbot::flat::GameTickPacket* root) {
+			RLBotStateConverter scratchConverter = {};
+			checksum += scratchConverter.Update(root, 0, {}).players.size();
+		}
+	);
+
+	RG_LOG("\tConverted " << numTicks << " ticks (checksum " << checksum << ")");
+	RG_LOG("\tPersistent: " << persistentNS << "ns/tick");
+	RG_LOG("\tFrom scratch: " << scratchNS << "ns/tick");
+}
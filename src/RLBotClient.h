@@ -4,6 +4,8 @@
 #include <RLGymCPP/ObsBuilders/ObsBuilder.h>
 #include <RLGymCPP/ActionParsers/ActionParser.h>
 #include <GigaLearnCPP/Util/InferUnit.h>
+#include <GigaLearnCPP/Util/InferBroker.h>
+#include "RLBotStateConverter.h"
 
 struct RLBotParams {
 	// Set this to the same port used in rlbot/port.cfg
@@ -13,6 +15,47 @@ struct RLBotParams {
 	int actionDelay; // Your action delay
 
 	GGL::InferUnit* inferUnit = NULL;
+
+	// All bots in this process share one InferBroker, so their inference is batched together (see InferBroker.h)
+	float inferBatchWindow = 0.002f; // How long to wait for the other bots' requests before running a batch, in seconds
+
+	// How long the tick thread may wait on an action that is due this tick, in seconds
+	// At 0 the tick thread never waits, and a late action is applied on the first tick after it's done
+	// With an action delay of 0 the action is due on the tick it was requested, so you'll want this above 0
+	float inferDeadline = 0;
+
+	// How often each bot logs its latency histograms and missed deadlines, in seconds (0 to disable)
+	float latencyLogInterval = 60;
+
+	// If set, each bot records the packets it receives to "<packetRecordPath>.<bot index>", for RLBotClient::BenchmarkStateConversion()
+	std::string packetRecordPath = {};
+};
+
+// Histogram of latencies, with power-of-two buckets from under 125us up to 16ms and over
+// Not thread-safe, each bot only uses its own from its tick thread
+struct RLBotLatencyHistogram {
+	constexpr static int NUM_BUCKETS = 9;
+	constexpr static float FIRST_BUCKET_MAX = 125e-6f;
+
+	uint64_t counts[NUM_BUCKETS] = {};
+	uint64_t total = 0;
+	double sum = 0;
+	float max = 0;
+
+	void Add(float seconds);
+
+	float GetMean() const {
+		return total ? (float)(sum / total) : 0;
+	}
+
+	// Upper bound of the bucket containing this fraction of samples (max for the last bucket)
+	float GetPercentile(float frac) const;
+
+	std::string ToString() const;
+
+	void Reset() {
+		*this = {};
+	}
 };
 
 class RLBotBot : public rlbot::Bot {
@@ -27,16 +70,36 @@ public:
 		controls = {};
 
 	// Persistent info
-	bool updateAction = true;
+	RLBotStateConverter stateConverter;
+	std::ofstream packetRecordFile;
 	float prevTime = 0;
-	int ticks = -1;
+	int ticks = -1; // Ticks since the current step's obs, -1 before the first packet
+
+	// Inference runs on the shared InferBroker's thread, the tick thread just picks up the result when it's done
+	// Same as in training, the previous action is kept for actionDelay ticks after the obs, then the new action is applied
+	int brokerClientID;
+	uint64_t pendingRequest = 0; // Sequence of the request in flight, 0 if none
+	std::chrono::steady_clock::time_point requestTime;
+	bool actionReady = false; // The current step's action is done but not yet applied
+	bool missedDeadline = false; // The current step's action wasn't done when it was due
+
+	// Time from request to the action being picked up, and time spent in GetOutput()
+	RLBotLatencyHistogram inferLatency, tickLatency;
+	uint64_t numMissedDeadlines = 0;
+	std::chrono::steady_clock::time_point lastLatencyLogTime;
 
 	RLBotBot(int _index, int _team, std::string _name, const RLBotParams& params);
 	~RLBotBot();
 
 	rlbot::Controller GetOutput(rlbot::GameTickPacket gameTickPacket) override;
+
+private:
+	void _UpdateAction();
 };
 
 namespace RLBotClient {
 	void Run(const RLBotParams& params);
+
+	// Replays packets recorded with RLBotParams::packetRecordPath through the state converter, and logs the time per tick
+	void BenchmarkStateConversion(const std::string& packetsPath);
 }
\ No newline at end of file
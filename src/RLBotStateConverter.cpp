@@ -0,0 +1,170 @@
+#include "RLBotStateConverter.h"
+
+using namespace RLGC;
+
+static inline Vec ToVec(const rlbot::flat::Vector3* rlbotVec) {
+	return Vec(rlbotVec->x(), rlbotVec->y(), rlbotVec->z());
+}
+
+static inline void UpdatePhys(PhysState& obj, const rlbot::flat::Physics* phys) {
+	obj.pos = ToVec(phys->location());
+
+	auto rot = phys->rotation();
+	obj.rotMat = Angle(rot->yaw(), rot->pitch(), rot->roll()).ToRotMat();
+
+	obj.vel = ToVec(phys->velocity());
+	obj.angVel = ToVec(phys->angularVelocity());
+}
+
+GameState& RLBotStateConverter::Update(const rlbot::flat::GameTickPacket* packet, int localIndex, const Action& localPrevAction) {
+	GameState* prev = &states[curStateIdx];
+	curStateIdx = 1 - curStateIdx;
+	GameState& gs = states[curStateIdx];
+
+	auto gameInfo = packet->gameInfo();
+	auto packetPlayers = packet->players();
+
+	int numPlayers = packetPlayers->size();
+	if (numPlayers > CommonValues::MAX_PLAYERS) {
+		RG_LOG("RLBotStateConverter::Update(): Too many players in packet (" << numPlayers << "/" << CommonValues::MAX_PLAYERS << "), ignoring the rest");
+		numPlayers = CommonValues::MAX_PLAYERS;
+	}
+
+	// A player joined or left, so the previous state doesn't line up with this one
+	if (prev->IsEmpty() || prev->players.size() != numPlayers)
+		prev = NULL;
+
+	gs.prev = prev;
+	if (prev)
+		prev->prev = NULL;
+
+	float curTime = gameInfo->secondsElapsed();
+	uint64_t tickCount = (uint64_t)RS_MAX(gameInfo->frameNum(), 0);
+	int tickSkip = prev ? (int)RS_MAX((int64_t)tickCount - (int64_t)prev->lastTickCount, 0) : 0;
+	gs.deltaTime = tickSkip * (1.0f / 120.0f);
+	gs.lastTickCount = tickCount;
+	gs.lastTouchCarID = prev ? prev->lastTouchCarID : -1;
+	gs.lastArena = NULL;
+	gs._featuresValid = false;
+
+	UpdatePhys(gs.ball, packet->ball()->physics());
+
+	// Only touches since the last update count for this step
+	int touchPlayerIdx = -1;
+	bool touchOnTick = false;
+	auto touch = packet->ball()->latestTouch();
+	if (prev && touch && touch->gameSeconds() > prevTime) {
+		touchPlayerIdx = touch->playerIndex();
+		touchOnTick = (curTime - touch->gameSeconds()) < (1.5f / 120.0f);
+	}
+
+	gs.players.resize(numPlayers);
+	for (int i = 0; i < numPlayers; i++) {
+		auto playerInfo = packetPlayers->Get(i);
+		Player& player = gs.players[i];
+		Player* prevPlayer = prev ? &prev->players[i] : NULL;
+
+		player.prev = prevPlayer;
+		player.index = i;
+		player.carId = playerInfo->spawnId();
+		player.team = (Team)playerInfo->team();
+
+		UpdatePhys(player, playerInfo->physics());
+		player.boost = playerInfo->boost();
+		player.isOnGround = playerInfo->hasWheelContact();
+		player.hasJumped = playerInfo->jumped();
+		player.hasDoubleJumped = playerInfo->doubleJumped();
+		player.isDemoed = playerInfo->isDemolished();
+		player.isSupersonic = playerInfo->isSupersonic();
+
+		// Timers RLBot doesn't send, continued from the previous state
+		player.airTime = (prevPlayer && !player.isOnGround) ? (prevPlayer->airTime + gs.deltaTime) : 0;
+		player.supersonicTime = (prevPlayer && player.isSupersonic) ? (prevPlayer->supersonicTime + gs.deltaTime) : 0;
+
+		player.ballTouchedStep = (i == touchPlayerIdx);
+		player.ballTouchedTick = player.ballTouchedStep && touchOnTick;
+		if (player.ballTouchedStep)
+			gs.lastTouchCarID = player.carId;
+
+		player.prevAction = (i == localIndex) ? localPrevAction : Action();
+
+		// Events are detected from the score stats going up since the last update
+		ScoreStats scores = {};
+		if (auto scoreInfo = playerInfo->scoreInfo())
+			scores = { scoreInfo->goals(), scoreInfo->assists(), scoreInfo->saves(), scoreInfo->shots(), scoreInfo->demolitions() };
+
+		player.eventState = {};
+		if (prevPlayer) {
+			const ScoreStats& prevScore = prevScores[i];
+			player.eventState.goal = scores.goals > prevScore.goals;
+			player.eventState.assist = scores.assists > prevScore.assists;
+			player.eventState.save = scores.saves > prevScore.saves;
+			player.eventState.shot = scores.shots > prevScore.shots;
+			player.eventState.demo = scores.demolitions > prevScore.demolitions;
+			player.eventState.demoed = player.isDemoed && !prevPlayer->isDemoed;
+		}
+		prevScores[i] = scores;
+	}
+
+	auto boostPadStates = packet->boostPadStates();
+	if (!boostPadStates || boostPadStates->size() != CommonValues::BOOST_LOCATIONS_AMOUNT) {
+		if (rand() % 20 == 0) { // Don't spam-log as that will lag the bot
+			RG_LOG(
+				"RLBotStateConverter::Update(): Bad boost pad amount, expected " << CommonValues::BOOST_LOCATIONS_AMOUNT <<
+				" but got " << (boostPadStates ? boostPadStates->size() : 0)
+			);
+		}
+
+		// Just set all boost pads to on
+		gs.boostPads.fill(true);
+		gs.boostPadsInv.fill(true);
+		gs.boostPadTimers.fill(0);
+		gs.boostPadTimersInv.fill(0);
+	} else {
+		for (int i = 0; i < CommonValues::BOOST_LOCATIONS_AMOUNT; i++) {
+			auto padState = boostPadStates->Get(i);
+			int invI = CommonValues::BOOST_LOCATIONS_AMOUNT - i - 1;
+
+			gs.boostPads[i] = gs.boostPadsInv[invI] = padState->isActive();
+			gs.boostPadTimers[i] = gs.boostPadTimersInv[invI] = padState->timer();
+		}
+	}
+
+	// Same as the soccar check in Arena::IsBallScored()
+	gs.goalScored = abs(gs.ball.pos.y) > (CommonValues::BACK_WALL_Y + CommonValues::BALL_RADIUS);
+
+	prevTime = curTime;
+	return gs;
+}
+
+void RLBotStateConverter::Reset() {
+	for (auto& state : states)
+		state.MakeEmpty();
+	prevTime = 0;
+}
+
+void RLBotStateConverter::WritePacket(std::ofstream& out, const void* data, uint32_t size) {
+	out.write((const char*)&size, sizeof(size));
+	out.write((const char*)data, size);
+}
+
+std::vector<std::vector<uint8_t>> RLBotStateConverter::ReadPackets(const std::string& path) {
+	std::ifstream in(path, std::ios::binary);
+	if (!in.good())
+		RG_ERR_CLOSE("RLBotStateConverter::ReadPackets(): Failed to open \"" << path << "\"");
+
+	std::vector<std::vector<uint8_t>> packets = {};
+	uint32_t size;
+	while (in.read((char*)&size, sizeof(size))) {
+		std::vector<uint8_t> packet(size);
+		if (!in.read((char*)packet.data(), size))
+			break; // Cut off at the end, e.g. the bot was closed mid-write
+
+		flatbuffers::Verifier verifier(packet.data(), packet.size());
+		if (!verifier.VerifyBuffer<rlbot::flat::GameTickPacket>(nullptr))
+			RG_ERR_CLOSE("RLBotStateConverter::ReadPackets(): Packet " << packets.size() << " of \"" << path << "\" is invalid");
+
+		packets.push_back(std::move(packet));
+	}
+	return packets;
+}
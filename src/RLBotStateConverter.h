@@ -0,0 +1,40 @@
+#pragma once
+
+#include <rlbot/bot.h>
+#include <RLGymCPP/Gamestates/GameState.h>
+#include <fstream>
+
+// Keeps a GameState up to date from RLBot packets, filled the same way GameState::UpdateFromArena() fills it in training
+// The current and previous states are double-buffered, so each update overwrites the older one in place and nothing is allocated
+// Fields that depend on the previous state (prev, deltaTime, ball touches, events, air/supersonic time) come from the last update,
+//	so like in training, call Update() once per step
+class RLBotStateConverter {
+public:
+	RLGC::GameState states[2] = {};
+	int curStateIdx = 0;
+
+	RLBotStateConverter() = default;
+	RG_NO_COPY(RLBotStateConverter);
+
+	RLGC::GameState& GetState() {
+		return states[curStateIdx];
+	}
+
+	// RLBot only tells us our own controls, so every other player's prevAction is left empty
+	RLGC::GameState& Update(const rlbot::flat::GameTickPacket* packet, int localIndex, const RLGC::Action& localPrevAction);
+
+	// Forgets the previous state, the next update will have no prev (like the first step of an episode)
+	void Reset();
+
+	// Packets can be recorded to a file (each one as its uint32 size followed by its bytes) and replayed with RLBotClient::BenchmarkStateConversion()
+	static void WritePacket(std::ofstream& out, const void* data, uint32_t size);
+	static std::vector<std::vector<uint8_t>> ReadPackets(const std::string& path);
+
+private:
+	// Score stats from the last update, events are detected from their increments
+	struct ScoreStats {
+		int goals, assists, saves, shots, demolitions;
+	};
+	ScoreStats prevScores[RLGC::CommonValues::MAX_PLAYERS] = {};
+	float prevTime = 0;
+};